@@ -0,0 +1,324 @@
+/**
+ * @file
+ * Declares the arena for AST nodes.
+ */
+#pragma once
+
+#include <boost/spirit/home/x3/support/ast/variant.hpp>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace puppet { namespace compiler { namespace ast {
+
+    /**
+     * Represents an arena that stores the nodes of a syntax tree in contiguous blocks of memory.
+     * Memory is released only when the arena is destroyed, so nodes allocated from the arena must be destroyed before it.
+     */
+    struct arena
+    {
+        /**
+         * Constructs an empty arena.
+         */
+        arena() = default;
+
+        /**
+         * Deleted copy constructor.
+         */
+        arena(arena const&) = delete;
+
+        /**
+         * Deleted copy assignment operator.
+         * @return Returns this arena.
+         */
+        arena& operator=(arena const&) = delete;
+
+        /**
+         * Allocates memory from the arena.
+         * @param size The number of bytes to allocate.
+         * @param alignment The alignment of the memory to allocate.
+         * @return Returns a pointer to the allocated memory.
+         */
+        void* allocate(size_t size, size_t alignment);
+
+        /**
+         * Gets the number of bytes allocated from the arena.
+         * @return Returns the number of bytes allocated from the arena.
+         */
+        size_t size() const;
+
+        /**
+         * Gets the arena that nodes are allocated from on the calling thread.
+         * @return Returns the current arena or nullptr if nodes are allocated from the heap.
+         */
+        static arena* current();
+
+     private:
+        friend struct scoped_arena;
+
+        std::vector<std::unique_ptr<char[]>> _blocks;
+        char* _next = nullptr;
+        char* _end = nullptr;
+        size_t _size = 0;
+    };
+
+    /**
+     * Helper for setting the current arena of the calling thread.
+     */
+    struct scoped_arena
+    {
+        /**
+         * Constructs a scoped arena.
+         * @param arena The arena to allocate nodes from or nullptr to allocate nodes from the heap.
+         */
+        explicit scoped_arena(ast::arena* arena);
+
+        /**
+         * Destructs the scoped arena and restores the previous arena.
+         */
+        ~scoped_arena();
+
+        /**
+         * Deleted copy constructor.
+         */
+        scoped_arena(scoped_arena const&) = delete;
+
+        /**
+         * Deleted copy assignment operator.
+         * @return Returns this scoped arena.
+         */
+        scoped_arena& operator=(scoped_arena const&) = delete;
+
+     private:
+        ast::arena* _previous;
+    };
+
+    /**
+     * Represents an AST node that is stored apart from its parent so that recursive AST types can be declared.
+     * Nodes are allocated from the calling thread's current arena, falling back to the heap if there is no current arena.
+     * This otherwise behaves like boost::spirit::x3::forward_ast.
+     * @tparam T The type of AST node.
+     */
+    template <typename T>
+    struct forward_node
+    {
+        /**
+         * The type of AST node.
+         */
+        using type = T;
+
+        /**
+         * Constructs a default node.
+         */
+        forward_node() :
+            _arena(arena::current()),
+            _node(create())
+        {
+        }
+
+        /**
+         * Copy constructor for forward node.
+         * The copy is allocated from the current arena rather than the arena of the node being copied.
+         * @param other The node to copy.
+         */
+        forward_node(forward_node const& other) :
+            _arena(arena::current()),
+            _node(create(other.get()))
+        {
+        }
+
+        /**
+         * Move constructor for forward node.
+         * @param other The node to move.
+         */
+        forward_node(forward_node&& other) noexcept :
+            _arena(other._arena),
+            _node(other._node)
+        {
+            other._node = nullptr;
+        }
+
+        /**
+         * Constructs a node by copying the given AST node.
+         * @param node The AST node to copy.
+         */
+        forward_node(T const& node) :
+            _arena(arena::current()),
+            _node(create(node))
+        {
+        }
+
+        /**
+         * Constructs a node by moving the given AST node.
+         * @param node The AST node to move.
+         */
+        forward_node(T&& node) :
+            _arena(arena::current()),
+            _node(create(std::move(node)))
+        {
+        }
+
+        /**
+         * Destructs the node.
+         */
+        ~forward_node()
+        {
+            if (!_node) {
+                return;
+            }
+            if (_arena) {
+                _node->~T();
+            } else {
+                delete _node;
+            }
+        }
+
+        /**
+         * Copy assignment operator for forward node.
+         * @param other The node to copy.
+         * @return Returns this node.
+         */
+        forward_node& operator=(forward_node const& other)
+        {
+            get() = other.get();
+            return *this;
+        }
+
+        /**
+         * Move assignment operator for forward node.
+         * @param other The node to move.
+         * @return Returns this node.
+         */
+        forward_node& operator=(forward_node&& other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        /**
+         * Assigns the given AST node by copying it.
+         * @param node The AST node to copy.
+         * @return Returns this node.
+         */
+        forward_node& operator=(T const& node)
+        {
+            get() = node;
+            return *this;
+        }
+
+        /**
+         * Assigns the given AST node by moving it.
+         * @param node The AST node to move.
+         * @return Returns this node.
+         */
+        forward_node& operator=(T&& node)
+        {
+            get() = std::move(node);
+            return *this;
+        }
+
+        /**
+         * Swaps this node with another.
+         * @param other The node to swap with.
+         */
+        void swap(forward_node& other) noexcept
+        {
+            std::swap(_arena, other._arena);
+            std::swap(_node, other._node);
+        }
+
+        /**
+         * Gets the AST node.
+         * @return Returns the AST node.
+         */
+        T& get() noexcept
+        {
+            return *_node;
+        }
+
+        /**
+         * Gets the AST node.
+         * @return Returns the AST node.
+         */
+        T const& get() const noexcept
+        {
+            return *_node;
+        }
+
+        /**
+         * Gets a pointer to the AST node.
+         * @return Returns a pointer to the AST node.
+         */
+        T* get_pointer() noexcept
+        {
+            return _node;
+        }
+
+        /**
+         * Gets a pointer to the AST node.
+         * @return Returns a pointer to the AST node.
+         */
+        T const* get_pointer() const noexcept
+        {
+            return _node;
+        }
+
+        /**
+         * Converts the node to the AST node.
+         * @return Returns the AST node.
+         */
+        operator T const&() const noexcept
+        {
+            return get();
+        }
+
+        /**
+         * Converts the node to the AST node.
+         * @return Returns the AST node.
+         */
+        operator T&() noexcept
+        {
+            return get();
+        }
+
+     private:
+        template <typename... Args>
+        T* create(Args&&... args) const
+        {
+            if (_arena) {
+                return new (_arena->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            }
+            return new T(std::forward<Args>(args)...);
+        }
+
+        ast::arena* _arena;
+        T* _node;
+    };
+
+    /**
+     * Swaps two forward nodes.
+     * @tparam T The type of AST node.
+     * @param left The left node to swap.
+     * @param right The right node to swap.
+     */
+    template <typename T>
+    void swap(forward_node<T>& left, forward_node<T>& right) noexcept
+    {
+        left.swap(right);
+    }
+
+}}}  // namespace puppet::compiler::ast
+
+namespace boost { namespace spirit { namespace x3 { namespace detail {
+
+    /**
+     * Specialization of remove_forward so that X3 variants see through forward nodes as they do for forward_ast.
+     * @tparam T The type of AST node.
+     */
+    template <typename T>
+    struct remove_forward<puppet::compiler::ast::forward_node<T>> : mpl::identity<T>
+    {
+    };
+
+}}}}  // namespace boost::spirit::x3::detail
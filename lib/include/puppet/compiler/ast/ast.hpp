@@ -5,19 +5,46 @@
 #pragma once
 
 #include "../lexer/tokens.hpp"
+#include "../symbol.hpp"
+#include "arena.hpp"
 #include <boost/optional.hpp>
 #include <boost/spirit/home/x3/support/ast/variant.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <boost/utility/string_ref.hpp>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <limits>
+#include <unordered_map>
+#include <cstdint>
+
+namespace puppet { namespace runtime { namespace values {
+
+    // Forward declaration of regex.
+    struct regex;
+
+}}}  // namespace puppet::runtime::values
+
+namespace puppet { namespace utility { namespace filesystem {
+
+    // Forward declaration of mapped_file.
+    struct mapped_file;
+
+}}}  // namespace puppet::utility::filesystem
 
 namespace puppet { namespace compiler {
 
     // Forward declaration of module.
     struct module;
 
+    namespace lexer {
+
+        // Forward declaration of line_info.
+        struct line_info;
+
+    }  // namespace puppet::compiler::lexer
+
 }}
 
 namespace puppet { namespace compiler { namespace ast {
@@ -242,6 +269,12 @@ namespace puppet { namespace compiler { namespace ast {
          * Stores the value of the literal regex.
          */
         std::string value;
+
+        /**
+         * Stores the compiled regex for the literal.
+         * This is populated on first evaluation and must be accessed with std::atomic_load and std::atomic_store.
+         */
+        mutable std::shared_ptr<runtime::values::regex const> compiled;
     };
 
     /**
@@ -268,6 +301,72 @@ namespace puppet { namespace compiler { namespace ast {
      */
     bool operator!=(regex const& left, regex const& right);
 
+    /**
+     * Represents the local variables of a class, defined type, node, function, or lambda body.
+     * Each local variable is assigned a slot; scopes created for the body store their local variables in a fixed-size array of slots.
+     */
+    struct frame
+    {
+        /**
+         * The value returned when a variable has no slot in the frame.
+         */
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        /**
+         * Adds a local variable to the frame.
+         * @param name The name of the local variable.
+         * @return Returns the slot of the local variable.
+         */
+        size_t add(std::string const& name);
+
+        /**
+         * Finds the slot of a local variable.
+         * @param name The name of the local variable.
+         * @return Returns the slot of the local variable or npos if the variable is not local to the frame.
+         */
+        size_t find(std::string const& name) const;
+
+        /**
+         * Gets the number of slots in the frame.
+         * @return Returns the number of slots in the frame.
+         */
+        size_t size() const;
+
+     private:
+        std::unordered_map<std::string, size_t> _slots;
+    };
+
+    /**
+     * Represents the resolution of a variable reference.
+     */
+    struct variable_resolution
+    {
+        /**
+         * Stores whether or not the variable name is namespace-qualified.
+         */
+        bool qualified = false;
+
+        /**
+         * Stores the namespace of a qualified variable, without any leading '::'.
+         */
+        std::string scope;
+
+        /**
+         * Stores the interned name of the variable without its namespace.
+         */
+        symbol name;
+
+        /**
+         * Stores the frame a local variable was resolved to or nullptr if the variable is not local to an enclosing frame.
+         */
+        ast::frame const* frame = nullptr;
+
+        /**
+         * Stores the slot of a local variable within its frame.
+         */
+        size_t slot = 0;
+    };
+
     /**
      * Represents a variable.
      */
@@ -277,6 +376,12 @@ namespace puppet { namespace compiler { namespace ast {
          * Stores the name of the variable.
          */
         std::string name;
+
+        /**
+         * Stores the resolution of the variable.
+         * This is populated by the resolution visitor before the syntax tree is evaluated; unresolved variables are looked up by name.
+         */
+        mutable boost::optional<variable_resolution> resolution;
     };
 
     /**
@@ -437,19 +542,19 @@ namespace puppet { namespace compiler { namespace ast {
         name,
         bare_word,
         type,
-        boost::spirit::x3::forward_ast<interpolated_string>,
-        boost::spirit::x3::forward_ast<array>,
-        boost::spirit::x3::forward_ast<hash>,
-        boost::spirit::x3::forward_ast<case_expression>,
-        boost::spirit::x3::forward_ast<if_expression>,
-        boost::spirit::x3::forward_ast<unless_expression>,
-        boost::spirit::x3::forward_ast<function_call_expression>,
-        boost::spirit::x3::forward_ast<new_expression>,
-        boost::spirit::x3::forward_ast<epp_render_expression>,
-        boost::spirit::x3::forward_ast<epp_render_block>,
-        boost::spirit::x3::forward_ast<epp_render_string>,
-        boost::spirit::x3::forward_ast<unary_expression>,
-        boost::spirit::x3::forward_ast<nested_expression>
+        forward_node<interpolated_string>,
+        forward_node<array>,
+        forward_node<hash>,
+        forward_node<case_expression>,
+        forward_node<if_expression>,
+        forward_node<unless_expression>,
+        forward_node<function_call_expression>,
+        forward_node<new_expression>,
+        forward_node<epp_render_expression>,
+        forward_node<epp_render_block>,
+        forward_node<epp_render_string>,
+        forward_node<unary_expression>,
+        forward_node<nested_expression>
         >
     {
         // Use the base's construction and assignment semantics
@@ -519,9 +624,9 @@ namespace puppet { namespace compiler { namespace ast {
      * Represents a postfix operation.
      */
     struct postfix_operation : boost::spirit::x3::variant<
-        boost::spirit::x3::forward_ast<selector_expression>,
-        boost::spirit::x3::forward_ast<access_expression>,
-        boost::spirit::x3::forward_ast<method_call_expression>
+        forward_node<selector_expression>,
+        forward_node<access_expression>,
+        forward_node<method_call_expression>
         >
     {
         // Use the base's construction and assignment semantics
@@ -766,6 +871,48 @@ namespace puppet { namespace compiler { namespace ast {
      */
     std::ostream& operator<<(std::ostream& os, binary_operation const& operation);
 
+    /**
+     * Represents an instruction of a lowered expression.
+     * The binary operations of an expression are lowered into a flat sequence of instructions in evaluation order so that operator precedence is not climbed at runtime.
+     */
+    struct instruction
+    {
+        /**
+         * Represents the instruction's operation code.
+         */
+        enum class opcode : std::uint8_t
+        {
+            /**
+             * Evaluates an operand and pushes its value.
+             */
+            operand,
+            /**
+             * Short circuits a logical 'and' or 'or' operation by replacing the top value and jumping past the right-hand side.
+             */
+            short_circuit,
+            /**
+             * Pops the right-hand value and applies a binary operator to it and the left-hand value.
+             */
+            binary
+        };
+
+        /**
+         * Stores the operation code.
+         */
+        opcode code = opcode::operand;
+
+        /**
+         * Stores the index of the operand or operation.
+         * Operand 0 is the expression's first operand and operand N is the operand of operation N - 1.
+         */
+        std::uint32_t index = 0;
+
+        /**
+         * Stores the index of the instruction to jump to when short circuiting.
+         */
+        std::uint32_t target = 0;
+    };
+
     /**
      * Represents an expression.
      */
@@ -781,6 +928,12 @@ namespace puppet { namespace compiler { namespace ast {
          */
         std::vector<binary_operation> operations;
 
+        /**
+         * Stores the lowered instructions of the expression's binary operations.
+         * This is populated by the resolution visitor; if empty, the operations are evaluated by climbing operator precedence.
+         */
+        mutable std::vector<instruction> instructions;
+
         /**
          * Gets the context of the expression.
          * @return Returns the context of the expression.
@@ -920,17 +1073,17 @@ namespace puppet { namespace compiler { namespace ast {
      * Represents a Puppet statement.
      */
     struct statement : boost::spirit::x3::variant<
-        boost::spirit::x3::forward_ast<class_statement>,
-        boost::spirit::x3::forward_ast<defined_type_statement>,
-        boost::spirit::x3::forward_ast<node_statement>,
-        boost::spirit::x3::forward_ast<function_statement>,
-        boost::spirit::x3::forward_ast<produces_statement>,
-        boost::spirit::x3::forward_ast<consumes_statement>,
-        boost::spirit::x3::forward_ast<application_statement>,
-        boost::spirit::x3::forward_ast<site_statement>,
-        boost::spirit::x3::forward_ast<type_alias_statement>,
-        boost::spirit::x3::forward_ast<function_call_statement>,
-        boost::spirit::x3::forward_ast<relationship_statement>,
+        forward_node<class_statement>,
+        forward_node<defined_type_statement>,
+        forward_node<node_statement>,
+        forward_node<function_statement>,
+        forward_node<produces_statement>,
+        forward_node<consumes_statement>,
+        forward_node<application_statement>,
+        forward_node<site_statement>,
+        forward_node<type_alias_statement>,
+        forward_node<function_call_statement>,
+        forward_node<relationship_statement>,
         break_statement,
         next_statement,
         return_statement
@@ -1037,7 +1190,7 @@ namespace puppet { namespace compiler { namespace ast {
     struct interpolated_string_part : boost::spirit::x3::variant<
         literal_string_text,
         variable,
-        boost::spirit::x3::forward_ast<expression>
+        forward_node<expression>
     >
     {
         // Use the base's construction and assignment semantics
@@ -1439,6 +1592,19 @@ namespace puppet { namespace compiler { namespace ast {
          * Stores the body.
          */
         std::vector<statement> body;
+
+        /**
+         * Stores the frame of local variables for the body.
+         * This is populated by the resolution visitor.
+         */
+        mutable std::shared_ptr<ast::frame const> frame;
+
+        /**
+         * Stores whether or not the lambda is free of side effects.
+         * A pure lambda contains no calls, resource expressions, relationships, return statements, or qualified variable references, so its invocations may be interleaved with other pure lambdas.
+         * This is populated by the resolution visitor.
+         */
+        mutable bool pure = false;
     };
 
     /**
@@ -1781,6 +1947,12 @@ namespace puppet { namespace compiler { namespace ast {
          * Stores the body.
          */
         std::vector<statement> body;
+
+        /**
+         * Stores the frame of local variables for the body.
+         * This is populated by the resolution visitor.
+         */
+        mutable std::shared_ptr<ast::frame const> frame;
     };
 
     /**
@@ -1810,6 +1982,12 @@ namespace puppet { namespace compiler { namespace ast {
          * Stores the body.
          */
         std::vector<statement> body;
+
+        /**
+         * Stores the frame of local variables for the body.
+         * This is populated by the resolution visitor.
+         */
+        mutable std::shared_ptr<ast::frame const> frame;
     };
 
     /**
@@ -1919,6 +2097,12 @@ namespace puppet { namespace compiler { namespace ast {
          * Stores the body.
          */
         std::vector<statement> body;
+
+        /**
+         * Stores the frame of local variables for the body.
+         * This is populated by the resolution visitor.
+         */
+        mutable std::shared_ptr<ast::frame const> frame;
     };
 
     /**
@@ -1953,6 +2137,12 @@ namespace puppet { namespace compiler { namespace ast {
          * Stores the function's body.
          */
         std::vector<statement> body;
+
+        /**
+         * Stores the frame of local variables for the body.
+         * This is populated by the resolution visitor.
+         */
+        mutable std::shared_ptr<ast::frame const> frame;
     };
 
     /**
@@ -2406,7 +2596,7 @@ namespace puppet { namespace compiler { namespace ast {
      */
     struct basic_query_expression : boost::spirit::x3::variant<
         attribute_query,
-        boost::spirit::x3::forward_ast<nested_query_expression>
+        forward_node<nested_query_expression>
         >
     {
         // Use the base's construction and assignment semantics
@@ -2851,7 +3041,11 @@ namespace puppet { namespace compiler { namespace ast {
         /**
          * YAML format.
          */
-        yaml
+        yaml,
+        /**
+         * XPP (binary precompiled AST) format.
+         */
+        xpp
     };
 
     /**
@@ -2870,6 +3064,17 @@ namespace puppet { namespace compiler { namespace ast {
          */
         std::vector<statement> statements;
 
+        /**
+         * Stores the frame of local variables for a parameterized EPP template.
+         * This is populated by the resolution visitor.
+         */
+        mutable std::shared_ptr<ast::frame const> frame;
+
+        /**
+         * Destructs the syntax tree.
+         */
+        ~syntax_tree();
+
         /**
          * Gets the path to the file represented by the syntax tree.
          * @return Returns the path to the file represented by the syntax tree.
@@ -2883,23 +3088,52 @@ namespace puppet { namespace compiler { namespace ast {
         std::shared_ptr<std::string> const& shared_path() const;
 
         /**
-         * Gets the source code represented by the syntax tree.
-         * @return Returns the source code represented by the syntax tree.
+         * Gets the source code represented by the syntax tree when it was parsed from a string.
+         * @return Returns the source code represented by the syntax tree or an empty string if parsed from a file.
          */
         std::string const& source() const;
 
         /**
          * Sets the source code represented by the syntax tree.
+         * An index of line offsets is built so that line information can be found without rescanning the source.
          * @param source The source code represented by the syntax tree.
          */
         void source(std::string source);
 
+        /**
+         * Sets the source code represented by the syntax tree to the contents of a mapped file.
+         * The tree keeps the mapping so that line information can be found without copying or reading the file again.
+         * @param mapping The mapped file containing the source code.
+         */
+        void source(std::shared_ptr<utility::filesystem::mapped_file const> mapping);
+
+        /**
+         * Gets the text the syntax tree was parsed from.
+         * @return Returns the text the syntax tree was parsed from or an empty string if the source is not available.
+         */
+        boost::string_ref text() const;
+
+        /**
+         * Gets the line information for a position inside the source code represented by the syntax tree.
+         * @param position The position (byte offset) inside the source.
+         * @param length The length, in bytes, of the source being highlighted.
+         * @return Returns the line information or empty line information if the source is not available.
+         */
+        lexer::line_info line_info(size_t position, size_t length) const;
+
         /**
          * Gets the module that owns this AST.
          * @return Returns the module that owns this AST.
          */
         compiler::module const* module() const;
 
+        /**
+         * Gets the arena that stores the syntax tree's nodes.
+         * Nodes are allocated from the arena while the tree is being parsed or read.
+         * @return Returns the arena that stores the syntax tree's nodes.
+         */
+        ast::arena& arena();
+
         /**
          * Writes the syntax tree to a given stream.
          * @param format The format to serialize the syntax tree as.
@@ -2908,6 +3142,17 @@ namespace puppet { namespace compiler { namespace ast {
          */
         void write(ast::format format, std::ostream& stream, bool include_path = true) const;
 
+        /**
+         * Reads a syntax tree from a given stream.
+         * Only the XPP format is supported for reading; the data is accepted only if it was produced from the current source of the given path.
+         * @param format The format of the serialized syntax tree.
+         * @param stream The stream to read the syntax tree from.
+         * @param path The path to the source file represented by the syntax tree.
+         * @param module The module that owns the AST.
+         * @return Returns the syntax tree or nullptr if the data is invalid or out-of-date with respect to the source file.
+         */
+        static std::shared_ptr<syntax_tree> read(ast::format format, std::istream& stream, std::string path, compiler::module const* module = nullptr);
+
         /**
          * Validates the AST.
          * Throws parse exceptions if validation fails.
@@ -2916,6 +3161,12 @@ namespace puppet { namespace compiler { namespace ast {
          */
         void validate(bool epp = false, bool allow_catalog_statements = true) const;
 
+        /**
+         * Resolves the variables in the AST.
+         * Local variables of classes, defined types, nodes, functions, lambdas, and parameterized EPP templates are assigned frame slots.
+         */
+        void resolve() const;
+
         /**
          * Creates a syntax tree.
          * @param path The path to the file represented by the syntax tree.
@@ -2933,9 +3184,14 @@ namespace puppet { namespace compiler { namespace ast {
         syntax_tree(std::string path, compiler::module const* module);
 
      private:
+        void index();
+
         std::shared_ptr<std::string> _path;
         std::string _source;
+        std::shared_ptr<utility::filesystem::mapped_file const> _mapping;
+        std::vector<size_t> _lines;
         compiler::module const* _module;
+        ast::arena _arena;
     };
 
     /**
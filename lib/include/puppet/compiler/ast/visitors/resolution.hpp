@@ -0,0 +1,107 @@
+/**
+ * @file
+ * Declares the resolution visitor.
+ */
+#pragma once
+
+#include "../ast.hpp"
+#include <boost/variant.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace puppet { namespace compiler { namespace ast { namespace visitors {
+
+    /**
+     * A visitor for resolving variables in an AST.
+     * Namespace-qualified variable names are split once; local variables of classes, defined types, nodes, functions, lambdas,
+     * and parameterized EPP templates are assigned slots in the frame of the enclosing body.
+     * The binary operations of expressions are lowered into instructions.
+     * Lambdas without side effects are marked as pure.
+     */
+    struct resolution : boost::static_visitor<void>
+    {
+        /**
+         * Visits the given AST.
+         * @param tree The tree to visit.
+         */
+        void visit(syntax_tree const& tree);
+
+     private:
+        template<class> friend class ::boost::detail::variant::invoke_visitor;
+        void operator()(basic_expression const& expression);
+        void operator()(undef const&);
+        void operator()(defaulted const&);
+        void operator()(boolean const&);
+        void operator()(number const&);
+        void operator()(ast::string const&);
+        void operator()(ast::regex const&);
+        void operator()(variable const& expression);
+        void operator()(name const&);
+        void operator()(bare_word const&);
+        void operator()(type const&);
+        void operator()(interpolated_string const& expression);
+        void operator()(literal_string_text const&);
+        void operator()(ast::array const& expression);
+        void operator()(hash const& expression);
+        void operator()(case_expression const& expression);
+        void operator()(if_expression const& expression);
+        void operator()(unless_expression const& expression);
+        void operator()(function_call_expression const& expression);
+        void operator()(lambda_expression const& expression);
+        void operator()(new_expression const& expression);
+        void operator()(epp_render_expression const& expression);
+        void operator()(epp_render_block const& expression);
+        void operator()(epp_render_string const&);
+        void operator()(unary_expression const& expression);
+        void operator()(nested_expression const& expression);
+        void operator()(ast::expression const& expression);
+        void operator()(postfix_expression const& expression);
+        void operator()(selector_expression const& expression);
+        void operator()(access_expression const& expression);
+        void operator()(method_call_expression const& expression);
+        void operator()(ast::statement const& statement);
+        void operator()(class_statement const& statement);
+        void operator()(defined_type_statement const& statement);
+        void operator()(node_statement const& statement);
+        void operator()(function_statement const& statement);
+        void operator()(produces_statement const& statement);
+        void operator()(consumes_statement const& statement);
+        void operator()(application_statement const& statement);
+        void operator()(site_statement const& statement);
+        void operator()(type_alias_statement const&);
+        void operator()(function_call_statement const& statement);
+        void operator()(relationship_statement const& statement);
+        void operator()(relationship_expression const& expression);
+        void operator()(resource_declaration_expression const& expression);
+        void operator()(resource_override_expression const& expression);
+        void operator()(resource_defaults_expression const& expression);
+        void operator()(collector_expression const& expression);
+        void operator()(query_expression const& expression);
+        void operator()(nested_query_expression const& expression);
+        void operator()(basic_query_expression const& expression);
+        void operator()(attribute_query const& expression);
+        void operator()(break_statement const&);
+        void operator()(next_statement const& statement);
+        void operator()(return_statement const& statement);
+
+        std::shared_ptr<ast::frame const> resolve(std::vector<parameter> const* parameters, std::vector<statement> const& body, bool is_resource = false);
+        void visit_parameters(std::vector<parameter> const& parameters);
+        void visit_body(std::vector<statement> const& body);
+        void declare(postfix_expression const& operand);
+        void lower(ast::expression const& expression);
+        void lower(ast::expression const& expression, size_t operand, unsigned int min_precedence, size_t& index);
+        static instruction make_instruction(instruction::opcode code, size_t index);
+        void impure();
+
+        struct body_frame
+        {
+            std::shared_ptr<ast::frame> frame;
+            std::vector<variable const*> references;
+        };
+
+        std::vector<body_frame> _frames;
+        std::vector<bool> _lambdas;
+    };
+
+}}}}  // namespace puppet::compiler::ast::visitors
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "ast/ast.hpp"
+#include "symbol.hpp"
 #include "../runtime/values/value.hpp"
 #include <string>
 #include <memory>
@@ -31,6 +32,12 @@ namespace puppet { namespace compiler {
          */
         std::string const& name() const;
 
+        /**
+         * Gets the interned name of the attribute.
+         * @return Returns the interned name of the attribute.
+         */
+        compiler::symbol const& symbol() const;
+
         /**
          * Gets the AST context of the name.
          * @return Returns the AST context of the name.
@@ -75,7 +82,7 @@ namespace puppet { namespace compiler {
 
      private:
         std::shared_ptr<ast::syntax_tree> _tree;
-        std::string _name;
+        compiler::symbol _name;
         ast::context _name_context;
         std::shared_ptr<runtime::values::value> _value;
         ast::context _value_context;
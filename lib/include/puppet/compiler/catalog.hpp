@@ -5,11 +5,14 @@
 #pragma once
 
 #include "resource.hpp"
+#include "resource_index.hpp"
 #include <boost/graph/adjacency_list.hpp>
 #include <string>
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <tuple>
 #include <functional>
 #include <deque>
 
@@ -135,6 +138,19 @@ namespace puppet { namespace compiler {
          */
         size_t size() const;
 
+        /**
+         * Gets the catalog's resource index.
+         * @return Returns the catalog's resource index.
+         */
+        resource_index& index();
+
+        /**
+         * Gets the catalog's resource index, indexing the given resource type if it has not yet been indexed.
+         * @param type The resource type name to index.
+         * @return Returns the catalog's resource index.
+         */
+        resource_index& index(std::string const& type);
+
         /**
          * Enumerates the resources in the catalog.
          * @param callback The callback to call for each resource.
@@ -182,8 +198,17 @@ namespace puppet { namespace compiler {
         /**
          * Writes the catalog as JSON.
          * @param out The output stream to write the catalog to.
+         * @param pretty True to pretty print the JSON or false to write the catalog on a single line.
          */
-        void write(std::ostream& out) const;
+        void write(std::ostream& out, bool pretty = true) const;
+
+        /**
+         * Writes the catalog as JSON.
+         * The catalog is streamed to the buffer without building a document in memory.
+         * @param buffer The output buffer to write the catalog to.
+         * @param pretty True to pretty print the JSON or false to write the catalog on a single line.
+         */
+        void write(utility::output_buffer& buffer, bool pretty = true) const;
 
         /**
          * Writes the dependency graph as a DOT file.
@@ -191,16 +216,32 @@ namespace puppet { namespace compiler {
          */
         void write_graph(std::ostream& out);
 
+        /**
+         * The default maximum number of cycles reported by detect_cycles.
+         */
+        static constexpr size_t default_cycle_limit = 10;
+
         /**
          * Detects cycles within the graph.
          * Throws a resource_cycle_exception if cycles are detected.
+         * Cycles are only enumerated within strongly connected components of the graph, so an acyclic graph is checked in linear time.
+         * @param limit The maximum number of cycles to report; zero reports every cycle.
          */
-        void detect_cycles();
+        void detect_cycles(size_t limit = default_cycle_limit);
 
      private:
+        using edge_key = std::tuple<size_t, size_t, compiler::relationship>;
+
+        struct edge_key_hash
+        {
+            size_t operator()(edge_key const& key) const;
+        };
+
         catalog(catalog&) = delete;
         catalog& operator=(catalog&) = delete;
         void populate_relationships(resource const& source, std::string const& name, compiler::relationship relationship);
+        template <typename Writer>
+        void write_json(Writer& writer) const;
 
         std::string _node;
         std::string _environment;
@@ -210,6 +251,9 @@ namespace puppet { namespace compiler {
         std::unordered_map<runtime::types::resource, resource*, boost::hash<runtime::types::resource>> _resource_map;
         std::unordered_map<std::string, std::vector<resource*>> _resource_lists;
         boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS, resource*, relationship> _graph;
+        std::unordered_set<edge_key, edge_key_hash> _edges;
+        // The index is heap allocated because resources refer to it and the catalog is movable
+        std::unique_ptr<resource_index> _index;
     };
 
 }}  // namespace puppet::compiler
@@ -11,12 +11,18 @@
 #include "settings.hpp"
 #include "evaluation/dispatcher.hpp"
 #include "../logging/logger.hpp"
+#include "../utility/thread_pool.hpp"
 #include <string>
 #include <vector>
 #include <deque>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <future>
+#include <mutex>
+#include <ctime>
+#include <cstdint>
 
 namespace puppet { namespace compiler {
 
@@ -29,6 +35,7 @@ namespace puppet { namespace compiler {
 
     /**
      * Represents a compilation environment.
+     * Importing into the environment is safe from multiple threads; files are parsed on a bounded worker pool.
      */
     struct environment : finder
     {
@@ -121,6 +128,7 @@ namespace puppet { namespace compiler {
 
         /**
          * Imports a file into the environment's registry.
+         * Names that cannot be found are remembered and are not searched for again for the lifetime of the environment.
          * @param logger The logger to use to log messages.
          * @param type The type of file to find.
          * @param name The qualified name to translated into a file (e.g. 'foo::bar::baz' => '.../modules/foo/bar/baz').
@@ -137,10 +145,68 @@ namespace puppet { namespace compiler {
          */
         std::string resolve_path(logging::logger& logger, find_type type, std::string const& path) const;
 
+        /**
+         * Gets the validated syntax tree of an EPP template file.
+         * Templates are parsed once and cached until the file's modification time or size changes.
+         * @param logger The logger to use to log messages.
+         * @param path The resolved path to the template file.
+         * @return Returns the syntax tree of the template.
+         */
+        std::shared_ptr<ast::syntax_tree> parse_template(logging::logger& logger, std::string const& path);
+
+        /**
+         * Gets the validated syntax tree of an inline EPP template.
+         * Templates are parsed once and cached by source text; callers are expected to use the same path for a given source.
+         * The most recently parsed templates are kept, up to a limit on their number and total size.
+         * @param logger The logger to use to log messages.
+         * @param source The source of the template.
+         * @param path The path to use for the template in messages.
+         * @return Returns the syntax tree of the template.
+         */
+        std::shared_ptr<ast::syntax_tree> parse_inline_template(logging::logger& logger, std::string const& source, std::string const& path);
+
+        /**
+         * Reads the contents of a file.
+         * Contents are cached until the file's modification time or size changes.
+         * @param path The resolved path to the file.
+         * @return Returns the contents of the file or nullptr if the file could not be read.
+         */
+        std::shared_ptr<std::string const> read_file(std::string const& path);
+
      private:
         void add_modules(logging::logger& logger);
         void add_modules(logging::logger& logger, std::string const& directory);
+
+        struct parsed_file
+        {
+            std::shared_future<std::shared_ptr<ast::syntax_tree>> tree;
+            bool scanned = false;
+            std::exception_ptr error;
+        };
+
+        std::string find_import(logging::logger& logger, find_type type, std::string name, compiler::module const*& module) const;
         std::shared_ptr<ast::syntax_tree> import(logging::logger& logger, std::string const& path, compiler::module const* module = nullptr);
+        std::shared_ptr<parsed_file> queue_import(logging::logger& logger, std::string const& path, compiler::module const* module, bool defer);
+        std::shared_ptr<ast::syntax_tree> finish_import(parsed_file& file, std::string const& path);
+        std::shared_ptr<ast::syntax_tree> parse(logging::logger& logger, std::string const& path, compiler::module const* module) const;
+        std::shared_ptr<ast::syntax_tree> load_precompiled(logging::logger& logger, std::string const& path, compiler::module const* module) const;
+
+        struct file_stamp
+        {
+            std::time_t modified = 0;
+            std::uintmax_t size = 0;
+
+            bool operator==(file_stamp const& other) const;
+        };
+
+        template <typename T>
+        struct cached_file
+        {
+            file_stamp stamp;
+            T value;
+        };
+
+        static bool stamp(std::string const& path, file_stamp& result);
 
         std::string _name;
         compiler::settings _settings;
@@ -148,7 +214,19 @@ namespace puppet { namespace compiler {
         evaluation::dispatcher _dispatcher;
         std::deque<module> _modules;
         std::unordered_map<std::string, module*> _module_map;
-        std::unordered_map<std::string, std::shared_ptr<ast::syntax_tree>> _parsed;
+        std::mutex _parsed_mutex;
+        std::mutex _scan_mutex;
+        std::unordered_map<std::string, std::shared_ptr<parsed_file>> _parsed;
+        std::mutex _cache_mutex;
+        std::unordered_map<std::string, cached_file<std::shared_ptr<ast::syntax_tree>>> _templates;
+        std::unordered_map<std::string, std::shared_ptr<ast::syntax_tree>> _inline_templates;
+        std::deque<std::string const*> _inline_template_order;
+        std::size_t _inline_template_bytes = 0;
+        std::unordered_map<std::string, cached_file<std::shared_ptr<std::string const>>> _files;
+        std::mutex _misses_mutex;
+        std::unordered_map<find_type, std::unordered_set<std::string>> _misses;
+        // The pool is declared last so that pending parses complete before anything else is destroyed
+        utility::thread_pool _parse_pool;
     };
 
 }}  // puppet::compiler
@@ -6,7 +6,9 @@
 
 #include "../../ast/ast.hpp"
 #include "../../resource.hpp"
+#include "../../resource_index.hpp"
 #include <boost/optional.hpp>
+#include <memory>
 
 namespace puppet { namespace compiler { namespace evaluation {
 
@@ -19,6 +21,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
 
     /**
      * Represents a collection query evaluator.
+     * The query is compiled into a predicate the first time it is needed; the query's values are evaluated only once per query evaluator.
      */
     struct query_evaluator
     {
@@ -36,19 +39,34 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
          */
         bool evaluate(compiler::resource const& resource) const;
 
+        /**
+         * Finds the resources that may match the query using the catalog's resource index.
+         * Only equality queries combined with logical and/or can be answered by the index; the candidates must still be evaluated with the query.
+         * @param index The catalog's resource index.
+         * @param type The resource type name being collected; the type must already be indexed.
+         * @return Returns the sorted positions of candidate resources or boost::none if the query cannot be answered by the index.
+         */
+        boost::optional<std::vector<size_t>> find(compiler::resource_index const& index, std::string const& type) const;
+
      private:
-        bool evaluate(ast::basic_query_expression const& expression, compiler::resource const& resource) const;
-        bool climb_expression(
+        struct predicate;
+
+        predicate const& compiled() const;
+        predicate compile(ast::query_expression const& expression) const;
+        predicate compile(ast::basic_query_expression const& expression) const;
+        predicate compile(
             ast::basic_query_expression const& expression,
             std::uint8_t min_precedence,
             std::vector<ast::binary_query_operation>::const_iterator& begin,
-            std::vector<ast::binary_query_operation>::const_iterator const& end,
-            compiler::resource const& resource) const;
+            std::vector<ast::binary_query_operation>::const_iterator const& end) const;
+        static bool evaluate(predicate const& query, compiler::resource const& resource);
+        static boost::optional<std::vector<size_t>> find(predicate const& query, compiler::resource_index const& index, std::string const& type);
         static uint8_t get_precedence(ast::binary_query_operator op);
         static bool is_right_associative(ast::binary_query_operator op);
 
         evaluation::context& _context;
         boost::optional<ast::query_expression> const& _expression;
+        mutable std::shared_ptr<predicate> _predicate;
     };
 
 }}}}  // namespace puppet::compiler::evaluation::collectors
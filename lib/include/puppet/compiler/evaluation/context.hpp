@@ -56,8 +56,9 @@ namespace puppet { namespace compiler { namespace evaluation {
          * Constructs a node scope.
          * @param context The current evaluation context.
          * @param resource The node resource.
+         * @param frame The frame of local variables for the node body.
          */
-        node_scope(evaluation::context& context, compiler::resource& resource);
+        node_scope(evaluation::context& context, compiler::resource& resource, std::shared_ptr<ast::frame const> frame = nullptr);
 
         /**
          * Destructs the node scope.
@@ -300,6 +301,12 @@ namespace puppet { namespace compiler { namespace evaluation {
          */
         compiler::catalog& catalog() const;
 
+        /**
+         * Determines if a catalog is being compiled.
+         * @return Returns true if a catalog is being compiled or false if not.
+         */
+        bool has_catalog() const;
+
         /**
          * Gets the type registry.
          * @return Returns the type registry.
@@ -460,6 +467,13 @@ namespace puppet { namespace compiler { namespace evaluation {
          */
         functions::descriptor const* find_function(std::string const& name, bool import = true) const;
 
+        /**
+         * Gets the cached call site for the given function name, resolving (and importing) the function if it has not yet been resolved.
+         * @param name The function name at the call site.
+         * @return Returns the call site or nullptr if the name is not associated with a syntax tree.
+         */
+        functions::call_site* call_site(ast::name const& name);
+
         /**
          * Finds a type alias by name.
          * @param name The name of the type alias to find (e.g. 'Foo::Bar').
@@ -541,6 +555,8 @@ namespace puppet { namespace compiler { namespace evaluation {
         context(context&) = delete;
         context& operator=(context&) = delete;
         void evaluate_defined_types(size_t& index, std::vector<declared_defined_type*>& virtualized);
+        std::shared_ptr<runtime::values::value const> lookup(ast::variable const& expression, std::string const& name, bool warn);
+        void warn_lookup(ast::variable const& expression, std::string const& ns);
 
         compiler::node* _node;
         compiler::catalog* _catalog;
@@ -559,6 +575,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         std::vector<std::shared_ptr<collectors::collector>> _collectors;
         std::vector<std::ostream*> _stream_stack;
         std::unordered_map<std::string, std::shared_ptr<runtime::values::type>> _resolved_type_aliases;
+        std::unordered_map<ast::name const*, functions::call_site> _call_sites;
     };
 
 }}}  // namespace puppet::compiler::evaluation
@@ -7,12 +7,15 @@
 #include "functions/descriptor.hpp"
 #include "operators/binary/descriptor.hpp"
 #include "operators/unary/descriptor.hpp"
+#include <boost/optional.hpp>
 #include <unordered_map>
+#include <shared_mutex>
 
 namespace puppet { namespace compiler { namespace evaluation {
 
     /**
      * Represents the function and operator call dispatcher.
+     * Functions may be added and found from multiple threads; operators are expected to be added before the dispatcher is shared.
      */
     struct dispatcher
     {
@@ -21,17 +24,6 @@ namespace puppet { namespace compiler { namespace evaluation {
          */
         dispatcher() = default;
 
-        /**
-         * Default move constructor for dispatcher.
-         */
-        dispatcher(dispatcher&&) = default;
-
-        /**
-         * Default move assignment operator for dispatcher.
-         * @return Returns this dispatcher.
-         */
-        dispatcher& operator=(dispatcher&&) = default;
-
         /**
          * Adds the built-in Puppet functions to the dispatcher.
          */
@@ -105,9 +97,10 @@ namespace puppet { namespace compiler { namespace evaluation {
         /**
          * Dispatches a function call.
          * @param context The function call context to dispatch.
+         * @param site The call site of the function call or nullptr if the call has no cached call site.
          * @return Returns the value returned by the called function.
          */
-        runtime::values::value dispatch(functions::call_context& context) const;
+        runtime::values::value dispatch(functions::call_context& context, functions::call_site* site = nullptr) const;
 
         /**
          * Dispatches a binary operator call.
@@ -127,9 +120,10 @@ namespace puppet { namespace compiler { namespace evaluation {
         dispatcher(dispatcher&) = delete;
         dispatcher& operator=(dispatcher&) = delete;
 
+        mutable std::shared_timed_mutex _mutex;
         std::unordered_map<std::string, functions::descriptor> _functions;
-        std::vector<operators::binary::descriptor> _binary_operators;
-        std::vector<operators::unary::descriptor> _unary_operators;
+        std::vector<boost::optional<operators::binary::descriptor>> _binary_operators;
+        std::vector<boost::optional<operators::unary::descriptor>> _unary_operators;
     };
 
 }}}  // namespace puppet::compiler::evaluation
@@ -136,6 +136,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             std::vector<ast::binary_operation>::const_iterator& begin,
             std::vector<ast::binary_operation>::const_iterator const& end);
 
+        runtime::values::value execute(ast::expression const& expression);
         void align_text(std::string const& text, size_t margin, size_t& current_margin, std::function<void(char const*, size_t)> const& callback);
 
         evaluation::context& _context;
@@ -159,8 +160,9 @@ namespace puppet { namespace compiler { namespace evaluation {
          * @param name The function's name.
          * @param parameters The function's parameters.
          * @param body The function's body.
+         * @param frame The frame of local variables for the function's body.
          */
-        function_evaluator(evaluation::context& context, char const* name, std::vector<ast::parameter> const& parameters, std::vector<ast::statement> const& body);
+        function_evaluator(evaluation::context& context, char const* name, std::vector<ast::parameter> const& parameters, std::vector<ast::statement> const& body, std::shared_ptr<ast::frame const> frame = nullptr);
 
         /**
          * Evaluates the function.
@@ -190,6 +192,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         ast::function_statement const* _statement;
         std::vector<ast::parameter> const& _parameters;
         std::vector<ast::statement> const& _body;
+        std::shared_ptr<ast::frame const> _frame;
     };
 
     /**
@@ -8,6 +8,7 @@
 #include "../../ast/ast.hpp"
 #include "../../../runtime/values/value.hpp"
 #include <boost/optional.hpp>
+#include <functional>
 
 namespace puppet { namespace compiler { namespace evaluation { namespace functions {
 
@@ -37,8 +38,15 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
          * @param instance The value the method is being called on.
          * @param instance_context The AST context for the instance.
          * @param splat True if splatting of the instance value is supported or false if not.
+         * @param lazy True if the result is only iterated by another iterating function and may be returned as a lazy iterator or false if not.
          */
-        call_context(evaluation::context& context, ast::method_call_expression const& expression, runtime::values::value& instance, ast::context const& instance_context, bool splat);
+        call_context(
+            evaluation::context& context,
+            ast::method_call_expression const& expression,
+            runtime::values::value& instance,
+            ast::context const& instance_context,
+            bool splat,
+            bool lazy = false);
 
         /**
          * Constructs a function call context from a new expression.
@@ -99,6 +107,22 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
          */
         ast::context const& argument_context(size_t index) const;
 
+        /**
+         * Shares an argument to the function so that its elements can be passed to the block without copying.
+         * Only arrays and hashes are shared; the argument is replaced with a variable referencing the shared value.
+         * @param index The argument index.
+         * @return Returns the shared argument or nullptr if the argument's elements cannot be shared.
+         */
+        std::shared_ptr<runtime::values::value const> share_argument(size_t index);
+
+        /**
+         * Gets the value to pass to the block for an element of a shared argument.
+         * @param owner The shared argument that contains the element or nullptr if the argument is not shared.
+         * @param element The element of the argument.
+         * @return Returns a variable referencing the element if the argument is shared or a copy of the element if not.
+         */
+        static runtime::values::value share(std::shared_ptr<runtime::values::value const> const& owner, runtime::values::value const& element);
+
         /**
          * Gets the optional block passed to the function.
          * @return Returns the optional block passed to the function or nullptr if no block were passed.
@@ -119,8 +143,27 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
          */
         runtime::values::value yield_without_catch(runtime::values::array& arguments) const;
 
+        /**
+         * Creates a callback that yields to the block if one is present.
+         * Unlike yield, the callback does not reference the call context and may be invoked after the function call has returned.
+         * @return Returns the callback that yields to the block.
+         */
+        std::function<runtime::values::value(runtime::values::array&)> yielder() const;
+
+        /**
+         * Determines if the function's result is only iterated by another iterating function.
+         * Iterating functions may return a lazy iterator in this case rather than a materialized result.
+         * @return Returns true if the result may be lazy or false if not.
+         */
+        bool lazy() const;
+
     private:
         void evaluate_arguments(std::vector<ast::expression> const& arguments);
+        static runtime::values::value invoke_block(
+            evaluation::context& context,
+            ast::lambda_expression const& block,
+            std::shared_ptr<scope> const& closure_scope,
+            runtime::values::array& arguments);
 
         evaluation::context& _context;
         ast::name const& _name;
@@ -129,6 +172,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         boost::optional<runtime::values::value> _transfer;
         boost::optional<ast::lambda_expression> const& _block;
         std::shared_ptr<scope> _closure_scope;
+        bool _lazy = false;
     };
 
 }}}}  // namespace puppet::compiler::evaluation::functions
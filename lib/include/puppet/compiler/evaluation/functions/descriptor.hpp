@@ -10,11 +10,192 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <utility>
+#include <type_traits>
 
 namespace puppet { namespace compiler { namespace evaluation { namespace functions {
 
     // Forward declaration of function call_context.
     struct call_context;
+    // Forward declaration of descriptor.
+    struct descriptor;
+
+    /**
+     * Represents the cached dispatch state of a function call site.
+     * Call sites are cached per evaluation context so that the function and overload lookups are not repeated on every call.
+     */
+    struct call_site
+    {
+        /**
+         * Stores the resolved function descriptor or nullptr if the function has not been resolved.
+         */
+        descriptor const* function = nullptr;
+
+        /**
+         * Stores the number of arguments of the last dispatched call.
+         */
+        int64_t arguments = -1;
+
+        /**
+         * Stores the number of block parameters of the last dispatched call or -1 if no block was passed.
+         */
+        int64_t block_parameters = -1;
+
+        /**
+         * Stores the kinds of the arguments of the last dispatched call.
+         */
+        std::vector<int> kinds;
+
+        /**
+         * Stores the index of the overload that dispatched the last call.
+         */
+        size_t overload = 0;
+
+        /**
+         * Stores whether or not the overload can be reused without type checks for a call with the same argument kinds.
+         * This is only the case when the overload and the overloads before it check nothing but the kinds of the arguments.
+         */
+        bool reusable = false;
+
+        /**
+         * Stores the syntax tree containing the call site; this keeps the call site's AST alive while it is cached.
+         */
+        std::shared_ptr<ast::syntax_tree> tree;
+    };
+
+    /**
+     * Maps the C++ type of a built-in function's argument to its Puppet type.
+     * Specializations exist for the runtime value types that correspond to an unconstrained Puppet type.
+     * @tparam T The C++ type of the argument.
+     */
+    template <typename T>
+    struct argument_type;
+
+    /**
+     * Specialization of argument_type for Any.
+     */
+    template <>
+    struct argument_type<runtime::values::value>
+    {
+        /**
+         * Creates the Puppet type of the argument.
+         * @return Returns the Puppet type of the argument.
+         */
+        static runtime::values::type create()
+        {
+            return runtime::types::any{};
+        }
+
+        /**
+         * Gets the argument from the argument value.
+         * @param value The argument value that has already been checked against the Puppet type.
+         * @return Returns the argument.
+         */
+        static runtime::values::value const& get(runtime::values::value const& value)
+        {
+            return value;
+        }
+    };
+
+    /**
+     * Implements argument_type for runtime value types that are stored directly in a value.
+     * @tparam T The runtime value type.
+     * @tparam Type The Puppet type of the argument.
+     */
+    template <typename T, typename Type>
+    struct value_argument_type
+    {
+        /**
+         * Creates the Puppet type of the argument.
+         * @return Returns the Puppet type of the argument.
+         */
+        static runtime::values::type create()
+        {
+            return Type{};
+        }
+
+        /**
+         * Gets the argument from the argument value.
+         * Dispatch has already checked the value's type, so the value is not checked again.
+         * @param value The argument value.
+         * @return Returns the argument.
+         */
+        static T const& get(runtime::values::value const& value)
+        {
+            return *value.as<T>();
+        }
+    };
+
+    /**
+     * Specialization of argument_type for Integer.
+     */
+    template <>
+    struct argument_type<std::int64_t> : value_argument_type<std::int64_t, runtime::types::integer> {};
+
+    /**
+     * Specialization of argument_type for Float.
+     */
+    template <>
+    struct argument_type<double> : value_argument_type<double, runtime::types::floating> {};
+
+    /**
+     * Specialization of argument_type for Boolean.
+     */
+    template <>
+    struct argument_type<bool> : value_argument_type<bool, runtime::types::boolean> {};
+
+    /**
+     * Specialization of argument_type for String.
+     */
+    template <>
+    struct argument_type<std::string> : value_argument_type<std::string, runtime::types::string> {};
+
+    /**
+     * Specialization of argument_type for Regexp.
+     */
+    template <>
+    struct argument_type<runtime::values::regex> : value_argument_type<runtime::values::regex, runtime::types::regexp> {};
+
+    /**
+     * Specialization of argument_type for Type.
+     */
+    template <>
+    struct argument_type<runtime::values::type> : value_argument_type<runtime::values::type, runtime::types::type> {};
+
+    /**
+     * Specialization of argument_type for Array[Any].
+     */
+    template <>
+    struct argument_type<runtime::values::array> : value_argument_type<runtime::values::array, runtime::types::array>
+    {
+        /**
+         * Creates the Puppet type of the argument.
+         * @return Returns the Puppet type of the argument.
+         */
+        static runtime::values::type create()
+        {
+            return runtime::types::array{ std::make_unique<runtime::values::type>(runtime::types::any{}) };
+        }
+    };
+
+    /**
+     * Specialization of argument_type for Hash[Any, Any].
+     */
+    template <>
+    struct argument_type<runtime::values::hash> : value_argument_type<runtime::values::hash, runtime::types::hash>
+    {
+        /**
+         * Creates the Puppet type of the argument.
+         * @return Returns the Puppet type of the argument.
+         */
+        static runtime::values::type create()
+        {
+            return runtime::types::hash{
+                std::make_unique<runtime::values::type>(runtime::types::any{}),
+                std::make_unique<runtime::values::type>(runtime::types::any{})
+            };
+        }
+    };
 
     /**
      * Responsible for describing a Puppet function.
@@ -58,20 +239,66 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
          */
         void add(std::string const& signature, callback_type callback);
 
+        /**
+         * Adds a dispatch descriptor for the function.
+         * @param signature The signature for function call dispatch.
+         * @param callback The callback to invoke when the function call is dispatched.
+         */
+        void add(runtime::types::callable signature, callback_type callback);
+
+        /**
+         * Adds a dispatch descriptor for the function with a signature derived from the callback's parameters.
+         * The callback is given the call context followed by the arguments, which are unpacked without further type checks.
+         * Each argument must be passed by const reference or by value as a type with an argument_type specialization.
+         * @tparam Callback The type of callback.
+         * @param callback The callback to invoke when the function call is dispatched.
+         */
+        template <typename Callback>
+        void add(Callback callback)
+        {
+            add_typed(rvalue_cast(callback), &Callback::operator());
+        }
+
         /**
          * Dispatches a function call to the matching dispatch descriptor.
          * @param context The call context to dispatch.
+         * @param site The call site of the function call or nullptr if the call has no cached call site.
          * @return Returns the result of the function call.
          */
-        runtime::values::value dispatch(call_context& context) const;
+        runtime::values::value dispatch(call_context& context, call_site* site = nullptr) const;
 
      private:
         struct dispatch_descriptor
         {
             runtime::types::callable signature;
             callback_type callback;
+            bool unconstrained = false;
         };
 
+        template <typename Callback, typename Result, typename... Args>
+        void add_typed(Callback callback, Result (Callback::*)(call_context&, Args...) const)
+        {
+            std::vector<std::unique_ptr<runtime::values::type>> types;
+            types.reserve(sizeof...(Args));
+            int expand[] = { 0, (types.emplace_back(std::make_unique<runtime::values::type>(argument_type<std::decay_t<Args>>::create())), 0)... };
+            static_cast<void>(expand);
+
+            auto count = static_cast<int64_t>(sizeof...(Args));
+            add(runtime::types::callable{ rvalue_cast(types), count, count }, unpack<Args...>(rvalue_cast(callback), std::index_sequence_for<Args...>{}));
+        }
+
+        template <typename... Args, typename Callback, size_t... Indexes>
+        static callback_type unpack(Callback callback, std::index_sequence<Indexes...>)
+        {
+            // The call context is not complete here, so the wrapper is generic over it
+            return [callback = rvalue_cast(callback)](auto& context) -> runtime::values::value {
+                return callback(context, argument_type<std::decay_t<Args>>::get(context.argument(Indexes))...);
+            };
+        }
+
+        size_t find_overload(call_context const& context, call_site const* site, bool& matched) const;
+        void cache_overload(call_context const& context, call_site& site, size_t index) const;
+        static bool accepts(runtime::types::callable const& signature, int64_t argument_count, int64_t block_parameter_count);
         std::vector<dispatch_descriptor const*> check_argument_count(call_context const& context) const;
         void check_block_parameters(call_context const& context, std::vector<dispatch_descriptor const*> const& invocable) const;
         void check_parameter_types(call_context const& context, std::vector<dispatch_descriptor const*> const& invocable) const;
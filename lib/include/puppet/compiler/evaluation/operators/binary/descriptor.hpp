@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../../../ast/ast.hpp"
+#include "../kind.hpp"
 #include "../../../../runtime/values/value.hpp"
 #include <string>
 #include <vector>
@@ -45,6 +46,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
         /**
          * Adds a dispatch descriptor for the operator.
+         * The overload is added to the operator's dispatch table for each combination of operand kinds it may accept.
          * @param left_type The type of the left-hand operand to the binary operator
          * @param right_type The type of the right-hand operand to the binary operator
          * @param callback The callback to invoke when the function call is dispatched.
@@ -68,6 +70,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
         ast::binary_operator _operator;
         std::vector<dispatch_descriptor> _dispatch_descriptors;
+        std::vector<std::vector<kind_candidate>> _table;
     };
 
 }}}}}  // puppet::compiler::evaluation::operators::binary
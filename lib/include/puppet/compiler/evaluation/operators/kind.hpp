@@ -0,0 +1,79 @@
+/**
+ * @file
+ * Declares the helpers for dispatching operators by runtime value kind.
+ */
+#pragma once
+
+#include "../../../runtime/values/value.hpp"
+#include <boost/mpl/size.hpp>
+#include <vector>
+
+namespace puppet { namespace compiler { namespace evaluation { namespace operators {
+
+    /**
+     * The number of runtime value kinds.
+     */
+    constexpr size_t kind_count = boost::mpl::size<runtime::values::value_base::types>::value;
+
+    /**
+     * Represents the result of matching an operand type against a runtime value kind.
+     */
+    enum class kind_match
+    {
+        /**
+         * No value of the kind is an instance of the type.
+         */
+        never,
+        /**
+         * Every value of the kind is an instance of the type.
+         */
+        always,
+        /**
+         * Values of the kind must be checked against the type.
+         */
+        maybe
+    };
+
+    /**
+     * Represents an operator overload that may be dispatched to for a combination of operand kinds.
+     */
+    struct kind_candidate
+    {
+        /**
+         * Stores the index of the overload.
+         */
+        size_t index;
+
+        /**
+         * Stores whether or not the operand types must be checked before dispatching to the overload.
+         */
+        bool check;
+    };
+
+    /**
+     * Gets the kind of the given runtime value.
+     * Variables are dereferenced so that the kind is of the value the variable holds.
+     * @param value The value to get the kind of.
+     * @return Returns the kind of the value.
+     */
+    size_t kind_of(runtime::values::value const& value);
+
+    /**
+     * Matches an operand type against a runtime value kind.
+     * Only unconstrained types that correspond to a single value kind are matched exactly; all other types may match any kind.
+     * @param type The operand type to match.
+     * @param kind The runtime value kind to match against.
+     * @return Returns the result of the match.
+     */
+    kind_match match_kind(runtime::values::type const& type, size_t kind);
+
+    /**
+     * Adds an overload to the given list of candidates.
+     * Candidates following an overload that always matches are never dispatched to and are not added.
+     * @param candidates The candidates for a combination of operand kinds.
+     * @param index The index of the overload.
+     * @param match The result of matching the overload's operand types against the operand kinds.
+     */
+    void add_candidate(std::vector<kind_candidate>& candidates, size_t index, kind_match match);
+
+}}}}  // namespace puppet::compiler::evaluation::operators
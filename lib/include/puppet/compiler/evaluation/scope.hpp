@@ -6,10 +6,13 @@
 
 #include "../resource.hpp"
 #include "../ast/ast.hpp"
+#include "../symbol.hpp"
+#include <boost/functional/hash.hpp>
 #include "../../runtime/values/value.hpp"
 #include "../../facts/provider.hpp"
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include <memory>
 #include <cstdint>
 #include <functional>
@@ -56,8 +59,9 @@ namespace puppet { namespace compiler { namespace evaluation {
          * Constructs a scope.
          * @param parent The parent scope.
          * @param resource The resource associated with the scope.
+         * @param frame The frame of local variables for the body being evaluated in the scope.
          */
-        explicit scope(std::shared_ptr<scope> parent, compiler::resource* resource = nullptr);
+        explicit scope(std::shared_ptr<scope> parent, compiler::resource* resource = nullptr, std::shared_ptr<ast::frame const> frame = nullptr);
 
         /**
          * Constructs the top scope.
@@ -101,9 +105,27 @@ namespace puppet { namespace compiler { namespace evaluation {
          * @param name The name of the variable (e.g. 'foo').
          * @param value The value of the variable.
          * @param context The context of where the variable was assigned.
+         * @param slot The frame slot of the variable or ast::frame::npos if the variable has no slot in the scope's frame.
          * @return Returns the previous assignment context if the variable was already set or returns nullptr if the variable was successfully set.
          */
-        assignment_context const* set(std::string name, std::shared_ptr<runtime::values::value const> value, ast::context const& context);
+        assignment_context const* set(std::string name, std::shared_ptr<runtime::values::value const> value, ast::context const& context, size_t slot = ast::frame::npos);
+
+        /**
+         * Sets a variable in the scope.
+         * @param name The interned name of the variable.
+         * @param value The value of the variable.
+         * @param context The context of where the variable was assigned.
+         * @param slot The frame slot of the variable or ast::frame::npos if the variable has no slot in the scope's frame.
+         * @return Returns the previous assignment context if the variable was already set or returns nullptr if the variable was successfully set.
+         */
+        assignment_context const* set(symbol const& name, std::shared_ptr<runtime::values::value const> value, ast::context const& context, size_t slot = ast::frame::npos);
+
+        /**
+         * Gets the frame slot of the given variable in the scope.
+         * @param variable The variable to get the slot of.
+         * @return Returns the slot of the variable or ast::frame::npos if the variable was not resolved to the scope's frame.
+         */
+        size_t slot(ast::variable const& variable) const;
 
         /**
          * Gets a variable in the scope.
@@ -112,6 +134,27 @@ namespace puppet { namespace compiler { namespace evaluation {
          */
         std::shared_ptr<runtime::values::value const> get(std::string const& name);
 
+        /**
+         * Gets a variable in the scope.
+         * @param name The interned name of the variable to get.
+         * @return Returns the assigned variable or nullptr if the variable does not exist in the scope.
+         */
+        std::shared_ptr<runtime::values::value const> get(symbol const& name);
+
+        /**
+         * Gets the frame of local variables for the scope.
+         * @return Returns the frame of local variables or nullptr if the scope has no frame.
+         */
+        ast::frame const* frame() const;
+
+        /**
+         * Gets a local variable in the scope by its frame slot.
+         * Unlike getting a variable by name, parent scopes are not searched.
+         * @param slot The slot of the local variable.
+         * @return Returns the assigned variable or nullptr if the variable has not been set in the scope.
+         */
+        std::shared_ptr<runtime::values::value const> const& get(size_t slot) const;
+
         /**
          * Adds resource attribute defaults to the scope.
          * @param context The current evaluation context.
@@ -140,7 +183,11 @@ namespace puppet { namespace compiler { namespace evaluation {
         std::shared_ptr<facts::provider> _facts;
         std::shared_ptr<scope> _parent;
         compiler::resource* _resource;
-        std::unordered_map<std::string, std::pair<std::shared_ptr<runtime::values::value const>, assignment_context>> _variables;
+        std::shared_ptr<ast::frame const> _frame;
+        std::vector<std::shared_ptr<runtime::values::value const>> _slots;
+        std::shared_ptr<runtime::values::value const> get(symbol const& symbol, std::string const& name);
+
+        std::unordered_map<symbol, std::pair<std::shared_ptr<runtime::values::value const>, assignment_context>, boost::hash<symbol>> _variables;
         std::unordered_map<std::string, attributes> _defaults;
     };
 
@@ -152,6 +152,14 @@ namespace puppet { namespace compiler {
          */
         parse_exception(std::string const& message, lexer::position begin, lexer::position end);
 
+        /**
+         * Constructs a parse exception for a syntax tree.
+         * The tree is kept so that the line of text can be reported from the source the tree was parsed from.
+         * @param ex The parse exception raised while parsing, validating, or scanning the tree.
+         * @param tree The syntax tree that was being parsed, validated, or scanned.
+         */
+        parse_exception(parse_exception const& ex, std::shared_ptr<ast::syntax_tree const> tree);
+
         /**
          * Gets the beginning position for the parse exception.
          * @return Returns the beginning position for the parse exception.
@@ -164,6 +172,12 @@ namespace puppet { namespace compiler {
          */
         lexer::position const& end() const;
 
+        /**
+         * Gets the syntax tree associated with the parse exception.
+         * @return Returns the syntax tree or nullptr if the parse exception is not associated with a syntax tree.
+         */
+        ast::syntax_tree const* tree() const;
+
     private:
         static std::string format_message(lexer::token_id id);
         static std::string format_message(boost::optional<char> character);
@@ -171,6 +185,7 @@ namespace puppet { namespace compiler {
 
         lexer::position _begin;
         lexer::position _end;
+        std::shared_ptr<ast::syntax_tree const> _tree;
     };
 
     /**
@@ -231,7 +246,7 @@ namespace puppet { namespace compiler {
          * Constructs a compilation exception from a parse exception.
          * @param ex The parse exception.
          * @param path The path to the file that was parsed.
-         * @param source The source code; if empty, the source text will be read from the file.
+         * @param source The source code; used only if the parse exception is not associated with a syntax tree.
          */
         compilation_exception(parse_exception const& ex, std::string const& path, std::string const& source = {});
 
@@ -8,6 +8,10 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace puppet { namespace compiler {
 
@@ -40,6 +44,8 @@ namespace puppet { namespace compiler {
 
     /**
      * Responsible for finding files.
+     * Lookups by name or path are answered from an index of each file type's directory that is built on first use.
+     * Directories reached through symbolic links are not indexed; lookups beneath them check the file system instead.
      */
     struct finder
     {
@@ -87,8 +93,19 @@ namespace puppet { namespace compiler {
         void each_file(find_type type, std::function<bool(std::string const&)> const& callback) const;
 
      private:
+        struct file_index
+        {
+            std::once_flag built;
+            std::unordered_map<std::string, std::string> files;
+            std::unordered_set<std::string> links;
+        };
+
+        file_index const& index(find_type type) const;
+        std::string find(find_type type, std::string const& relative) const;
+
         std::string _directory;
         std::string _manifest_setting;
+        std::shared_ptr<std::array<file_index, 5>> _indexes;
     };
 
 }}  // puppet::compiler
@@ -10,6 +10,7 @@
 #include "../exceptions.hpp"
 #include "../../logging/logger.hpp"
 #include "../../utility/regex.hpp"
+#include "../../utility/filesystem/mapped_file.hpp"
 #include "../../unicode/string.hpp"
 #include "../../cast.hpp"
 #include <limits>
@@ -1364,6 +1365,10 @@ namespace puppet { namespace compiler { namespace lexer {
      * The input iterator for strings.
      */
     using lexer_string_iterator = lexer_iterator<typename std::string::const_iterator>;
+    /**
+     * The input iterator for in-memory buffers (e.g. mapped files).
+     */
+    using lexer_buffer_iterator = lexer_iterator<char const*>;
 
     /**
      * The token type for the lexer.
@@ -1390,6 +1395,15 @@ namespace puppet { namespace compiler { namespace lexer {
      * Include "static_lexer.hpp" before including "lexer.hpp" to use this type.
      */
     using string_static_lexer = lexer<boost::spirit::lex::lexertl::static_actor_lexer<lexer_token<lexer_string_iterator>>>;
+    /**
+     * The lexer to use for in-memory buffers.
+     */
+    using buffer_lexer = lexer<boost::spirit::lex::lexertl::actor_lexer<lexer_token<lexer_buffer_iterator>>>;
+    /**
+     * The static lexer to use for in-memory buffers.
+     * Include "static_lexer.hpp" before including "lexer.hpp" to use this type.
+     */
+    using buffer_static_lexer = lexer<boost::spirit::lex::lexertl::static_actor_lexer<lexer_token<lexer_buffer_iterator>>>;
 
     /**
      * Gets the lexer's beginning iterator for the given file.
@@ -1433,6 +1447,20 @@ namespace puppet { namespace compiler { namespace lexer {
      */
     lexer_string_iterator lex_end(boost::iterator_range<lexer_string_iterator> const& range);
 
+    /**
+     * Gets the lexer's beginning iterator for the given mapped file.
+     * @param file The mapped file to lex.
+     * @return Returns the beginning input iterator for the lexer.
+     */
+    lexer_buffer_iterator lex_begin(utility::filesystem::mapped_file const& file);
+
+    /**
+     * Gets the lexer's ending iterator for the given mapped file.
+     * @param file The mapped file to lex.
+     * @return Returns the ending input iterator for the lexer.
+     */
+    lexer_buffer_iterator lex_end(utility::filesystem::mapped_file const& file);
+
     /**
      * Represents line information for display source code context.
      */
@@ -1474,6 +1502,26 @@ namespace puppet { namespace compiler { namespace lexer {
      */
     line_info get_line_info(std::string const& input, size_t position, size_t length, size_t tab_width = LEXER_TAB_WIDTH);
 
+    /**
+     * Gets the line info given a position and length inside of a mapped file.
+     * @param input The input mapped file.
+     * @param position The position (byte offset) inside the file.
+     * @param length The length, in bytes, of the source being highlighted.
+     * @param tab_width Specifies the width of a tab character for column calculations.
+     * @return Returns the line information.
+     */
+    line_info get_line_info(utility::filesystem::mapped_file const& input, size_t position, size_t length, size_t tab_width = LEXER_TAB_WIDTH);
+
+    /**
+     * Gets the line info given a position and length inside of a string reference.
+     * @param input The input string reference.
+     * @param position The position (byte offset) inside the string reference.
+     * @param length The length, in bytes, of the source being highlighted.
+     * @param tab_width Specifies the width of a tab character for column calculations.
+     * @return Returns the line information.
+     */
+    line_info get_line_info(boost::string_ref const& input, size_t position, size_t length, size_t tab_width = LEXER_TAB_WIDTH);
+
     /**
      * Gets the last position for the given file stream.
      * @param input The input file stream.
@@ -1488,6 +1536,13 @@ namespace puppet { namespace compiler { namespace lexer {
      */
     position get_last_position(std::string const& input);
 
+    /**
+     * Gets the last position for the given mapped file.
+     * @param input The input mapped file.
+     * @return Returns the last position in the mapped file.
+     */
+    position get_last_position(utility::filesystem::mapped_file const& input);
+
     /**
      * Gets the last position for the given input string iterator range.
      * @param range The input string iterator range.
@@ -5,12 +5,14 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <ostream>
 
 namespace puppet { namespace compiler { namespace lexer {
 
     /**
      * Represents a position within a lexed input.
+     * Offsets and lines are stored in 32 bits to keep AST contexts compact; inputs are limited to 4 GiB.
      */
     struct position
     {
@@ -45,8 +47,8 @@ namespace puppet { namespace compiler { namespace lexer {
         void increment(bool newline);
 
     private:
-        size_t _offset;
-        size_t _line;
+        std::uint32_t _offset;
+        std::uint32_t _line;
     };
 
     /**
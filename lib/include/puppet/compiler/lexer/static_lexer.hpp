@@ -0,0 +1,3071 @@
+// Copyright (c) 2008-2009 Ben Hanson
+// Copyright (c) 2008-2011 Hartmut Kaiser
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file licence_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Auto-generated by boost::lexer, do not edit
+
+#if !defined(BOOST_SPIRIT_LEXER_NEXT_TOKEN_OCT_17_2026_01_06_03)
+#define BOOST_SPIRIT_LEXER_NEXT_TOKEN_OCT_17_2026_01_06_03
+
+#include <boost/spirit/home/support/detail/lexer/char_traits.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+// the generated table of state names and the tokenizer have to be
+// defined in the boost::spirit::lex::lexertl::static_ namespace
+namespace boost { namespace spirit { namespace lex { namespace lexertl { namespace static_ {
+
+////////////////////////////////////////////////////////////////////////////////
+// this table defines the names of the lexer states
+char const* const lexer_state_names[9] = 
+{
+    "INITIAL",
+    "EPP",
+    "DQS",
+    "VC",
+    "VLH",
+    "HD",
+    "HDE",
+    "SC",
+    "FS"
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// this variable defines the number of lexer states
+std::size_t const lexer_state_count = 9;
+
+////////////////////////////////////////////////////////////////////////////////
+// this function returns the next matched token
+template<typename Iterator>
+std::size_t next_token (std::size_t& start_state_, bool& /*bol_*/, 
+    Iterator &start_token_, Iterator const& end_, std::size_t& unique_id_)
+{
+    enum {end_state_index, id_index, unique_id_index, state_index, bol_index,
+        eol_index, dead_state_index, dfa_offset};
+
+    static std::size_t const npos = static_cast<std::size_t>(~0);
+    static std::size_t const lookup0_[256] = {
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 9, 7, 9, 9, 8, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        9, 10, 11, 12, 13, 19, 69, 20,
+        21, 22, 23, 24, 25, 26, 27, 28,
+        29, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 30, 31, 32, 33, 34, 35,
+        36, 37, 37, 37, 37, 38, 37, 37,
+        37, 37, 37, 37, 37, 37, 37, 37,
+        37, 37, 37, 37, 37, 37, 37, 37,
+        37, 37, 37, 39, 40, 41, 69, 15,
+        69, 42, 43, 44, 45, 17, 46, 47,
+        48, 49, 16, 50, 51, 52, 53, 54,
+        55, 56, 57, 58, 59, 60, 61, 62,
+        63, 64, 65, 66, 14, 67, 68, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69,
+        69, 69, 69, 69, 69, 69, 69, 69 };
+    static const std::size_t dfa0_[20020] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 4, 4, 4,
+        11, 19, 5, 29, 8, 47, 46, 33,
+        48, 2, 20, 21, 22, 23, 9, 26,
+        3, 24, 6, 48, 25, 27, 7, 10,
+        12, 28, 13, 45, 45, 15, 49, 16,
+        35, 42, 30, 31, 38, 46, 46, 32,
+        46, 46, 46, 34, 36, 40, 46, 43,
+        41, 39, 37, 46, 44, 46, 46, 46,
+        17, 18, 14, 49, 1, 37, 64, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 50, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 45, 61, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 51, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 52, 53, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65608, 24, 0, 0, 0, 0, 4,
+        4, 4, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 54,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65607,
+        25, 0, 0, 0, 0, 0, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        5, 5, 5, 5, 1, 47, 62, 0,
+        0, 0, 0, 0, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 55, 56, 56, 56, 56,
+        58, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 57, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 1, 60, 59, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        61, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 62, 0, 0, 0,
+        0, 0, 59, 60, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 63, 0,
+        1, 124, 67, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 64, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 43,
+        60, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 65,
+        66, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 61, 57, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 67, 69, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        68, 0, 1, 33, 65, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 70, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 71, 0,
+        1, 62, 58, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 72, 73, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 64,
+        68, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 75, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 74, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 126, 74, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 76, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 91, 49, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 93, 50, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 123,
+        51, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 125, 52, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 34, 53, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 39, 54, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 40,
+        55, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 41, 56, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 42, 63, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 46, 66, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 58,
+        69, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 77, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 44, 70, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 59, 71, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 63, 72, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 36,
+        73, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 81, 81, 81,
+        79, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 78, 80, 0, 0, 0,
+        0, 0, 0, 82, 82, 0, 0, 0,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 83, 46,
+        46, 46, 46, 46, 46, 46, 46, 84,
+        46, 46, 85, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 88, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 89, 46,
+        46, 46, 46, 46, 91, 90, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 92, 46, 46, 46, 46, 46, 93,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 95, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 94, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 96,
+        46, 98, 46, 46, 46, 97, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 99, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 100, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 102, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        101, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 105, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 104, 46, 46, 46, 46,
+        46, 46, 103, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 106, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 107,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 108, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 109, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 110, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65596,
+        117, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 45, 45, 45,
+        45, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 45, 111, 0, 0, 0,
+        0, 0, 0, 112, 112, 0, 0, 0,
+        45, 45, 45, 45, 45, 45, 45, 45,
+        45, 45, 45, 45, 45, 45, 45, 45,
+        45, 45, 45, 45, 45, 45, 45, 45,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65594, 119, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 47, 47, 47, 47, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 47,
+        0, 0, 0, 0, 0, 0, 0, 47,
+        47, 0, 0, 0, 47, 47, 47, 47,
+        47, 47, 47, 47, 47, 47, 47, 47,
+        47, 47, 47, 47, 47, 47, 47, 47,
+        47, 47, 47, 47, 0, 0, 0, 0,
+        1, 65599, 121, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 48,
+        48, 114, 48, 0, 0, 0, 0, 0,
+        0, 0, 0, 113, 0, 48, 0, 0,
+        0, 0, 0, 0, 0, 48, 114, 0,
+        0, 0, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 48, 48, 48, 48, 48, 48,
+        48, 48, 0, 0, 0, 0, 1, 65536,
+        122, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65602, 8, 1,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 115, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65538, 31, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65554,
+        44, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65600, 116, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65609, 27, 0, 0, 0,
+        0, 116, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 118, 117, 117, 117, 117, 120, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 119, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 58, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        57, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 0, 0,
+        0, 0, 0, 0, 0, 0, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 56, 56, 56, 56,
+        56, 56, 56, 56, 1, 65598, 26, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65547, 40, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        121, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65544, 37, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65549,
+        41, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65556, 46, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65557, 47, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65552, 48, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 122, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65537,
+        30, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65546, 39, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65539, 32, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65541, 34, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65545,
+        38, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65540, 33, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65542, 35, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65543, 36, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65550,
+        42, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65553, 43, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 75, 75, 123, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        0, 124, 124, 124, 124, 124, 0, 124,
+        0, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        1, 65555, 45, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 125, 125,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 45, 45, 0, 0, 0,
+        125, 125, 125, 125, 125, 125, 125, 125,
+        125, 125, 125, 125, 125, 125, 125, 125,
+        125, 125, 125, 125, 125, 125, 125, 125,
+        0, 0, 0, 0, 1, 65595, 114, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 82, 82, 82, 82, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 82, 126, 0, 0, 0, 0, 0,
+        0, 82, 82, 0, 0, 0, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 0, 0,
+        0, 0, 1, 65595, 114, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 82, 82, 82, 79, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 79,
+        126, 0, 0, 0, 0, 0, 0, 82,
+        82, 0, 0, 0, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 127, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65595,
+        114, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 81, 81, 81,
+        81, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 81, 128, 0, 0, 0,
+        0, 0, 0, 81, 81, 0, 0, 0,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        0, 0, 0, 0, 1, 65595, 115, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 82, 82, 82, 82, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 82, 126, 0, 0, 0, 0, 0,
+        0, 82, 82, 0, 0, 0, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 129, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 130, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 131, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 132, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 47, 47, 47, 47, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 47,
+        0, 0, 0, 0, 0, 0, 0, 47,
+        47, 0, 0, 0, 47, 47, 47, 47,
+        47, 47, 47, 47, 47, 47, 47, 47,
+        47, 47, 47, 47, 47, 47, 47, 47,
+        47, 47, 47, 47, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 134, 46, 46, 133, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65563,
+        79, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65573, 87, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        136, 46, 137, 46, 135, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 138, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 139, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 140,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 141, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 142,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 143, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 144, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 145, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 146, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65569, 85, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 147, 46, 46,
+        46, 46, 46, 148, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 149, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 151, 46, 150,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 152, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 153, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 154, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 155, 46, 46,
+        46, 46, 156, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 157, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 158, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        161, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 160, 46,
+        46, 159, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 162, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        163, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65596, 117, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 112,
+        112, 112, 112, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 112, 111, 0,
+        0, 0, 0, 0, 0, 112, 112, 0,
+        0, 0, 112, 112, 112, 112, 112, 112,
+        112, 112, 112, 112, 112, 112, 112, 112,
+        112, 112, 112, 112, 112, 112, 112, 112,
+        112, 112, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        164, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 164, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65599, 121, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 165, 165, 114, 165, 0,
+        0, 0, 0, 0, 0, 0, 166, 113,
+        0, 165, 0, 0, 0, 0, 0, 0,
+        0, 165, 114, 0, 0, 0, 165, 165,
+        165, 165, 165, 165, 165, 165, 165, 165,
+        165, 165, 165, 165, 165, 165, 165, 165,
+        165, 165, 165, 165, 165, 165, 0, 0,
+        0, 0, 1, 65604, 9, 1, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 167,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 0, 0,
+        0, 0, 0, 0, 0, 116, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 118, 117, 117,
+        117, 117, 120, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 119, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 0, 0, 0, 0,
+        0, 0, 0, 168, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 118, 170, 170, 170, 170,
+        169, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 171, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 0, 0, 0, 0, 0, 0,
+        0, 116, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 118, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117,
+        1, 65598, 26, 0, 0, 0, 0, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 167,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 1, 65548,
+        28, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65551, 29, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 123, 123, 123, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        174, 124, 124, 124, 124, 124, 173, 124,
+        172, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        0, 0, 0, 0, 0, 0, 0, 175,
+        175, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 174, 124,
+        124, 124, 124, 124, 173, 124, 172, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 124, 124, 124, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 125, 125, 125,
+        125, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 125, 86, 0, 0, 0,
+        0, 0, 0, 125, 125, 0, 0, 0,
+        125, 125, 125, 125, 125, 125, 125, 125,
+        125, 125, 125, 125, 125, 125, 125, 125,
+        125, 125, 125, 125, 125, 125, 125, 125,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 176, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 81, 81, 81, 82, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 82,
+        0, 0, 0, 0, 0, 0, 0, 82,
+        82, 0, 0, 0, 81, 81, 81, 81,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        81, 81, 81, 81, 81, 81, 81, 81,
+        81, 81, 81, 81, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 177, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 178,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 179, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 180, 181, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        182, 182, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 182, 182, 182, 182, 182, 182,
+        182, 182, 182, 182, 182, 182, 182, 182,
+        182, 182, 182, 182, 182, 182, 182, 182,
+        182, 182, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        183, 46, 46, 46, 46, 46, 46, 184,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        185, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 186, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 187, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 188, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 189, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 191, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 190, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65587, 111, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 192,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 193, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 194, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65568, 84, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 195,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 196,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 197, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 198, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 199, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 200, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 201, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 202, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 203,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65587, 106, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 204,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 205, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 206,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 207, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 208, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 209, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 210, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 211, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 212,
+        212, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65599, 121, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 164,
+        164, 213, 164, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 164, 0, 0,
+        0, 0, 0, 0, 0, 164, 213, 0,
+        0, 0, 164, 164, 164, 164, 164, 164,
+        164, 164, 164, 164, 164, 164, 164, 164,
+        164, 164, 164, 164, 164, 164, 164, 164,
+        164, 164, 0, 0, 0, 0, 1, 65599,
+        121, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 165, 165, 114,
+        165, 0, 0, 0, 0, 0, 0, 0,
+        0, 113, 0, 165, 0, 0, 0, 0,
+        0, 0, 0, 165, 114, 0, 0, 0,
+        165, 165, 165, 165, 165, 165, 165, 165,
+        165, 165, 165, 165, 165, 165, 165, 165,
+        165, 165, 165, 165, 165, 165, 165, 165,
+        0, 0, 0, 0, 1, 65599, 121, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 166, 166, 166, 166, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 166, 0, 0, 0, 0, 0, 0,
+        0, 166, 166, 0, 0, 0, 166, 166,
+        166, 166, 166, 166, 166, 166, 166, 166,
+        166, 166, 166, 166, 166, 166, 166, 166,
+        166, 166, 166, 166, 166, 166, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 167, 168, 168, 168, 168, 169, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        0, 0, 0, 0, 0, 0, 0, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 214,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 1, 65607,
+        25, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 168, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 215, 170, 170, 170, 170,
+        216, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 171, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 0, 0, 0, 0, 0, 0,
+        0, 168, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 215, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        0, 0, 0, 0, 0, 0, 0, 172,
+        172, 172, 0, 0, 0, 0, 0, 0,
+        217, 217, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 217, 217, 217, 217, 217, 217,
+        217, 217, 217, 217, 217, 217, 217, 217,
+        217, 217, 217, 217, 217, 217, 217, 217,
+        217, 217, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 173, 173, 173,
+        0, 0, 0, 218, 218, 218, 218, 218,
+        218, 0, 0, 0, 174, 0, 0, 0,
+        0, 0, 0, 218, 0, 0, 0, 0,
+        0, 0, 0, 218, 218, 0, 0, 0,
+        218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218,
+        0, 0, 0, 0, 1, 65588, 120, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 175, 175, 175, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        174, 0, 0, 0, 0, 0, 173, 0,
+        172, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 82,
+        82, 82, 82, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 82, 0, 0,
+        0, 0, 0, 0, 0, 82, 82, 0,
+        0, 0, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 82, 82, 82, 82, 82, 82,
+        82, 82, 0, 0, 0, 0, 1, 65595,
+        114, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 219, 219, 219,
+        219, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 219, 220, 0, 0, 0,
+        0, 0, 0, 219, 219, 0, 0, 0,
+        219, 219, 219, 219, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219,
+        0, 0, 0, 0, 1, 65559, 75, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 221, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 222, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        223, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 182, 182, 182, 182, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 182, 86, 0, 0, 0, 0, 0,
+        0, 182, 182, 0, 0, 0, 182, 182,
+        182, 182, 182, 182, 182, 182, 182, 182,
+        182, 182, 182, 182, 182, 182, 182, 182,
+        182, 182, 182, 182, 182, 182, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 224, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 225, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 226, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 227, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 228, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65587, 108, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 229,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 230, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65565, 81, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65567, 83, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 231, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65584, 98, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65577, 91, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 232, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 233, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 234, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 235, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 236, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65587,
+        112, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65576, 90, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65572, 100, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 237, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 238, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65582, 96, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 239, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 240, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 241,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 242, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 243, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65596, 117, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 212,
+        212, 212, 212, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 212, 111, 0,
+        0, 0, 0, 0, 0, 212, 212, 0,
+        0, 0, 212, 212, 212, 212, 212, 212,
+        212, 212, 212, 212, 212, 212, 212, 212,
+        212, 212, 212, 212, 212, 212, 212, 212,
+        212, 212, 0, 0, 0, 0, 1, 65599,
+        121, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 244, 244, 213,
+        244, 0, 0, 0, 0, 0, 0, 0,
+        166, 0, 0, 244, 0, 0, 0, 0,
+        0, 0, 0, 244, 213, 0, 0, 0,
+        244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 214, 168, 168, 168, 168,
+        169, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 0, 0, 0, 0, 0, 0,
+        0, 168, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 215, 170, 170, 170, 170, 169, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 171, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        1, 65598, 26, 0, 0, 0, 0, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 214,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 245, 245, 245,
+        245, 0, 0, 0, 0, 0, 245, 0,
+        0, 0, 0, 245, 0, 0, 0, 0,
+        0, 0, 0, 245, 245, 0, 0, 0,
+        245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 246, 246, 246, 0, 0,
+        0, 218, 218, 218, 218, 218, 218, 0,
+        0, 0, 174, 0, 0, 0, 0, 0,
+        0, 218, 0, 0, 0, 0, 0, 0,
+        0, 218, 218, 0, 0, 0, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 0, 0,
+        0, 0, 1, 65595, 114, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 219, 219, 219, 219, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 219,
+        128, 0, 0, 0, 0, 0, 0, 219,
+        219, 0, 0, 0, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219,
+        219, 219, 219, 219, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 247, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65560,
+        76, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        248, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 249, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 250, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 251,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65587, 107, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 252, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 253, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 254, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65564, 80, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 255, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 256, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65570,
+        86, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 257, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 258, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65571, 101, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 259, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        260, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65583, 97, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 261, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 262,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 263, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 264,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65599, 121, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 244,
+        244, 213, 244, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 244, 0, 0,
+        0, 0, 0, 0, 0, 244, 213, 0,
+        0, 0, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 265, 265, 265,
+        0, 0, 0, 0, 0, 245, 245, 245,
+        245, 0, 0, 0, 174, 0, 245, 0,
+        0, 0, 173, 245, 0, 0, 0, 0,
+        0, 0, 0, 245, 245, 0, 0, 0,
+        245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 246, 246, 246, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 174, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65595, 114, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 247, 247, 247, 247, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 247,
+        220, 0, 0, 0, 0, 0, 0, 247,
+        247, 0, 0, 0, 247, 247, 247, 247,
+        247, 247, 247, 247, 247, 247, 247, 247,
+        247, 247, 247, 247, 247, 247, 247, 247,
+        247, 247, 247, 247, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 266, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 267, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 268,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65562, 78, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 269, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 270,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65587, 113, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65587, 109, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 271, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65574,
+        88, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 272, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 273, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 274, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65585,
+        99, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 275, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 276, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 277,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 265, 265, 265,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 174, 0, 0, 0,
+        0, 0, 173, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 278, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65587, 105, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65561, 77, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65597,
+        118, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        279, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65587, 104, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 280, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 281, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65578,
+        92, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65597, 118, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 282, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65587, 102, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65587, 103, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65587,
+        110, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65580, 94, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65566, 82, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 283, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65575,
+        89, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0, 1, 65579, 93, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 46, 46, 46, 46, 0,
+        0, 0, 0, 0, 0, 0, 87, 0,
+        0, 46, 86, 0, 0, 0, 0, 0,
+        0, 46, 46, 0, 0, 0, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 0, 0,
+        0, 0, 1, 65597, 118, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 46, 46, 46, 46, 0, 0, 0,
+        0, 0, 0, 0, 87, 0, 0, 46,
+        86, 0, 0, 0, 0, 0, 0, 46,
+        46, 0, 0, 0, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        284, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 0, 0, 0, 0,
+        1, 65597, 118, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 46,
+        46, 46, 46, 0, 0, 0, 0, 0,
+        0, 0, 87, 0, 0, 46, 86, 0,
+        0, 0, 0, 0, 0, 46, 46, 0,
+        0, 0, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 285, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 0, 0, 0, 0, 1, 65581,
+        95, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 46, 46, 46,
+        46, 0, 0, 0, 0, 0, 0, 0,
+        87, 0, 0, 46, 86, 0, 0, 0,
+        0, 0, 0, 46, 46, 0, 0, 0,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        46, 46, 46, 46, 46, 46, 46, 46,
+        0, 0, 0, 0 };
+    static std::size_t const lookup1_[256] = {
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 7, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        7, 14, 14, 8, 14, 9, 14, 14,
+        14, 14, 14, 14, 14, 10, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 11, 12, 13, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14 };
+    static const std::size_t dfa1_[255] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 1,
+        65605, 6, 1, 0, 0, 0, 3, 4,
+        4, 4, 2, 4, 4, 4, 1, 65605,
+        7, 1, 0, 0, 0, 0, 0, 5,
+        0, 0, 0, 0, 0, 1, 65605, 6,
+        1, 0, 0, 0, 3, 4, 4, 4,
+        6, 4, 4, 4, 1, 65605, 6, 1,
+        0, 0, 0, 4, 4, 4, 4, 0,
+        4, 4, 4, 1, 65601, 5, 1, 0,
+        0, 0, 0, 7, 10, 9, 0, 8,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 11, 0, 0, 0, 0,
+        0, 1, 65609, 1, 1, 0, 0, 0,
+        12, 12, 13, 12, 12, 12, 12, 12,
+        1, 65606, 2, 1, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 1,
+        65603, 3, 1, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 65605,
+        4, 1, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 9,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 12, 12, 13, 12, 12,
+        12, 12, 12, 0, 0, 0, 0, 0,
+        0, 0, 14, 14, 13, 14, 14, 14,
+        15, 14, 0, 0, 0, 0, 0, 0,
+        0, 14, 14, 16, 14, 14, 14, 0,
+        14, 1, 65607, 0, 1, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 14,
+        14, 16, 14, 14, 14, 15, 14 };
+    static std::size_t const lookup2_[256] = {
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 7, 15, 8, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        9, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 12, 15, 15, 15, 15, 15,
+        15, 11, 11, 11, 11, 11, 11, 11,
+        11, 11, 11, 11, 11, 11, 11, 11,
+        11, 11, 11, 11, 11, 11, 11, 11,
+        11, 11, 11, 15, 15, 15, 15, 13,
+        15, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 14, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15 };
+    static const std::size_t dfa2_[208] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 3,
+        2, 4, 4, 4, 4, 4, 4, 4,
+        1, 65591, 13, 2, 0, 0, 0, 0,
+        0, 6, 7, 0, 8, 9, 5, 0,
+        1, 65590, 12, 2, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65591, 13, 2, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65592, 10, 2, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65595, 11, 2, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 65595, 11, 2, 0, 0, 0, 0,
+        0, 7, 7, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 10, 0, 0, 0,
+        1, 65595, 11, 2, 0, 0, 0, 0,
+        0, 9, 9, 9, 11, 9, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 9, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 12, 0, 0, 0,
+        1, 65595, 11, 2, 0, 0, 0, 0,
+        0, 12, 12, 12, 11, 12, 0, 0 };
+    static std::size_t const lookup3_[256] = {
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 7, 7, 7, 7, 7, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        7, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        8, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 11, 13, 13, 13, 13, 13,
+        13, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 13, 13, 13, 13, 12,
+        13, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13,
+        13, 13, 13, 13, 13, 13, 13, 13 };
+    static const std::size_t dfa3_[154] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 6, 2, 3,
+        7, 4, 5, 7, 1, 65595, 14, 3,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65595, 14, 3, 0, 0,
+        0, 0, 3, 3, 0, 0, 0, 0,
+        1, 65590, 16, 3, 0, 0, 0, 0,
+        0, 0, 0, 8, 0, 0, 1, 65595,
+        14, 3, 0, 0, 0, 0, 5, 5,
+        5, 9, 5, 0, 1, 65608, 15, 3,
+        0, 0, 0, 6, 0, 0, 0, 0,
+        0, 0, 1, 65590, 16, 3, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 5, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 10, 0, 0, 1, 65595, 14, 3,
+        0, 0, 0, 0, 10, 10, 10, 9,
+        10, 0 };
+    static std::size_t const lookup4_[256] = {
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 7, 7, 7, 7, 7, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        7, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 8, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 9, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 10, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6 };
+    static const std::size_t dfa4_[33] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 2, 2, 2, 1, 1,
+        17, 4, 0, 0, 0, 0, 0, 0,
+        0 };
+    static std::size_t const lookup5_[256] = {
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 7, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        8, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 11, 14, 14, 14, 14, 14,
+        14, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 10, 10, 10, 10, 10,
+        10, 10, 10, 14, 14, 14, 14, 12,
+        14, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 13, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14,
+        14, 14, 14, 14, 14, 14, 14, 14 };
+    static const std::size_t dfa5_[180] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 2, 3,
+        3, 3, 3, 3, 3, 3, 1, 65591,
+        20, 5, 0, 0, 0, 0, 5, 6,
+        0, 7, 8, 4, 0, 1, 65591, 20,
+        5, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 1, 65592, 18, 5,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 1, 65595, 19, 5, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 65595, 19, 5, 0, 0,
+        0, 0, 6, 6, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 9, 0, 0, 0,
+        1, 65595, 19, 5, 0, 0, 0, 0,
+        8, 8, 8, 10, 8, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 8, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 11, 0, 0, 0, 1, 65595, 19,
+        5, 0, 0, 0, 0, 11, 11, 11,
+        10, 11, 0, 0 };
+    static std::size_t const lookup6_[256] = {
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7 };
+    static const std::size_t dfa6_[24] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 2,
+        1, 65590, 21, 6, 0, 0, 0, 0 };
+    static std::size_t const lookup7_[256] = {
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 7, 9, 7, 7, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        7, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 6, 9, 9, 9, 9, 8,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9,
+        9, 9, 9, 9, 9, 9, 9, 9 };
+    static const std::size_t dfa7_[40] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 1, 2, 0, 0, 0, 0, 0,
+        0, 0, 0, 3, 3, 3, 1, 47,
+        22, 7, 0, 0, 0, 0, 0, 0 };
+    static std::size_t const lookup8_[256] = {
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 7, 7, 7, 7, 7, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        7, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 8,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6 };
+    static const std::size_t dfa8_[27] = {
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        1, 2, 1, 47, 23, 0, 0, 0,
+        0, 0, 0 };
+    static std::size_t const* lookup_arr_[9] = { lookup0_, lookup1_, lookup2_, lookup3_, lookup4_, lookup5_, lookup6_, lookup7_, lookup8_ };
+    static std::size_t const dfa_alphabet_arr_[9] = { 70, 15, 16, 14, 11, 15, 8, 10, 9 };
+    static std::size_t const* dfa_arr_[9] = { dfa0_, dfa1_, dfa2_, dfa3_, dfa4_, dfa5_, dfa6_, dfa7_, dfa8_ };
+
+    if (start_token_ == end_)
+    {
+        unique_id_ = npos;
+        return 0;
+    }
+
+again:
+    std::size_t const* lookup_ = lookup_arr_[start_state_];
+    std::size_t dfa_alphabet_ = dfa_alphabet_arr_[start_state_];
+    std::size_t const*dfa_ = dfa_arr_[start_state_];
+    std::size_t const* ptr_ = dfa_ + dfa_alphabet_;
+    Iterator curr_ = start_token_;
+    bool end_state_ = *ptr_ != 0;
+    std::size_t id_ = *(ptr_ + id_index);
+    std::size_t uid_ = *(ptr_ + unique_id_index);
+    std::size_t end_start_state_ = start_state_;
+    Iterator end_token_ = start_token_;
+
+    while (curr_ != end_)
+    {
+        std::size_t const state_ =
+            ptr_[lookup_[static_cast<unsigned char>(*curr_++)]];
+
+        if (state_ == 0) break;
+
+        ptr_ = &dfa_[state_ * dfa_alphabet_];
+
+        if (*ptr_)
+        {
+            end_state_ = true;
+            id_ = *(ptr_ + id_index);
+            uid_ = *(ptr_ + unique_id_index);
+            end_start_state_ = *(ptr_ + state_index);
+            end_token_ = curr_;
+        }
+    }
+
+    if (end_state_)
+    {
+        // return longest match
+        start_token_ = end_token_;
+        start_state_ = end_start_state_;
+        if (id_ == 0)
+        {
+            goto again;
+        }
+    }
+    else
+    {
+        id_ = npos;
+        uid_ = npos;
+    }
+
+    unique_id_ = uid_;
+    return id_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// this defines a generic accessors for the information above
+struct lexer
+{
+    // version number and feature-set of compatible static lexer engine
+    enum
+    {
+        static_version = 65536,
+        supports_bol = false,
+        supports_eol = false
+    };
+
+    // return the number of lexer states
+    static std::size_t state_count()
+    {
+        return lexer_state_count; 
+    }
+
+    // return the name of the lexer state as given by 'idx'
+    static char const* state_name(std::size_t idx)
+    {
+        return lexer_state_names[idx]; 
+    }
+
+    // return the next matched token
+    template<typename Iterator>
+    static std::size_t next(std::size_t &start_state_, bool& bol_
+      , Iterator &start_token_, Iterator const& end_, std::size_t& unique_id_)
+    {
+        return next_token(start_state_, bol_, start_token_, end_, unique_id_);
+    }
+};
+
+}}}}}  // namespace boost::spirit::lex::lexertl::static_
+
+#endif
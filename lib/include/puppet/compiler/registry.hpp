@@ -11,6 +11,8 @@
 #include <boost/optional.hpp>
 #include <memory>
 #include <vector>
+#include <deque>
+#include <shared_mutex>
 #include <unordered_map>
 
 namespace puppet { namespace compiler {
@@ -131,6 +133,7 @@ namespace puppet { namespace compiler {
 
     /**
      * Represents the compiler registry.
+     * The registry is safe to use from multiple threads; pointers to registered definitions remain valid as new definitions are registered.
      */
     struct registry
     {
@@ -139,17 +142,6 @@ namespace puppet { namespace compiler {
          */
         registry() = default;
 
-        /**
-         * Default move constructor for registry.
-         */
-        registry(registry&&) = default;
-
-        /**
-         * Default move assignment operator for registry.
-         * @return Returns this registry.
-         */
-        registry& operator=(registry&&) = default;
-
         /**
          * Finds a class given the qualified name.
          * @param name The fully-qualified name of the class (e.g. foo::bar).
@@ -227,9 +219,12 @@ namespace puppet { namespace compiler {
         registry(registry&) = delete;
         registry& operator=(registry&) = delete;
 
+        node_definition const* find_node_definition(ast::node_statement const& statement) const;
+
+        mutable std::shared_timed_mutex _mutex;
         std::unordered_map<std::string, klass> _classes;
         std::unordered_map<std::string, defined_type> _defined_types;
-        std::vector<node_definition> _nodes;
+        std::deque<node_definition> _nodes;
         std::unordered_map<std::string, size_t> _named_nodes;
         std::vector<std::pair<runtime::values::regex, size_t>> _regex_nodes;
         boost::optional<size_t> _default_node_index;
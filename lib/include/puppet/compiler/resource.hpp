@@ -5,6 +5,7 @@
 #pragma once
 
 #include "attribute.hpp"
+#include <boost/functional/hash.hpp>
 #include <string>
 #include <memory>
 #include <functional>
@@ -23,6 +24,9 @@ namespace puppet { namespace compiler {
     // Forward declaration of catalog.
     struct catalog;
 
+    // Forward declaration of resource index.
+    struct resource_index;
+
     /**
      * Utility class for tag_set.
      */
@@ -144,10 +148,13 @@ namespace puppet { namespace compiler {
 
      private:
         friend struct catalog;
+        friend struct resource_index;
 
         resource(runtime::types::resource type, resource const* container, std::shared_ptr<evaluation::scope> scope, boost::optional<ast::context> context, bool exported);
-        runtime::values::json_value to_json(runtime::values::json_allocator& allocator, compiler::catalog const& catalog) const;
-        void add_relationship_parameters(runtime::values::json_value& parameters, runtime::values::json_allocator& allocator, compiler::catalog const& catalog) const;
+        template <typename Writer>
+        void write(Writer& writer, compiler::catalog const& catalog) const;
+        template <typename Writer>
+        static void write_reference(Writer& writer, runtime::types::resource const& type);
         void realize(size_t vertex_id);
         size_t vertex_id() const;
         void populate_tags(tag_set& tags) const;
@@ -158,9 +165,11 @@ namespace puppet { namespace compiler {
         std::shared_ptr<evaluation::scope> _scope;
         boost::optional<ast::context> _context;
         size_t _vertex_id;
-        std::unordered_map<std::string, std::shared_ptr<attribute>> _attributes;
+        std::unordered_map<symbol, std::shared_ptr<attribute>, boost::hash<symbol>> _attributes;
         std::vector<std::string> _tags;
         bool _exported;
+        resource_index* _index;
+        size_t _position;
     };
 
 }}  // namespace puppet::compiler
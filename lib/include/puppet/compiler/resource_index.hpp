@@ -0,0 +1,127 @@
+/**
+ * @file
+ * Declares the catalog resource index.
+ */
+#pragma once
+
+#include "../runtime/values/value.hpp"
+#include <boost/functional/hash.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace puppet { namespace compiler {
+
+    // Forward declaration of resource.
+    struct resource;
+
+    /**
+     * Represents an inverted index of resource titles and attribute values.
+     * Resource types are only indexed on demand; once a type is indexed, the index is kept up to date as resources are added and their attributes are set.
+     * Resources are identified by their position within the catalog's list of resources of the same type.
+     * The index is conservative: a lookup may return resources that no longer match, but never omits a resource whose explicitly set attribute matches.
+     */
+    struct resource_index
+    {
+        /**
+         * The set of resource positions returned by a lookup.
+         */
+        using position_set = std::unordered_set<size_t>;
+
+        /**
+         * Determines if the given resource type has been indexed.
+         * @param type The resource type name.
+         * @return Returns true if the resource type is indexed or false if not.
+         */
+        bool indexed(std::string const& type) const;
+
+        /**
+         * Indexes the given resource type.
+         * @param type The resource type name.
+         * @param resources The resources of the given type, in catalog order.
+         */
+        void index(std::string const& type, std::vector<resource*> const& resources);
+
+        /**
+         * Adds a resource to the index.
+         * The resource is ignored if its type has not been indexed.
+         * @param resource The resource to add.
+         */
+        void add(compiler::resource& resource);
+
+        /**
+         * Adds an attribute value to the index.
+         * @param resource The resource with the attribute.
+         * @param name The attribute name.
+         * @param value The attribute value.
+         */
+        void insert(compiler::resource const& resource, std::string const& name, runtime::values::value const& value);
+
+        /**
+         * Removes an attribute value from the index.
+         * @param resource The resource with the attribute.
+         * @param name The attribute name.
+         * @param value The attribute value.
+         */
+        void remove(compiler::resource const& resource, std::string const& name, runtime::values::value const& value);
+
+        /**
+         * Records that a resource default exists for the given resource type and attribute.
+         * Defaults are resolved through a resource's scope, so lookups of defaulted attributes cannot be answered by the index.
+         * @param type The resource type name.
+         * @param name The attribute name.
+         */
+        void add_default(std::string const& type, std::string const& name);
+
+        /**
+         * Determines if a resource default exists for the given resource type and attribute.
+         * @param type The resource type name.
+         * @param name The attribute name.
+         * @return Returns true if a default may apply to the attribute or false if not.
+         */
+        bool defaulted(std::string const& type, std::string const& name) const;
+
+        /**
+         * Finds the positions of resources with the given title.
+         * @param type The resource type name.
+         * @param title The title to find.
+         * @return Returns the set of resource positions or nullptr if no resources have the title.
+         */
+        position_set const* find_title(std::string const& type, runtime::values::value const& title) const;
+
+        /**
+         * Finds the positions of resources with an attribute equal to, or an array attribute containing, the given value.
+         * @param type The resource type name.
+         * @param name The attribute name.
+         * @param value The value to find.
+         * @return Returns the set of resource positions or nullptr if no resources have the value.
+         */
+        position_set const* find(std::string const& type, std::string const& name, runtime::values::value const& value) const;
+
+        /**
+         * Gets the indexed resources of the given type, in catalog order.
+         * @param type The resource type name.
+         * @return Returns the indexed resources of the given type.
+         */
+        std::vector<resource*> const& resources(std::string const& type) const;
+
+     private:
+        using value_map = std::unordered_map<runtime::values::value, position_set, boost::hash<runtime::values::value>>;
+
+        struct type_index
+        {
+            std::vector<resource*> resources;
+            value_map titles;
+            std::unordered_map<std::string, value_map> attributes;
+        };
+
+        type_index* find_type(std::string const& type);
+        type_index const* find_type(std::string const& type) const;
+        static position_set const* find(value_map const& map, runtime::values::value const& value);
+
+        std::unordered_map<std::string, type_index> _types;
+        std::unordered_map<std::string, std::unordered_set<std::string>> _defaults;
+    };
+
+}}  // namespace puppet::compiler
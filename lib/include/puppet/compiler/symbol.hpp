@@ -0,0 +1,98 @@
+/**
+ * @file
+ * Declares the interned symbol type.
+ */
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <ostream>
+
+namespace puppet { namespace compiler {
+
+    /**
+     * Represents an interned name.
+     * Symbols with the same name share a single, process-wide entry, so symbols compare in constant time and hash without rehashing the name.
+     * Interning is safe from multiple threads; entries are never removed, so each thread caches the entries it has looked up and repeated lookups do not lock.
+     */
+    struct symbol
+    {
+        /**
+         * Constructs an empty symbol.
+         */
+        symbol();
+
+        /**
+         * Constructs a symbol by interning the given name.
+         * @param name The name to intern.
+         */
+        explicit symbol(std::string const& name);
+
+        /**
+         * Finds the symbol for the given name without interning it.
+         * @param name The name to find.
+         * @return Returns the symbol for the name or an empty symbol if the name has never been interned.
+         */
+        static symbol find(std::string const& name);
+
+        /**
+         * Gets the name of the symbol.
+         * @return Returns the name of the symbol or an empty string if the symbol is empty.
+         */
+        std::string const& name() const;
+
+        /**
+         * Gets the hash of the symbol's name.
+         * @return Returns the hash of the symbol's name.
+         */
+        size_t hash() const;
+
+        /**
+         * Determines if the symbol is not empty.
+         * @return Returns true if the symbol is not empty or false if it is empty.
+         */
+        explicit operator bool() const;
+
+     private:
+        struct entry;
+        struct table;
+        static table& instance();
+        explicit symbol(entry const* entry);
+
+        entry const* _entry;
+
+        friend bool operator==(symbol const& left, symbol const& right);
+    };
+
+    /**
+     * Equality operator for symbol.
+     * @param left The left operand.
+     * @param right The right operand.
+     * @return Returns true if the two symbols are equal or false if not.
+     */
+    bool operator==(symbol const& left, symbol const& right);
+
+    /**
+     * Inequality operator for symbol.
+     * @param left The left operand.
+     * @param right The right operand.
+     * @return Returns true if the two symbols are not equal or false if they are equal.
+     */
+    bool operator!=(symbol const& left, symbol const& right);
+
+    /**
+     * Hashes the symbol.
+     * @param symbol The symbol to hash.
+     * @return Returns the hash value for the symbol.
+     */
+    size_t hash_value(compiler::symbol const& symbol);
+
+    /**
+     * Stream insertion operator for symbol.
+     * @param os The output stream to write to.
+     * @param symbol The symbol to write.
+     * @return Returns the given output stream.
+     */
+    std::ostream& operator<<(std::ostream& os, compiler::symbol const& symbol);
+
+}}  // namespace puppet::compiler
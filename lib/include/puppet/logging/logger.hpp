@@ -9,6 +9,7 @@
 #include <string>
 #include <iostream>
 #include <functional>
+#include <mutex>
 
 namespace puppet { namespace logging {
 
@@ -71,6 +72,7 @@ namespace puppet { namespace logging {
 
     /**
      * Implements the base logger.
+     * Logging is serialized so that a logger may be shared between threads.
      */
     struct logger
     {
@@ -215,6 +217,9 @@ namespace puppet { namespace logging {
          * Stores the minimum logging level.
          */
         logging::level _level;
+
+     private:
+        std::mutex _mutex;
     };
 
     /**
@@ -7,6 +7,8 @@
 #include "parse.hpp"
 #include "../../facts/provider.hpp"
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace puppet { namespace options { namespace commands {
 
@@ -78,6 +80,49 @@ namespace puppet { namespace options { namespace commands {
          */
         std::string get_graph_file(boost::program_options::variables_map const& options) const;
 
+        /**
+         * Creates an executor that compiles a batch of nodes with a shared environment.
+         * @param options The parsed options.
+         * @return Returns the command executor.
+         */
+        executor create_batch_executor(boost::program_options::variables_map const& options) const;
+
+        /**
+         * Gets the batch node names from the given parsed options.
+         * @param options The parsed options.
+         * @return Returns the node names to compile.
+         */
+        std::vector<std::string> get_nodes(boost::program_options::variables_map const& options) const;
+
+        /**
+         * Gets the batch facts directory from the given parsed options.
+         * @param options The parsed options.
+         * @return Returns the facts directory.
+         */
+        std::string get_facts_directory(boost::program_options::variables_map const& options) const;
+
+        /**
+         * Gets the batch output directory from the given parsed options.
+         * @param options The parsed options.
+         * @return Returns the output directory or an empty string if catalogs should be streamed to the output file.
+         */
+        std::string get_output_directory(boost::program_options::variables_map const& options) const;
+
+        /**
+         * Gets the number of concurrent compilation jobs from the given parsed options.
+         * @param options The parsed options.
+         * @return Returns the number of jobs; zero means the number of hardware threads.
+         */
+        size_t get_jobs(boost::program_options::variables_map const& options) const;
+
+        /**
+         * The cycle limit option name.
+         */
+        static char const* const CYCLE_LIMIT_OPTION;
+        /**
+         * The cycle limit option description.
+         */
+        static char const* const CYCLE_LIMIT_DESCRIPTION;
         /**
          * The facts option name.
          */
@@ -90,6 +135,14 @@ namespace puppet { namespace options { namespace commands {
          * The facts option description.
          */
         static char const* const FACTS_DESCRIPTION;
+        /**
+         * The facts directory option name.
+         */
+        static char const* const FACTS_DIRECTORY_OPTION;
+        /**
+         * The facts directory option description.
+         */
+        static char const* const FACTS_DIRECTORY_DESCRIPTION;
         /**
          * The graph file option name.
          */
@@ -102,6 +155,18 @@ namespace puppet { namespace options { namespace commands {
          * The graph file option description.
          */
         static char const* const GRAPH_FILE_DESCRIPTION;
+        /**
+         * The jobs option name.
+         */
+        static char const* const JOBS_OPTION;
+        /**
+         * The jobs option full name.
+         */
+        static char const* const JOBS_OPTION_FULL;
+        /**
+         * The jobs option description.
+         */
+        static char const* const JOBS_DESCRIPTION;
         /**
          * The node option name.
          */
@@ -114,10 +179,26 @@ namespace puppet { namespace options { namespace commands {
          * The node option description.
          */
         static char const* const NODE_DESCRIPTION;
+        /**
+         * The nodes option name.
+         */
+        static char const* const NODES_OPTION;
+        /**
+         * The nodes option description.
+         */
+        static char const* const NODES_DESCRIPTION;
         /**
          * The output option description.
          */
         static char const* const OUTPUT_DESCRIPTION;
+        /**
+         * The output directory option name.
+         */
+        static char const* const OUTPUT_DIRECTORY_OPTION;
+        /**
+         * The output directory option description.
+         */
+        static char const* const OUTPUT_DIRECTORY_DESCRIPTION;
         /**
          * The trace option name.
          */
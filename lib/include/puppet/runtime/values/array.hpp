@@ -8,17 +8,456 @@
 #include <ostream>
 #include <vector>
 #include <memory>
+#include <initializer_list>
 
 namespace puppet { namespace runtime { namespace values {
 
     /**
      * Represents a runtime array value.
+     * Arrays are implicitly shared: copying an array is O(1) and the elements are copied only when a shared array is first modified.
+     * As a result, mutable iterators and references obtained from an array should not be used after the array has been copied.
      */
-    struct array : std::vector<wrapper<value>>
+    struct array
     {
-        // Use the base constructor and assignment semantics
-        using vector::vector;
-        using vector::operator=;
+        /**
+         * The underlying vector type.
+         */
+        using vector_type = std::vector<wrapper<value>>;
+
+        /**
+         * The element type of the array.
+         */
+        using value_type = vector_type::value_type;
+
+        /**
+         * The size type of the array.
+         */
+        using size_type = vector_type::size_type;
+
+        /**
+         * The difference type of the array.
+         */
+        using difference_type = vector_type::difference_type;
+
+        /**
+         * The reference type of the array.
+         */
+        using reference = vector_type::reference;
+
+        /**
+         * The const reference type of the array.
+         */
+        using const_reference = vector_type::const_reference;
+
+        /**
+         * The iterator type of the array.
+         */
+        using iterator = vector_type::iterator;
+
+        /**
+         * The const iterator type of the array.
+         */
+        using const_iterator = vector_type::const_iterator;
+
+        /**
+         * The reverse iterator type of the array.
+         */
+        using reverse_iterator = vector_type::reverse_iterator;
+
+        /**
+         * The const reverse iterator type of the array.
+         */
+        using const_reverse_iterator = vector_type::const_reverse_iterator;
+
+        /**
+         * Constructs an empty array.
+         */
+        array() = default;
+
+        /**
+         * Constructs an array with the given number of undef elements.
+         * @param count The number of elements in the array.
+         */
+        explicit array(size_type count);
+
+        /**
+         * Constructs an array from an initializer list.
+         * @param elements The elements of the array.
+         */
+        array(std::initializer_list<value_type> elements);
+
+        /**
+         * Constructs an array from a range of elements.
+         * @tparam InputIterator The input iterator type.
+         * @param first The first element to copy.
+         * @param last The end of the range to copy.
+         */
+        template <
+            typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type
+        >
+        array(InputIterator first, InputIterator last) :
+            _elements(std::make_shared<vector_type>(first, last))
+        {
+        }
+
+        /**
+         * Copy constructs an array; the elements are shared until either array is modified.
+         * @param other The array to copy.
+         */
+        array(array const& other) = default;
+
+        /**
+         * Move constructs an array.
+         * @param other The array to move.
+         */
+        array(array&& other) noexcept = default;
+
+        /**
+         * Copy assigns an array; the elements are shared until either array is modified.
+         * @param other The array to copy.
+         * @return Returns this array.
+         */
+        array& operator=(array const& other) = default;
+
+        /**
+         * Move assigns an array.
+         * @param other The array to move.
+         * @return Returns this array.
+         */
+        array& operator=(array&& other) noexcept = default;
+
+        /**
+         * Gets an iterator to the first element, unsharing the elements if necessary.
+         * @return Returns an iterator to the first element.
+         */
+        iterator begin()
+        {
+            return mutate().begin();
+        }
+
+        /**
+         * Gets an iterator to the first element.
+         * @return Returns an iterator to the first element.
+         */
+        const_iterator begin() const
+        {
+            return elements().begin();
+        }
+
+        /**
+         * Gets an iterator past the last element, unsharing the elements if necessary.
+         * @return Returns an iterator past the last element.
+         */
+        iterator end()
+        {
+            return mutate().end();
+        }
+
+        /**
+         * Gets an iterator past the last element.
+         * @return Returns an iterator past the last element.
+         */
+        const_iterator end() const
+        {
+            return elements().end();
+        }
+
+        /**
+         * Gets an iterator to the first element.
+         * @return Returns an iterator to the first element.
+         */
+        const_iterator cbegin() const
+        {
+            return elements().cbegin();
+        }
+
+        /**
+         * Gets an iterator past the last element.
+         * @return Returns an iterator past the last element.
+         */
+        const_iterator cend() const
+        {
+            return elements().cend();
+        }
+
+        /**
+         * Gets a reverse iterator to the last element, unsharing the elements if necessary.
+         * @return Returns a reverse iterator to the last element.
+         */
+        reverse_iterator rbegin()
+        {
+            return mutate().rbegin();
+        }
+
+        /**
+         * Gets a reverse iterator to the last element.
+         * @return Returns a reverse iterator to the last element.
+         */
+        const_reverse_iterator rbegin() const
+        {
+            return elements().rbegin();
+        }
+
+        /**
+         * Gets a reverse iterator before the first element, unsharing the elements if necessary.
+         * @return Returns a reverse iterator before the first element.
+         */
+        reverse_iterator rend()
+        {
+            return mutate().rend();
+        }
+
+        /**
+         * Gets a reverse iterator before the first element.
+         * @return Returns a reverse iterator before the first element.
+         */
+        const_reverse_iterator rend() const
+        {
+            return elements().rend();
+        }
+
+        /**
+         * Gets a reverse iterator to the last element.
+         * @return Returns a reverse iterator to the last element.
+         */
+        const_reverse_iterator crbegin() const
+        {
+            return elements().crbegin();
+        }
+
+        /**
+         * Gets a reverse iterator before the first element.
+         * @return Returns a reverse iterator before the first element.
+         */
+        const_reverse_iterator crend() const
+        {
+            return elements().crend();
+        }
+
+        /**
+         * Gets the number of elements in the array.
+         * @return Returns the number of elements in the array.
+         */
+        size_type size() const
+        {
+            return elements().size();
+        }
+
+        /**
+         * Determines if the array is empty.
+         * @return Returns true if the array is empty or false if not.
+         */
+        bool empty() const
+        {
+            return elements().empty();
+        }
+
+        /**
+         * Reserves space for the given number of elements.
+         * @param count The number of elements to reserve space for.
+         */
+        void reserve(size_type count)
+        {
+            mutate().reserve(count);
+        }
+
+        /**
+         * Resizes the array, adding undef elements if the array grows.
+         * @param count The new size of the array.
+         */
+        void resize(size_type count)
+        {
+            mutate().resize(count);
+        }
+
+        /**
+         * Removes all elements from the array.
+         */
+        void clear()
+        {
+            _elements.reset();
+        }
+
+        /**
+         * Gets the element at the given index, unsharing the elements if necessary.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        reference operator[](size_type index)
+        {
+            return mutate()[index];
+        }
+
+        /**
+         * Gets the element at the given index.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        const_reference operator[](size_type index) const
+        {
+            return elements()[index];
+        }
+
+        /**
+         * Gets the element at the given index with bounds checking, unsharing the elements if necessary.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        reference at(size_type index)
+        {
+            return mutate().at(index);
+        }
+
+        /**
+         * Gets the element at the given index with bounds checking.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        const_reference at(size_type index) const
+        {
+            return elements().at(index);
+        }
+
+        /**
+         * Gets the first element, unsharing the elements if necessary.
+         * @return Returns the first element.
+         */
+        reference front()
+        {
+            return mutate().front();
+        }
+
+        /**
+         * Gets the first element.
+         * @return Returns the first element.
+         */
+        const_reference front() const
+        {
+            return elements().front();
+        }
+
+        /**
+         * Gets the last element, unsharing the elements if necessary.
+         * @return Returns the last element.
+         */
+        reference back()
+        {
+            return mutate().back();
+        }
+
+        /**
+         * Gets the last element.
+         * @return Returns the last element.
+         */
+        const_reference back() const
+        {
+            return elements().back();
+        }
+
+        /**
+         * Appends a copy of an element to the array.
+         * @param element The element to append.
+         */
+        void push_back(value_type const& element)
+        {
+            mutate().push_back(element);
+        }
+
+        /**
+         * Appends an element to the array.
+         * @param element The element to append.
+         */
+        void push_back(value_type&& element)
+        {
+            mutate().push_back(rvalue_cast(element));
+        }
+
+        /**
+         * Constructs an element at the end of the array.
+         * @tparam Args The types of the constructor arguments.
+         * @param args The constructor arguments.
+         * @return Returns the new element.
+         */
+        template <typename... Args>
+        reference emplace_back(Args&&... args)
+        {
+            auto& elements = mutate();
+            elements.emplace_back(std::forward<Args>(args)...);
+            return elements.back();
+        }
+
+        /**
+         * Removes the last element of the array.
+         */
+        void pop_back()
+        {
+            mutate().pop_back();
+        }
+
+        /**
+         * Inserts an element into the array.
+         * @param position The position to insert before.
+         * @param element The element to insert.
+         * @return Returns an iterator to the inserted element.
+         */
+        iterator insert(const_iterator position, value_type element)
+        {
+            auto index = position - cbegin();
+            auto& elements = mutate();
+            return elements.insert(elements.begin() + index, rvalue_cast(element));
+        }
+
+        /**
+         * Inserts a range of elements into the array.
+         * @tparam InputIterator The input iterator type.
+         * @param position The position to insert before.
+         * @param first The first element to insert.
+         * @param last The end of the range to insert.
+         * @return Returns an iterator to the first inserted element.
+         */
+        template <typename InputIterator>
+        iterator insert(const_iterator position, InputIterator first, InputIterator last)
+        {
+            auto index = position - cbegin();
+            auto& elements = mutate();
+            return elements.insert(elements.begin() + index, first, last);
+        }
+
+        /**
+         * Erases an element from the array.
+         * @param position The element to erase.
+         * @return Returns an iterator to the element following the erased element.
+         */
+        iterator erase(const_iterator position)
+        {
+            auto index = position - cbegin();
+            auto& elements = mutate();
+            return elements.erase(elements.begin() + index);
+        }
+
+        /**
+         * Erases a range of elements from the array.
+         * @param first The first element to erase.
+         * @param last The end of the range to erase.
+         * @return Returns an iterator to the element following the erased elements.
+         */
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            auto index = first - cbegin();
+            auto count = last - first;
+            auto& elements = mutate();
+            return elements.erase(elements.begin() + index, elements.begin() + index + count);
+        }
+
+        /**
+         * Swaps the contents of this array with another.
+         * @param other The array to swap with.
+         */
+        void swap(array& other) noexcept
+        {
+            _elements.swap(other._elements);
+        }
 
         /**
          * Joins the array by converting each element to a string.
@@ -26,6 +465,25 @@ namespace puppet { namespace runtime { namespace values {
          * @param separator The separator to write between array elements.
          */
         void join(std::ostream& os, std::string const& separator = " ") const;
+
+     private:
+        vector_type const& elements() const
+        {
+            return _elements ? *_elements : empty_elements();
+        }
+
+        vector_type& mutate()
+        {
+            if (!_elements || _elements.use_count() > 1) {
+                unshare();
+            }
+            return *_elements;
+        }
+
+        void unshare();
+        static vector_type const& empty_elements();
+
+        std::shared_ptr<vector_type> _elements;
     };
 
     /**
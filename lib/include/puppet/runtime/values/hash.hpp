@@ -10,6 +10,7 @@
 #include <ostream>
 #include <functional>
 #include <list>
+#include <memory>
 #include <unordered_map>
 
 namespace puppet { namespace runtime { namespace values {
@@ -17,6 +18,8 @@ namespace puppet { namespace runtime { namespace values {
     /**
      * Represents a runtime hash value.
      * This models a Ruby hash in that it maintains insertion order but provides an O(1) lookup.
+     * Hashes are implicitly shared: copying a hash is O(1) and the elements are copied only when a shared hash is first modified.
+     * As a result, mutable iterators and value pointers obtained from a hash should not be used after the hash has been copied.
      */
     struct hash
     {
@@ -88,10 +91,10 @@ namespace puppet { namespace runtime { namespace values {
         hash() = default;
 
         /**
-         * Copy constructor for hash.
+         * Copy constructor for hash; the elements are shared until either hash is modified.
          * @param other The other hash to copy.
          */
-        hash(hash const& other);
+        hash(hash const& other) = default;
 
         /**
          * Move constructor for hash.
@@ -99,11 +102,11 @@ namespace puppet { namespace runtime { namespace values {
         hash(hash&&) noexcept = default;
 
         /**
-         * Copy assignment operator for hash.
+         * Copy assignment operator for hash; the elements are shared until either hash is modified.
          * @param other The other hash to copy.
          * @return Returns this hash.
          */
-        hash& operator=(hash const& other);
+        hash& operator=(hash const& other) = default;
 
         /**
          * Move assignment operator for hash.
@@ -112,7 +115,7 @@ namespace puppet { namespace runtime { namespace values {
         hash& operator=(hash&&) noexcept = default;
 
         /**
-         * Gets an iterator to the beginning.
+         * Gets an iterator to the beginning, unsharing the elements if necessary.
          * @return Returns an iterator to the beginning.
          */
         iterator begin();
@@ -124,7 +127,7 @@ namespace puppet { namespace runtime { namespace values {
         const_iterator begin() const;
 
         /**
-         * Gets an iterator to the end.
+         * Gets an iterator to the end, unsharing the elements if necessary.
          * @return Returns an iterator to the end.
          */
         iterator end();
@@ -148,7 +151,7 @@ namespace puppet { namespace runtime { namespace values {
         const_iterator cend() const;
 
         /**
-         * Gets a reverse iterator to the beginning.
+         * Gets a reverse iterator to the beginning, unsharing the elements if necessary.
          * @return Returns a reverse iterator to the beginning.
          */
         reverse_iterator rbegin();
@@ -160,7 +163,7 @@ namespace puppet { namespace runtime { namespace values {
         const_reverse_iterator rbegin() const;
 
         /**
-         * Gets a reverse iterator to the end.
+         * Gets a reverse iterator to the end, unsharing the elements if necessary.
          * @return Returns a reverse iterator to the end.
          */
         reverse_iterator rend();
@@ -211,7 +214,7 @@ namespace puppet { namespace runtime { namespace values {
         void set(const_iterator begin, const_iterator end);
 
         /**
-         * Gets a value from the hash.
+         * Gets a value from the hash, unsharing the elements if necessary.
          * @param key The key of the element to get the value for.
          * @return Returns a pointer to the value if the key is in the hash or nullptr if the key is not in the hash.
          */
@@ -232,8 +235,20 @@ namespace puppet { namespace runtime { namespace values {
         bool erase(value const& key);
 
      private:
-        sequence_type _elements;
-        utility::indirect_map<value, iterator> _index;
+        struct storage
+        {
+            storage() = default;
+            storage(storage const& other);
+            storage& operator=(storage const&) = delete;
+
+            sequence_type elements;
+            utility::indirect_map<value, iterator> index;
+        };
+
+        storage const& data() const;
+        storage& mutate();
+
+        std::shared_ptr<storage> _storage;
     };
 
     /**
@@ -38,6 +38,12 @@ namespace puppet { namespace runtime { namespace values {
          */
         using callback_type = std::function<bool(values::value const*, values::value const&)>;
 
+        /**
+         * The stage type for lazy iterators.
+         * Given the callback for the transformed elements, a stage returns the callback to invoke for each element of the underlying value.
+         */
+        using stage_type = std::function<callback_type(callback_type const&)>;
+
         /**
          * Constructs an iterator based off an iterable value.
          * @param value The value being iterated.
@@ -46,13 +52,27 @@ namespace puppet { namespace runtime { namespace values {
          */
         explicit iterator(wrapper<values::value> value, int64_t step = 1, bool reverse = false);
 
+        /**
+         * Constructs a lazy iterator that transforms the elements of an iterable value as they are iterated.
+         * @param value The value being iterated.
+         * @param stage The stage that transforms the elements of the value.
+         * @param keyed True if the stage produces key-value pairs or false if it produces only values.
+         */
+        iterator(wrapper<values::value> value, stage_type stage, bool keyed);
+
         /**
          * Gets the underlying iterable value.
-         * This never returns an iterator, only an underlying value.
+         * This never returns an iterator, only an underlying value; for lazy iterators, this is the value before any transformation.
          * @return Returns the underlying iterable value.
          */
         values::value const& value() const;
 
+        /**
+         * Determines if the iterator produces key-value pairs (i.e. iterates a hash).
+         * @return Returns true if the iterator produces key-value pairs or false if it produces only values.
+         */
+        bool keyed() const;
+
         /**
          * Infers the type for the produced values of the iterator.
          * For example, Integer produces Integer, String produces String, Array[T] produces T, etc.
@@ -83,6 +103,8 @@ namespace puppet { namespace runtime { namespace values {
         wrapper<values::value> _value;
         int64_t _step;
         bool _reverse;
+        stage_type _stage;
+        bool _keyed;
     };
 
     /**
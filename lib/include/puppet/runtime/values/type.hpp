@@ -328,6 +328,14 @@ namespace puppet { namespace runtime { namespace values {
          */
         static boost::optional<type> parse(std::string const& expression, compiler::evaluation::context* context = nullptr);
 
+        /**
+         * Parses a type from a Puppet type expression that does not depend on an evaluation context.
+         * Results are cached for the lifetime of the process, so this is intended for the fixed type expressions of built-in functions and operators.
+         * @param expression The expression to parse for the type.
+         * @return Returns the type if the parse was successful or boost::none if the string is not a valid type expression.
+         */
+        static boost::optional<type> parse_cached(std::string const& expression);
+
         /**
          * Creates a type from a Puppet type expression.
          * @tparam T The expected Puppet type.
@@ -28,11 +28,18 @@
 // Forward declare needed RapidJSON types.
 namespace rapidjson {
     class CrtAllocator;
-    template <typename Encoding, typename Allocator> class GenericValue;
-    template <typename Encoding, typename Allocator, typename StackAllocator> class GenericDocument;
     template<typename CharType> struct UTF8;
+    template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator> class Writer;
+    template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator> class PrettyWriter;
 }
 
+namespace puppet { namespace utility {
+
+    // Forward declare the output buffer.
+    struct output_buffer;
+
+}}  // namespace puppet::utility
+
 namespace puppet { namespace compiler { namespace evaluation {
 
     // Forward declare the evaluation context.
@@ -47,13 +54,13 @@ namespace puppet { namespace runtime { namespace values {
      */
     using json_allocator = rapidjson::CrtAllocator;
     /**
-     * The RapidJSON value.
+     * The RapidJSON writer for compact JSON output.
      */
-    using json_value = rapidjson::GenericValue<rapidjson::UTF8<char>, json_allocator>;
+    using json_writer = rapidjson::Writer<utility::output_buffer, rapidjson::UTF8<char>, rapidjson::UTF8<char>, json_allocator>;
     /**
-     * The RapidJSON document.
+     * The RapidJSON writer for pretty printed JSON output.
      */
-    using json_document = rapidjson::GenericDocument<rapidjson::UTF8<char>, json_allocator, json_allocator>;
+    using json_pretty_writer = rapidjson::PrettyWriter<utility::output_buffer, rapidjson::UTF8<char>, rapidjson::UTF8<char>, json_allocator>;
 
     /**
      * Represents all possible value types.
@@ -347,11 +354,16 @@ namespace puppet { namespace runtime { namespace values {
         void each_resource(std::function<void(runtime::types::resource const&)> const& callback, std::function<void(std::string const&)> const& error) const;
 
         /**
-         * Creates a RapidJSON value for the value.
-         * @param allocator The current RapidJSON allocator.
-         * @return Returns the runtime value as a RapidJSON value.
+         * Writes the value as JSON.
+         * @param writer The compact JSON writer to write to.
+         */
+        void write(json_writer& writer) const;
+
+        /**
+         * Writes the value as JSON.
+         * @param writer The pretty JSON writer to write to.
          */
-        json_value to_json(json_allocator& allocator) const;
+        void write(json_pretty_writer& writer) const;
 
         /**
          * Called to apply a visitor to the value.
@@ -7,6 +7,7 @@
 #include "forward.hpp"
 #include <ostream>
 #include <memory>
+#include <limits>
 
 namespace puppet { namespace runtime { namespace values {
 
@@ -19,8 +20,14 @@ namespace puppet { namespace runtime { namespace values {
          * Constructs a variable reference.
          * @param name The name of the variable.
          * @param value The variable's value.
+         * @param slot The frame slot of the variable if it is local to the current scope's frame.
          */
-        variable(std::string name, std::shared_ptr<values::value const> value);
+        variable(std::string name, std::shared_ptr<values::value const> value, size_t slot = npos);
+
+        /**
+         * The value used when a variable has no frame slot.
+         */
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
 
         /**
          * Gets the name of the variable.
@@ -40,6 +47,12 @@ namespace puppet { namespace runtime { namespace values {
          */
         std::shared_ptr<values::value const> const& shared_value() const;
 
+        /**
+         * Gets the frame slot of the variable.
+         * @return Returns the frame slot of the variable or npos if the variable is not local to the current scope's frame.
+         */
+        size_t slot() const;
+
         /**
          * Assigns the given value to the variable.
          * @param value The new value of the variable.
@@ -49,6 +62,7 @@ namespace puppet { namespace runtime { namespace values {
     private:
         std::string _name;
         std::shared_ptr<values::value const> _value;
+        size_t _slot;
     };
 
     /**
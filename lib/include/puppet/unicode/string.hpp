@@ -725,4 +725,23 @@ namespace puppet { namespace unicode {
      */
     size_t hash_value(unicode::string const& string);
 
+    /**
+     * Determines if the given UTF-8 data contains only invariant (ASCII) code units.
+     * This is a cheap check that does not construct a unicode::string.
+     * @param data The data to check.
+     * @param length The length of the data, in code units.
+     * @return Returns true if the data is invariant or false if not.
+     */
+    bool is_invariant(char const* data, size_t length) noexcept;
+
+    /**
+     * Determines if two UTF-8 strings are equal.
+     * ICU is only used when the strings cannot be compared as ASCII.
+     * @param left The left string to compare.
+     * @param right The right string to compare.
+     * @param ignore_case True to ignore case differences or false for a case-sensitive comparison.
+     * @return Returns true if the two strings are equal or false if not.
+     */
+    bool equals(std::string const& left, std::string const& right, bool ignore_case = false);
+
 }}  // namespace puppet::unicode
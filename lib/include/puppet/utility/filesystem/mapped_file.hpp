@@ -0,0 +1,79 @@
+/**
+ * @file
+ * Declares the mapped file.
+ */
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace puppet { namespace utility { namespace filesystem {
+
+    /**
+     * Represents a read-only view of a file's contents.
+     * The file is mapped into memory when possible; otherwise the contents are read once into a contiguous buffer.
+     */
+    struct mapped_file
+    {
+        /**
+         * Constructs a mapped file for the given path.
+         * Use the bool conversion operator to determine if the file was opened.
+         * @param path The path to the file to map.
+         */
+        explicit mapped_file(std::string const& path);
+
+        /**
+         * Destructs the mapped file.
+         */
+        ~mapped_file();
+
+        /**
+         * Deleted copy constructor.
+         */
+        mapped_file(mapped_file const&) = delete;
+
+        /**
+         * Deleted copy assignment operator.
+         * @return Returns this mapped file.
+         */
+        mapped_file& operator=(mapped_file const&) = delete;
+
+        /**
+         * Determines if the file was successfully opened.
+         * @return Returns true if the file was opened or false if it could not be read.
+         */
+        explicit operator bool() const;
+
+        /**
+         * Gets the file's data.
+         * @return Returns a pointer to the first byte of the file's data.
+         */
+        char const* data() const;
+
+        /**
+         * Gets the size of the file.
+         * @return Returns the size of the file, in bytes.
+         */
+        size_t size() const;
+
+        /**
+         * Gets the beginning of the file's data.
+         * @return Returns a pointer to the first byte of the file's data.
+         */
+        char const* begin() const;
+
+        /**
+         * Gets the end of the file's data.
+         * @return Returns a pointer to one past the last byte of the file's data.
+         */
+        char const* end() const;
+
+     private:
+        char const* _data = nullptr;
+        size_t _size = 0;
+        bool _mapped = false;
+        bool _opened = false;
+        std::string _buffer;
+    };
+
+}}}  // namespace puppet::utility::filesystem
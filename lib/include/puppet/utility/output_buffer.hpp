@@ -0,0 +1,142 @@
+/**
+ * @file
+ * Declares the output buffer.
+ */
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <cstddef>
+
+namespace puppet { namespace utility {
+
+    /**
+     * Represents a buffered output sink.
+     * Output accumulates in a large buffer that is written to a file descriptor or output stream only when full or flushed.
+     * An output buffer constructed without a sink keeps all output in memory.
+     * The buffer also models RapidJSON's output stream concept so that RapidJSON writers can write to it directly.
+     */
+    struct output_buffer
+    {
+        /**
+         * The character type of the buffer (required by RapidJSON).
+         */
+        using Ch = char;
+
+        /**
+         * The default number of bytes buffered before writing to the sink.
+         */
+        static constexpr size_t default_capacity = 64 * 1024;
+
+        /**
+         * Constructs an output buffer that keeps all output in memory.
+         */
+        output_buffer();
+
+        /**
+         * Constructs an output buffer that writes to a file descriptor.
+         * The file descriptor is not closed by the buffer.
+         * @param descriptor The file descriptor to write to.
+         * @param capacity The number of bytes to buffer before writing to the file descriptor.
+         */
+        explicit output_buffer(int descriptor, size_t capacity = default_capacity);
+
+        /**
+         * Constructs an output buffer that writes to an output stream.
+         * @param stream The output stream to write to.
+         * @param capacity The number of bytes to buffer before writing to the stream.
+         */
+        explicit output_buffer(std::ostream& stream, size_t capacity = default_capacity);
+
+        /**
+         * Destructs the output buffer.
+         * Any buffered output is written to the sink; errors are ignored.
+         */
+        ~output_buffer();
+
+        /**
+         * Deleted copy constructor.
+         */
+        output_buffer(output_buffer const&) = delete;
+
+        /**
+         * Deleted copy assignment operator.
+         * @return Returns this output buffer.
+         */
+        output_buffer& operator=(output_buffer const&) = delete;
+
+        /**
+         * Writes a character to the buffer.
+         * @param c The character to write.
+         */
+        void put(char c)
+        {
+            if (_buffer.size() >= _capacity) {
+                drain();
+            }
+            _buffer.push_back(c);
+        }
+
+        /**
+         * Writes a sequence of characters to the buffer.
+         * @param data The characters to write.
+         * @param size The number of characters to write.
+         */
+        void write(char const* data, size_t size);
+
+        /**
+         * Writes a string to the buffer.
+         * @param data The string to write.
+         */
+        void write(std::string const& data)
+        {
+            write(data.c_str(), data.size());
+        }
+
+        /**
+         * Writes any buffered output to the sink.
+         * Memory buffers are unaffected.
+         */
+        void flush();
+
+        /**
+         * Gets the buffered output.
+         * For memory buffers, this is all output written to the buffer.
+         * @return Returns the buffered output.
+         */
+        std::string const& contents() const;
+
+        /**
+         * Takes the buffered output, leaving the buffer empty.
+         * @return Returns the buffered output.
+         */
+        std::string take();
+
+        /**
+         * Writes a character to the buffer (required by RapidJSON).
+         * @param c The character to write.
+         */
+        void Put(char c)
+        {
+            put(c);
+        }
+
+        /**
+         * Flushes the buffer (required by RapidJSON).
+         * Writers call this after completing a document; output remains buffered until the buffer is full or explicitly flushed.
+         */
+        void Flush()
+        {
+        }
+
+     private:
+        void drain();
+        void write_through(char const* data, size_t size);
+
+        std::string _buffer;
+        size_t _capacity;
+        int _descriptor;
+        std::ostream* _stream;
+    };
+
+}}  // namespace puppet::utility
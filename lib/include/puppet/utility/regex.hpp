@@ -133,9 +133,12 @@ namespace puppet { namespace utility {
 
         /**
          * Constructs a regex with the given expression.
+         * Compiled expressions are cached process-wide by expression and options, so constructing
+         * the same regex again does not recompile it.
          * @param expression The expression for the regex.
+         * @param options The Onigmo compile options for the regex.
          */
-        explicit regex(std::string const& expression);
+        explicit regex(std::string const& expression, OnigOptionType options = ONIG_OPTION_DEFAULT);
 
         /**
          * Matches the regular expression against a string.
@@ -155,6 +158,19 @@ namespace puppet { namespace utility {
          */
         bool search(std::string const& str, regex::regions* regions = nullptr, size_t offset = 0) const;
 
+        /**
+         * Gets the compiled Onigmo regex.
+         * Regexes constructed with the same expression and options share the compiled regex while it is cached.
+         * @return Returns the compiled Onigmo regex.
+         */
+        regex_t const& get() const;
+
+        /**
+         * Gets the number of compiled expressions in the process-wide cache.
+         * @return Returns the number of compiled expressions in the cache.
+         */
+        static size_t cached();
+
      private:
         // The wrapper is used to share the Onigmo regex_t across all copies of this utility::regex
         // This allows for a simple move and copy semantic as we consider the regex_t to be immutable
@@ -168,6 +184,11 @@ namespace puppet { namespace utility {
          private:
             regex_t _regex;
         };
+
+        struct cache;
+
+        static std::shared_ptr<wrapper> compile(std::string const& expression, OnigOptionType options);
+
         std::shared_ptr<wrapper> _wrapper;
     };
 
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * Declares the thread pool.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace puppet { namespace utility {
+
+    /**
+     * Represents a bounded pool of worker threads.
+     * Worker threads are started on demand when work is first queued.
+     */
+    struct thread_pool
+    {
+        /**
+         * Constructs a thread pool.
+         * @param size The maximum number of worker threads; if zero, the number of hardware threads is used.
+         */
+        explicit thread_pool(size_t size = 0);
+
+        /**
+         * Destructs the thread pool.
+         * Work that has already been queued is completed before the worker threads exit.
+         */
+        ~thread_pool();
+
+        /**
+         * Deleted copy constructor.
+         */
+        thread_pool(thread_pool const&) = delete;
+
+        /**
+         * Deleted copy assignment operator.
+         * @return Returns this thread pool.
+         */
+        thread_pool& operator=(thread_pool const&) = delete;
+
+        /**
+         * Gets the maximum number of worker threads.
+         * @return Returns the maximum number of worker threads.
+         */
+        size_t size() const;
+
+        /**
+         * Queues work to be performed by the thread pool.
+         * @tparam Callable The type of callable to queue.
+         * @param callable The callable to invoke on a worker thread.
+         * @return Returns a future for the result of the callable.
+         */
+        template <typename Callable>
+        auto queue(Callable&& callable) -> std::future<decltype(callable())>
+        {
+            using result_type = decltype(callable());
+
+            // std::function requires a copyable target, so share the task
+            auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<Callable>(callable));
+            auto future = task->get_future();
+            enqueue([task]() { (*task)(); });
+            return future;
+        }
+
+     private:
+        void enqueue(std::function<void()> work);
+        void run();
+
+        size_t _size;
+        size_t _idle = 0;
+        bool _stopping = false;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::queue<std::function<void()>> _work;
+        std::vector<std::thread> _threads;
+    };
+
+}}  // namespace puppet::utility
@@ -0,0 +1,56 @@
+#include <puppet/compiler/ast/arena.hpp>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+namespace puppet { namespace compiler { namespace ast {
+
+    // The arena nodes are allocated from on the current thread
+    static thread_local arena* current_arena = nullptr;
+
+    void* arena::allocate(size_t size, size_t alignment)
+    {
+        // The size of the blocks to allocate nodes from; larger nodes get a block of their own
+        static const size_t BLOCK_SIZE = 16 * 1024;
+
+        auto next = reinterpret_cast<uintptr_t>(_next);
+        auto aligned = (next + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        if (!_next || aligned + size > reinterpret_cast<uintptr_t>(_end)) {
+            auto block_size = max(BLOCK_SIZE, size + alignment);
+            _blocks.emplace_back(new char[block_size]);
+            _next = _blocks.back().get();
+            _end = _next + block_size;
+
+            next = reinterpret_cast<uintptr_t>(_next);
+            aligned = (next + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        }
+
+        auto result = _next + (aligned - next);
+        _next = result + size;
+        _size += size;
+        return result;
+    }
+
+    size_t arena::size() const
+    {
+        return _size;
+    }
+
+    arena* arena::current()
+    {
+        return current_arena;
+    }
+
+    scoped_arena::scoped_arena(ast::arena* arena) :
+        _previous(current_arena)
+    {
+        current_arena = arena;
+    }
+
+    scoped_arena::~scoped_arena()
+    {
+        current_arena = _previous;
+    }
+
+}}}  // namespace puppet::compiler::ast
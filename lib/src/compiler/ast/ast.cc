@@ -1,10 +1,19 @@
 #include <puppet/compiler/ast/ast.hpp>
+#include <puppet/compiler/exceptions.hpp>
 #include <puppet/compiler/ast/visitors/type.hpp>
 #include <puppet/compiler/ast/visitors/validation.hpp>
+#include <puppet/compiler/ast/visitors/resolution.hpp>
 #include <puppet/compiler/lexer/lexer.hpp>
 #include <puppet/utility/regex.hpp>
+#include <puppet/utility/filesystem/mapped_file.hpp>
 #include <puppet/cast.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/format.hpp>
+#include <boost/crc.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/identity.hpp>
+#include <algorithm>
+#include <cstring>
 #include <yaml-cpp/yaml.h>
 
 using namespace std;
@@ -26,7 +35,7 @@ namespace puppet { namespace compiler { namespace ast {
         }
 
         template <typename T>
-        void operator()(x3::forward_ast<T> const& operand) const
+        void operator()(forward_node<T> const& operand) const
         {
             _os << operand.get();
         }
@@ -214,6 +223,24 @@ namespace puppet { namespace compiler { namespace ast {
         return !(left == right);
     }
 
+    constexpr size_t frame::npos;
+
+    size_t frame::add(std::string const& name)
+    {
+        return _slots.emplace(name, _slots.size()).first->second;
+    }
+
+    size_t frame::find(std::string const& name) const
+    {
+        auto it = _slots.find(name);
+        return it == _slots.end() ? npos : it->second;
+    }
+
+    size_t frame::size() const
+    {
+        return _slots.size();
+    }
+
     ostream& operator<<(ostream& os, variable const& node)
     {
         os << "$" << node.name;
@@ -290,19 +317,19 @@ namespace puppet { namespace compiler { namespace ast {
     bool basic_expression::is_splat() const
     {
         // Try for nested expression
-        auto nested = boost::get<x3::forward_ast<nested_expression>>(this);
+        auto nested = boost::get<forward_node<nested_expression>>(this);
         if (nested) {
             return nested->get().expression.is_splat();
         }
 
-        auto unary = boost::get<x3::forward_ast<unary_expression>>(this);
+        auto unary = boost::get<forward_node<unary_expression>>(this);
         return unary && unary->get().operator_ == unary_operator::splat;
     }
 
     bool basic_expression::is_default() const
     {
         // Try for nested expression
-        auto nested = boost::get<x3::forward_ast<nested_expression>>(this);
+        auto nested = boost::get<forward_node<nested_expression>>(this);
         if (nested) {
             return nested->get().expression.is_default();
         }
@@ -640,7 +667,7 @@ namespace puppet { namespace compiler { namespace ast {
 
         os << "\"";
         for (auto& part : node.parts) {
-            bool is_expression = boost::get<x3::forward_ast<expression>>(&part);
+            bool is_expression = boost::get<forward_node<expression>>(&part);
             if (is_expression) {
                 os << "${";
             }
@@ -1605,7 +1632,52 @@ namespace puppet { namespace compiler { namespace ast {
 
     void syntax_tree::source(std::string source)
     {
+        _mapping.reset();
         _source = rvalue_cast(source);
+        index();
+    }
+
+    void syntax_tree::source(shared_ptr<utility::filesystem::mapped_file const> mapping)
+    {
+        _source.clear();
+        _mapping = rvalue_cast(mapping);
+        index();
+    }
+
+    boost::string_ref syntax_tree::text() const
+    {
+        if (_mapping) {
+            return boost::string_ref{ _mapping->data(), _mapping->size() };
+        }
+        return _source;
+    }
+
+    void syntax_tree::index()
+    {
+        // Index the offset of the start of each line
+        auto text = this->text();
+        _lines.clear();
+        _lines.push_back(0);
+        for (auto newline = find(text.begin(), text.end(), '\n'); newline != text.end(); newline = find(newline + 1, text.end(), '\n')) {
+            _lines.push_back(static_cast<size_t>(newline - text.begin()) + 1);
+        }
+    }
+
+    lexer::line_info syntax_tree::line_info(size_t position, size_t length) const
+    {
+        auto text = this->text();
+        if (text.empty()) {
+            return lexer::line_info{};
+        }
+        if (position > text.size()) {
+            position = text.size();
+        }
+
+        // Find the line containing the position and exclude its trailing newline
+        auto line = upper_bound(_lines.begin(), _lines.end(), position);
+        size_t start = *(line - 1);
+        size_t end = line == _lines.end() ? text.size() : *line - 1;
+        return lexer::get_line_info(text.substr(start, end - start), position - start, length);
     }
 
     compiler::module const* syntax_tree::module() const
@@ -2342,7 +2414,7 @@ namespace puppet { namespace compiler { namespace ast {
         }
 
         template <typename T>
-        void write(x3::forward_ast<T> const& node)
+        void write(forward_node<T> const& node)
         {
             write(node.get());
         }
@@ -2386,6 +2458,771 @@ namespace puppet { namespace compiler { namespace ast {
         bool _include_path;
     };
 
+    // The XPP format is a fixed-size header followed by the serialized syntax tree (the payload)
+    // Header layout (little endian): magic (4), version (4), source hash (8), payload size (8), payload checksum (4)
+    static char const XPP_MAGIC[] = { 'X', 'P', 'P', '\0' };
+    static uint32_t const XPP_VERSION = 1;
+    static size_t const XPP_HEADER_SIZE = 28;
+
+    static uint64_t hash_source(char const* begin, char const* end)
+    {
+        // 64-bit FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (; begin != end; ++begin) {
+            hash ^= static_cast<unsigned char>(*begin);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static uint32_t checksum(char const* begin, char const* end)
+    {
+        boost::crc_32_type crc;
+        crc.process_block(begin, end);
+        return crc.checksum();
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, context& node)
+    {
+        archive(node.begin, node.end);
+        archive.tree(node.tree);
+    }
+
+    template <typename Archive, typename... Types>
+    void serialize(Archive& archive, x3::variant<Types...>& node)
+    {
+        archive.variant(node);
+    }
+
+    template <typename Archive, typename... Types>
+    void serialize(Archive& archive, boost::variant<Types...>& node)
+    {
+        archive.variant(node);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, std::pair<expression, expression>& pair)
+    {
+        archive(pair.first, pair.second);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, boolean& node)
+    {
+        archive(static_cast<context&>(node), node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, number& node)
+    {
+        archive(static_cast<context&>(node), node.base, node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, string& node)
+    {
+        archive(static_cast<context&>(node), node.format, node.value, node.margin);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, regex& node)
+    {
+        archive(static_cast<context&>(node), node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, variable& node)
+    {
+        archive(static_cast<context&>(node), node.name);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, name& node)
+    {
+        archive(static_cast<context&>(node), node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, bare_word& node)
+    {
+        archive(static_cast<context&>(node), node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, type& node)
+    {
+        archive(static_cast<context&>(node), node.name);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, postfix_expression& node)
+    {
+        archive(node.operand, node.operations);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, binary_operation& node)
+    {
+        archive(node.operator_position, node.operator_, node.operand);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, expression& node)
+    {
+        archive(node.operand, node.operations);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, next_statement& node)
+    {
+        archive(node.begin, node.end);
+        archive.tree(node.tree);
+        archive(node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, return_statement& node)
+    {
+        archive(node.begin, node.end);
+        archive.tree(node.tree);
+        archive(node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, literal_string_text& node)
+    {
+        archive(static_cast<context&>(node), node.text);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, interpolated_string& node)
+    {
+        archive(static_cast<context&>(node), node.format, node.parts, node.margin);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, array& node)
+    {
+        archive(static_cast<context&>(node), node.elements);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, hash& node)
+    {
+        archive(static_cast<context&>(node), node.elements);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, proposition& node)
+    {
+        archive(node.options, node.body, node.end);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, case_expression& node)
+    {
+        archive(static_cast<context&>(node), node.conditional, node.propositions);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, else_& node)
+    {
+        archive(node.begin, node.body, node.end);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, elsif& node)
+    {
+        archive(node.begin, node.conditional, node.body, node.end);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, if_expression& node)
+    {
+        archive(node.begin, node.conditional, node.body, node.end, node.elsifs, node.else_);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, unless_expression& node)
+    {
+        archive(node.begin, node.conditional, node.body, node.end, node.else_);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, parameter& node)
+    {
+        archive(node.type, node.captures, node.variable, node.default_value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, lambda_expression& node)
+    {
+        archive(static_cast<context&>(node), node.parameters, node.body);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, function_call_expression& node)
+    {
+        archive(node.function, node.arguments, node.end, node.lambda);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, new_expression& node)
+    {
+        archive(node.type, node.arguments, node.end, node.lambda);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, epp_render_expression& node)
+    {
+        archive(static_cast<context&>(node), node.expression);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, epp_render_block& node)
+    {
+        archive(static_cast<context&>(node), node.block);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, epp_render_string& node)
+    {
+        archive(static_cast<context&>(node), node.string);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, unary_expression& node)
+    {
+        archive(node.operator_position, node.operator_, node.operand);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, nested_expression& node)
+    {
+        archive(static_cast<context&>(node), node.expression);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, selector_expression& node)
+    {
+        archive(static_cast<context&>(node), node.cases);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, access_expression& node)
+    {
+        archive(static_cast<context&>(node), node.arguments);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, method_call_expression& node)
+    {
+        archive(node.begin, node.method, node.arguments, node.end, node.lambda);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, class_statement& node)
+    {
+        archive(static_cast<context&>(node), node.name, node.parameters, node.parent, node.body);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, defined_type_statement& node)
+    {
+        archive(static_cast<context&>(node), node.name, node.parameters, node.body);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, node_statement& node)
+    {
+        archive(static_cast<context&>(node), node.hostnames, node.body);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, function_statement& node)
+    {
+        archive(static_cast<context&>(node), node.is_private, node.name, node.parameters, node.body);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, attribute_operation& node)
+    {
+        archive(node.name, node.operator_position, node.operator_, node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, produces_statement& node)
+    {
+        archive(node.resource, node.capability, node.operations, node.end);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, consumes_statement& node)
+    {
+        archive(node.resource, node.capability, node.operations, node.end);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, application_statement& node)
+    {
+        archive(static_cast<context&>(node), node.name, node.parameters, node.body);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, site_statement& node)
+    {
+        archive(static_cast<context&>(node), node.body);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, type_alias_statement& node)
+    {
+        archive(node.begin, node.alias, node.type);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, function_call_statement& node)
+    {
+        archive(node.function, node.arguments, node.lambda);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, resource_body& node)
+    {
+        archive(node.title, node.operations);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, resource_declaration_expression& node)
+    {
+        archive(static_cast<context&>(node), node.status, node.type, node.bodies);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, resource_defaults_expression& node)
+    {
+        archive(static_cast<context&>(node), node.type, node.operations);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, attribute_query& node)
+    {
+        archive(node.attribute, node.operator_position, node.operator_, node.value);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, binary_query_operation& node)
+    {
+        archive(node.operator_position, node.operator_, node.operand);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, query_expression& node)
+    {
+        archive(node.operand, node.operations);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, nested_query_expression& node)
+    {
+        archive(static_cast<context&>(node), node.expression);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, collector_expression& node)
+    {
+        archive(node.type, node.exported, node.query, node.end);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, resource_override_expression& node)
+    {
+        archive(static_cast<context&>(node), node.reference, node.operations);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, relationship_operation& node)
+    {
+        archive(node.operator_position, node.operator_, node.operand);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive, relationship_statement& node)
+    {
+        archive(node.operand, node.operations);
+    }
+
+    struct xpp_writer
+    {
+        explicit xpp_writer(std::string& buffer) :
+            _buffer(buffer)
+        {
+        }
+
+        template <typename... Args>
+        void operator()(Args const&... args)
+        {
+            // Write each argument in order
+            int dummy[] = { 0, (transfer(args), 0)... };
+            static_cast<void>(dummy);
+        }
+
+        void tree(syntax_tree* const&)
+        {
+            // The tree pointer is restored when reading
+        }
+
+        template <typename Variant>
+        void variant(Variant const& node)
+        {
+            write_unsigned(static_cast<uint64_t>(which(node)));
+            boost::apply_visitor([this](auto const& alternative) {
+                this->transfer(alternative);
+            }, node);
+        }
+
+        void fixed(uint64_t value, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) {
+                _buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+            }
+        }
+
+     private:
+        template <typename... Types>
+        static int which(x3::variant<Types...> const& node)
+        {
+            return node.get().which();
+        }
+
+        template <typename... Types>
+        static int which(boost::variant<Types...> const& node)
+        {
+            return node.which();
+        }
+
+        void write_unsigned(uint64_t value)
+        {
+            // Write a variable-length unsigned integer
+            while (value >= 0x80) {
+                _buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            _buffer.push_back(static_cast<char>(value));
+        }
+
+        void transfer(bool value)
+        {
+            _buffer.push_back(value ? 1 : 0);
+        }
+
+        void transfer(int64_t value)
+        {
+            // Zig-zag encode so that small negative values stay small
+            write_unsigned((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        void transfer(double value)
+        {
+            uint64_t bits;
+            static_assert(sizeof(bits) == sizeof(value), "expected a 64-bit double.");
+            memcpy(&bits, &value, sizeof(bits));
+            fixed(bits, sizeof(bits));
+        }
+
+        void transfer(std::string const& value)
+        {
+            write_unsigned(value.size());
+            _buffer.append(value);
+        }
+
+        void transfer(lexer::position const& position)
+        {
+            write_unsigned(position.offset());
+            write_unsigned(position.line());
+        }
+
+        template <typename T>
+        typename std::enable_if<std::is_enum<T>::value || (std::is_unsigned<T>::value && !std::is_same<T, bool>::value)>::type transfer(T value)
+        {
+            write_unsigned(static_cast<uint64_t>(value));
+        }
+
+        template <typename T>
+        void transfer(forward_node<T> const& node)
+        {
+            transfer(node.get());
+        }
+
+        template <typename T>
+        void transfer(boost::optional<T> const& node)
+        {
+            transfer(static_cast<bool>(node));
+            if (node) {
+                transfer(*node);
+            }
+        }
+
+        template <typename T>
+        void transfer(std::vector<T> const& sequence)
+        {
+            write_unsigned(sequence.size());
+            for (auto const& element : sequence) {
+                transfer(element);
+            }
+        }
+
+        template <typename T>
+        typename std::enable_if<std::is_class<T>::value>::type transfer(T const& node)
+        {
+            // Serialization is shared with the reader, which requires a mutable node
+            serialize(*this, const_cast<T&>(node));
+        }
+
+        std::string& _buffer;
+    };
+
+    struct xpp_reader
+    {
+        xpp_reader(char const* begin, char const* end, syntax_tree* tree) :
+            _current(begin),
+            _end(end),
+            _tree(tree)
+        {
+        }
+
+        template <typename... Args>
+        void operator()(Args&... args)
+        {
+            // Read each argument in order
+            int dummy[] = { 0, (transfer(args), 0)... };
+            static_cast<void>(dummy);
+        }
+
+        void tree(syntax_tree*& tree)
+        {
+            tree = _tree;
+        }
+
+        template <typename Variant>
+        void variant(Variant& node)
+        {
+            auto which = read_unsigned();
+
+            uint64_t index = 0;
+            bool found = false;
+            boost::mpl::for_each<typename Variant::types, boost::mpl::make_identity<boost::mpl::_1>>([&](auto type) {
+                if (index++ != which) {
+                    return;
+                }
+                typename decltype(type)::type alternative;
+                this->transfer(alternative);
+                node = rvalue_cast(alternative);
+                found = true;
+            });
+            if (!found) {
+                throw runtime_error("unexpected variant index in XPP data.");
+            }
+        }
+
+        uint64_t fixed(size_t size)
+        {
+            ensure(size);
+            uint64_t value = 0;
+            for (size_t i = 0; i < size; ++i) {
+                value |= static_cast<uint64_t>(static_cast<unsigned char>(*_current++)) << (i * 8);
+            }
+            return value;
+        }
+
+        bool done() const
+        {
+            return _current == _end;
+        }
+
+     private:
+        void ensure(uint64_t size) const
+        {
+            if (static_cast<uint64_t>(_end - _current) < size) {
+                throw runtime_error("unexpected end of XPP data.");
+            }
+        }
+
+        uint64_t read_unsigned()
+        {
+            uint64_t value = 0;
+            for (unsigned int shift = 0; shift < 64; shift += 7) {
+                ensure(1);
+                auto byte = static_cast<unsigned char>(*_current++);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw runtime_error("invalid integer in XPP data.");
+        }
+
+        void transfer(bool& value)
+        {
+            ensure(1);
+            value = *_current++ != 0;
+        }
+
+        void transfer(int64_t& value)
+        {
+            auto temp = read_unsigned();
+            value = static_cast<int64_t>(temp >> 1) ^ -static_cast<int64_t>(temp & 1);
+        }
+
+        void transfer(double& value)
+        {
+            auto bits = fixed(sizeof(value));
+            memcpy(&value, &bits, sizeof(value));
+        }
+
+        void transfer(std::string& value)
+        {
+            auto size = read_unsigned();
+            ensure(size);
+            value.assign(_current, static_cast<size_t>(size));
+            _current += size;
+        }
+
+        void transfer(lexer::position& position)
+        {
+            auto offset = read_unsigned();
+            auto line = read_unsigned();
+            position = lexer::position{ static_cast<size_t>(offset), static_cast<size_t>(line) };
+        }
+
+        template <typename T>
+        typename std::enable_if<std::is_enum<T>::value || (std::is_unsigned<T>::value && !std::is_same<T, bool>::value)>::type transfer(T& value)
+        {
+            value = static_cast<T>(read_unsigned());
+        }
+
+        template <typename T>
+        void transfer(forward_node<T>& node)
+        {
+            transfer(node.get());
+        }
+
+        template <typename T>
+        void transfer(boost::optional<T>& node)
+        {
+            bool present = false;
+            transfer(present);
+            if (!present) {
+                node = boost::none;
+                return;
+            }
+            node = T{};
+            transfer(*node);
+        }
+
+        template <typename T>
+        void transfer(std::vector<T>& sequence)
+        {
+            auto size = read_unsigned();
+
+            // Every element takes at least one byte, so guard against a corrupt size
+            ensure(size);
+            sequence.clear();
+            sequence.reserve(static_cast<size_t>(size));
+            for (uint64_t i = 0; i < size; ++i) {
+                sequence.emplace_back();
+                transfer(sequence.back());
+            }
+        }
+
+        template <typename T>
+        typename std::enable_if<std::is_class<T>::value>::type transfer(T& node)
+        {
+            serialize(*this, node);
+        }
+
+        char const* _current;
+        char const* _end;
+        syntax_tree* _tree;
+    };
+
+    static void write_xpp(syntax_tree const& tree, ostream& stream)
+    {
+        // Hash the source that the tree was parsed from
+        uint64_t source_hash = 0;
+        auto text = tree.text();
+        if (!text.empty()) {
+            source_hash = hash_source(text.data(), text.data() + text.size());
+        } else {
+            utility::filesystem::mapped_file source{ tree.path() };
+            if (!source) {
+                throw runtime_error((boost::format("cannot read source file '%1%'.") % tree.path()).str());
+            }
+            source_hash = hash_source(source.begin(), source.end());
+        }
+
+        std::string payload;
+        xpp_writer payload_writer{ payload };
+        payload_writer(tree.parameters, tree.statements);
+
+        std::string header;
+        header.append(XPP_MAGIC, sizeof(XPP_MAGIC));
+        xpp_writer header_writer{ header };
+        header_writer.fixed(XPP_VERSION, 4);
+        header_writer.fixed(source_hash, 8);
+        header_writer.fixed(payload.size(), 8);
+        header_writer.fixed(checksum(payload.data(), payload.data() + payload.size()), 4);
+
+        stream.write(header.data(), header.size());
+        stream.write(payload.data(), payload.size());
+    }
+
+    static shared_ptr<syntax_tree> read_xpp(istream& stream, std::string path, compiler::module const* module)
+    {
+        std::string data{ istreambuf_iterator<char>{ stream }, istreambuf_iterator<char>{} };
+        if (data.size() < XPP_HEADER_SIZE || data.compare(0, sizeof(XPP_MAGIC), XPP_MAGIC, sizeof(XPP_MAGIC)) != 0) {
+            return nullptr;
+        }
+
+        try {
+            xpp_reader header{ data.data() + sizeof(XPP_MAGIC), data.data() + XPP_HEADER_SIZE, nullptr };
+            if (header.fixed(4) != XPP_VERSION) {
+                return nullptr;
+            }
+            auto source_hash = header.fixed(8);
+            auto payload_size = header.fixed(8);
+            auto payload_checksum = header.fixed(4);
+
+            auto payload = data.data() + XPP_HEADER_SIZE;
+            if (payload_size != data.size() - XPP_HEADER_SIZE ||
+                payload_checksum != checksum(payload, payload + payload_size)) {
+                return nullptr;
+            }
+
+            // The data is only usable if the source has not changed since it was written
+            auto source = make_shared<utility::filesystem::mapped_file const>(path);
+            if (!*source || hash_source(source->begin(), source->end()) != source_hash) {
+                return nullptr;
+            }
+
+            auto tree = syntax_tree::create(rvalue_cast(path), module);
+            {
+                scoped_arena arena{ &tree->arena() };
+                xpp_reader reader{ payload, payload + payload_size, tree.get() };
+                reader(tree->parameters, tree->statements);
+                if (!reader.done()) {
+                    return nullptr;
+                }
+            }
+            tree->source(rvalue_cast(source));
+            tree->resolve();
+            return tree;
+        } catch (runtime_error const&) {
+            return nullptr;
+        }
+    }
+
     void syntax_tree::write(ast::format format, ostream& stream, bool include_path) const
     {
         switch (format) {
@@ -2395,14 +3232,36 @@ namespace puppet { namespace compiler { namespace ast {
                 break;
             }
 
+            case ast::format::xpp:
+                write_xpp(*this, stream);
+                break;
+
             default:
                 throw runtime_error("unexpected syntax tree format.");
         }
     }
 
+    shared_ptr<syntax_tree> syntax_tree::read(ast::format format, istream& stream, std::string path, compiler::module const* module)
+    {
+        if (format != ast::format::xpp) {
+            throw runtime_error("unsupported syntax tree format for reading.");
+        }
+        return read_xpp(stream, rvalue_cast(path), module);
+    }
+
     void syntax_tree::validate(bool epp, bool allow_catalog_statements) const
     {
         visitors::validation visitor{ epp, allow_catalog_statements };
+        try {
+            visitor.visit(*this);
+        } catch (parse_exception const& ex) {
+            throw parse_exception{ ex, shared_from_this() };
+        }
+    }
+
+    void syntax_tree::resolve() const
+    {
+        visitors::resolution visitor;
         visitor.visit(*this);
     }
 
@@ -2425,6 +3284,18 @@ namespace puppet { namespace compiler { namespace ast {
     {
     }
 
+    syntax_tree::~syntax_tree()
+    {
+        // The nodes must be destroyed before the arena that stores them
+        parameters = boost::none;
+        statements.clear();
+    }
+
+    ast::arena& syntax_tree::arena()
+    {
+        return _arena;
+    }
+
     ostream& operator<<(ostream& os, syntax_tree const& node)
     {
         if (node.parameters) {
@@ -0,0 +1,565 @@
+#include <puppet/compiler/ast/visitors/resolution.hpp>
+#include <puppet/cast.hpp>
+#include <boost/algorithm/string.hpp>
+
+using namespace std;
+
+namespace puppet { namespace compiler { namespace ast { namespace visitors {
+
+    void resolution::visit(syntax_tree const& tree)
+    {
+        _frames.clear();
+        _lambdas.clear();
+
+        // Parameterized EPP templates are evaluated in their own scope; otherwise top-level statements have no frame
+        if (tree.parameters) {
+            tree.frame = resolve(&*tree.parameters, tree.statements);
+            return;
+        }
+        visit_body(tree.statements);
+    }
+
+    void resolution::operator()(basic_expression const& expression)
+    {
+        boost::apply_visitor(*this, expression);
+    }
+
+    void resolution::operator()(undef const&)
+    {
+    }
+
+    void resolution::operator()(defaulted const&)
+    {
+    }
+
+    void resolution::operator()(boolean const&)
+    {
+    }
+
+    void resolution::operator()(number const&)
+    {
+    }
+
+    void resolution::operator()(ast::string const&)
+    {
+    }
+
+    void resolution::operator()(ast::regex const&)
+    {
+    }
+
+    void resolution::operator()(variable const& expression)
+    {
+        variable_resolution result;
+
+        // Split qualified names once so that lookups do not need to
+        auto pos = expression.name.rfind("::");
+        if (pos != std::string::npos) {
+            bool global = boost::starts_with(expression.name, "::");
+            result.qualified = true;
+            result.scope = expression.name.substr(global ? 2 : 0, global ? (pos > 2 ? pos - 2 : 0) : pos);
+            result.name = symbol{ expression.name.substr(pos + 2) };
+
+            // Looking up a variable of an undeclared class logs a warning
+            impure();
+        } else {
+            result.name = symbol{ expression.name };
+
+            // The slot is assigned once the enclosing body has been visited
+            if (!_frames.empty()) {
+                _frames.back().references.push_back(&expression);
+            }
+        }
+        expression.resolution = rvalue_cast(result);
+    }
+
+    void resolution::operator()(name const&)
+    {
+    }
+
+    void resolution::operator()(bare_word const&)
+    {
+    }
+
+    void resolution::operator()(type const&)
+    {
+    }
+
+    void resolution::operator()(interpolated_string const& expression)
+    {
+        for (auto& part : expression.parts) {
+            boost::apply_visitor(*this, part);
+        }
+    }
+
+    void resolution::operator()(literal_string_text const&)
+    {
+    }
+
+    void resolution::operator()(ast::array const& expression)
+    {
+        for (auto& element : expression.elements) {
+            operator()(element);
+        }
+    }
+
+    void resolution::operator()(hash const& expression)
+    {
+        for (auto& element : expression.elements) {
+            operator()(element.first);
+            operator()(element.second);
+        }
+    }
+
+    void resolution::operator()(case_expression const& expression)
+    {
+        operator()(expression.conditional);
+
+        for (auto const& proposition : expression.propositions) {
+            for (auto const& option : proposition.options) {
+                operator()(option);
+            }
+            visit_body(proposition.body);
+        }
+    }
+
+    void resolution::operator()(if_expression const& expression)
+    {
+        operator()(expression.conditional);
+        visit_body(expression.body);
+
+        for (auto const& elsif : expression.elsifs) {
+            operator()(elsif.conditional);
+            visit_body(elsif.body);
+        }
+
+        if (expression.else_) {
+            visit_body(expression.else_->body);
+        }
+    }
+
+    void resolution::operator()(unless_expression const& expression)
+    {
+        operator()(expression.conditional);
+        visit_body(expression.body);
+
+        if (expression.else_) {
+            visit_body(expression.else_->body);
+        }
+    }
+
+    void resolution::operator()(function_call_expression const& expression)
+    {
+        impure();
+
+        for (auto const& argument : expression.arguments) {
+            operator()(argument);
+        }
+        if (expression.lambda) {
+            operator()(*expression.lambda);
+        }
+    }
+
+    void resolution::operator()(lambda_expression const& expression)
+    {
+        _lambdas.push_back(true);
+        expression.frame = resolve(&expression.parameters, expression.body);
+        expression.pure = _lambdas.back();
+        _lambdas.pop_back();
+    }
+
+    void resolution::operator()(new_expression const& expression)
+    {
+        impure();
+
+        operator()(expression.type);
+
+        for (auto const& argument : expression.arguments) {
+            operator()(argument);
+        }
+        if (expression.lambda) {
+            operator()(*expression.lambda);
+        }
+    }
+
+    void resolution::operator()(epp_render_expression const& expression)
+    {
+        impure();
+        operator()(expression.expression);
+    }
+
+    void resolution::operator()(epp_render_block const& expression)
+    {
+        impure();
+        for (auto const& expr : expression.block) {
+            operator()(expr);
+        }
+    }
+
+    void resolution::operator()(epp_render_string const&)
+    {
+        impure();
+    }
+
+    void resolution::operator()(unary_expression const& expression)
+    {
+        operator()(expression.operand);
+    }
+
+    void resolution::operator()(nested_expression const& expression)
+    {
+        operator()(expression.expression);
+    }
+
+    void resolution::operator()(ast::expression const& expression)
+    {
+        if (!expression.operations.empty()) {
+            lower(expression);
+        }
+
+        operator()(expression.operand);
+
+        postfix_expression const* left = &expression.operand;
+        for (auto const& operation : expression.operations) {
+            if (operation.operator_ == binary_operator::assignment) {
+                declare(*left);
+            }
+            operator()(operation.operand);
+            left = &operation.operand;
+        }
+    }
+
+    void resolution::operator()(postfix_expression const& expression)
+    {
+        operator()(expression.operand);
+
+        for (auto const& operation : expression.operations) {
+            boost::apply_visitor(*this, operation);
+        }
+    }
+
+    void resolution::operator()(selector_expression const& expression)
+    {
+        for (auto const& pair : expression.cases) {
+            operator()(pair.first);
+            operator()(pair.second);
+        }
+    }
+
+    void resolution::operator()(access_expression const& expression)
+    {
+        for (auto const& argument : expression.arguments) {
+            operator()(argument);
+        }
+    }
+
+    void resolution::operator()(method_call_expression const& expression)
+    {
+        impure();
+
+        for (auto const& argument : expression.arguments) {
+            operator()(argument);
+        }
+        if (expression.lambda) {
+            operator()(*expression.lambda);
+        }
+    }
+
+    void resolution::operator()(ast::statement const& statement)
+    {
+        boost::apply_visitor(*this, statement);
+    }
+
+    void resolution::operator()(class_statement const& statement)
+    {
+        statement.frame = resolve(&statement.parameters, statement.body, true);
+    }
+
+    void resolution::operator()(defined_type_statement const& statement)
+    {
+        statement.frame = resolve(&statement.parameters, statement.body, true);
+    }
+
+    void resolution::operator()(node_statement const& statement)
+    {
+        statement.frame = resolve(nullptr, statement.body);
+    }
+
+    void resolution::operator()(function_statement const& statement)
+    {
+        statement.frame = resolve(&statement.parameters, statement.body);
+    }
+
+    void resolution::operator()(produces_statement const& statement)
+    {
+        for (auto const& operation : statement.operations) {
+            operator()(operation.value);
+        }
+    }
+
+    void resolution::operator()(consumes_statement const& statement)
+    {
+        for (auto const& operation : statement.operations) {
+            operator()(operation.value);
+        }
+    }
+
+    void resolution::operator()(application_statement const& statement)
+    {
+        visit_parameters(statement.parameters);
+        visit_body(statement.body);
+    }
+
+    void resolution::operator()(site_statement const& statement)
+    {
+        visit_body(statement.body);
+    }
+
+    void resolution::operator()(type_alias_statement const&)
+    {
+    }
+
+    void resolution::operator()(function_call_statement const& statement)
+    {
+        impure();
+
+        for (auto const& argument : statement.arguments) {
+            operator()(argument);
+        }
+        if (statement.lambda) {
+            operator()(*statement.lambda);
+        }
+    }
+
+    void resolution::operator()(relationship_statement const& statement)
+    {
+        if (!statement.operations.empty()) {
+            impure();
+        }
+
+        operator()(statement.operand);
+
+        for (auto const& operation : statement.operations) {
+            operator()(operation.operand);
+        }
+    }
+
+    void resolution::operator()(relationship_expression const& expression)
+    {
+        boost::apply_visitor(*this, expression);
+    }
+
+    void resolution::operator()(resource_declaration_expression const& expression)
+    {
+        impure();
+
+        for (auto const& body : expression.bodies) {
+            operator()(body.title);
+
+            for (auto const& operation : body.operations) {
+                operator()(operation.value);
+            }
+        }
+    }
+
+    void resolution::operator()(resource_override_expression const& expression)
+    {
+        impure();
+
+        boost::apply_visitor(*this, expression.reference);
+        for (auto const& operation : expression.operations) {
+            operator()(operation.value);
+        }
+    }
+
+    void resolution::operator()(resource_defaults_expression const& expression)
+    {
+        impure();
+
+        for (auto const& operation : expression.operations) {
+            operator()(operation.value);
+        }
+    }
+
+    void resolution::operator()(collector_expression const& expression)
+    {
+        impure();
+
+        if (expression.query) {
+            operator()(*expression.query);
+        }
+    }
+
+    void resolution::operator()(query_expression const& expression)
+    {
+        operator()(expression.operand);
+
+        for (auto const& operation : expression.operations) {
+            operator()(operation.operand);
+        }
+    }
+
+    void resolution::operator()(nested_query_expression const& expression)
+    {
+        operator()(expression.expression);
+    }
+
+    void resolution::operator()(basic_query_expression const& expression)
+    {
+        boost::apply_visitor(*this, expression);
+    }
+
+    void resolution::operator()(attribute_query const& expression)
+    {
+        operator()(expression.value);
+    }
+
+    void resolution::operator()(break_statement const&)
+    {
+    }
+
+    void resolution::operator()(next_statement const& statement)
+    {
+        if (statement.value) {
+            operator()(*statement.value);
+        }
+    }
+
+    void resolution::operator()(return_statement const& statement)
+    {
+        impure();
+
+        if (statement.value) {
+            operator()(*statement.value);
+        }
+    }
+
+    shared_ptr<ast::frame const> resolution::resolve(vector<parameter> const* parameters, vector<statement> const& body, bool is_resource)
+    {
+        _frames.emplace_back();
+        _frames.back().frame = make_shared<ast::frame>();
+
+        // Resources always have a title and name in scope
+        if (is_resource) {
+            _frames.back().frame->add("title");
+            _frames.back().frame->add("name");
+        }
+
+        if (parameters) {
+            for (auto const& parameter : *parameters) {
+                _frames.back().frame->add(parameter.variable.name);
+            }
+            visit_parameters(*parameters);
+        }
+        visit_body(body);
+
+        // Assign slots to references of variables assigned in this body; everything else is looked up dynamically
+        auto current = rvalue_cast(_frames.back());
+        _frames.pop_back();
+
+        for (auto reference : current.references) {
+            auto slot = current.frame->find(reference->name);
+            if (slot == ast::frame::npos) {
+                continue;
+            }
+            reference->resolution->frame = current.frame.get();
+            reference->resolution->slot = slot;
+        }
+        return current.frame;
+    }
+
+    void resolution::visit_parameters(vector<parameter> const& parameters)
+    {
+        for (auto const& parameter : parameters) {
+            operator()(parameter.variable);
+            if (parameter.type) {
+                operator()(*parameter.type);
+            }
+            if (parameter.default_value) {
+                operator()(*parameter.default_value);
+            }
+        }
+    }
+
+    void resolution::visit_body(vector<statement> const& body)
+    {
+        for (auto const& statement : body) {
+            operator()(statement);
+        }
+    }
+
+    void resolution::lower(ast::expression const& expression)
+    {
+        auto& instructions = expression.instructions;
+        instructions.clear();
+        instructions.reserve(expression.operations.size() * 2 + 1);
+
+        size_t index = 0;
+        lower(expression, 0, 0, index);
+    }
+
+    void resolution::lower(ast::expression const& expression, size_t operand, unsigned int min_precedence, size_t& index)
+    {
+        using opcode = instruction::opcode;
+
+        auto& instructions = expression.instructions;
+        auto& operations = expression.operations;
+
+        instructions.push_back(make_instruction(opcode::operand, operand));
+
+        // Climb the operations once, emitting the operands and operators in evaluation order
+        unsigned int current = 0;
+        while (index < operations.size() && (current = precedence(operations[index].operator_)) >= min_precedence) {
+            auto operation = index++;
+            auto op = operations[operation].operator_;
+
+            // Logical and/or may skip their right-hand side
+            auto jump = instructions.size();
+            bool logical = op == binary_operator::logical_and || op == binary_operator::logical_or;
+            if (logical) {
+                instructions.push_back(make_instruction(opcode::short_circuit, operation));
+            }
+
+            lower(expression, operation + 1, current + (is_right_associative(op) ? 0 : 1), index);
+            instructions.push_back(make_instruction(opcode::binary, operation));
+
+            if (logical) {
+                instructions[jump].target = static_cast<uint32_t>(instructions.size());
+            }
+        }
+    }
+
+    void resolution::impure()
+    {
+        // Side effects of nested lambdas are side effects of the enclosing lambdas
+        _lambdas.assign(_lambdas.size(), false);
+    }
+
+    instruction resolution::make_instruction(instruction::opcode code, size_t index)
+    {
+        instruction result;
+        result.code = code;
+        result.index = static_cast<uint32_t>(index);
+        return result;
+    }
+
+    void resolution::declare(postfix_expression const& operand)
+    {
+        if (_frames.empty() || !operand.operations.empty()) {
+            return;
+        }
+
+        if (auto variable = boost::get<ast::variable>(&operand.operand)) {
+            if (!variable->name.empty() && variable->name.find(':') == std::string::npos) {
+                _frames.back().frame->add(variable->name);
+            }
+            return;
+        }
+        if (auto array = boost::get<ast::forward_node<ast::array>>(&operand.operand)) {
+            for (auto const& element : array->get().elements) {
+                declare(element.operand);
+            }
+        }
+    }
+
+}}}}  // namespace puppet::compiler::ast::visitors
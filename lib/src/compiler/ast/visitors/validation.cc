@@ -783,7 +783,7 @@ namespace puppet { namespace compiler { namespace ast { namespace visitors {
                 validate_assignment_operand(*variable);
                 return;
             }
-            if (auto array = boost::get<boost::spirit::x3::forward_ast<ast::array>>(&operand.operand)) {
+            if (auto array = boost::get<ast::forward_node<ast::array>>(&operand.operand)) {
                 validate_assignment_operand(array->get());
                 return;
             }
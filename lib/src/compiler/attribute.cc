@@ -12,7 +12,7 @@ namespace puppet { namespace compiler {
     }
 
     attribute::attribute(string name, ast::context name_context, shared_ptr<values::value> value, ast::context value_context) :
-        _name(rvalue_cast(name)),
+        _name(name),
         _name_context(rvalue_cast(name_context)),
         _value(rvalue_cast(value)),
         _value_context(rvalue_cast(value_context))
@@ -28,6 +28,11 @@ namespace puppet { namespace compiler {
     }
 
     string const& attribute::name() const
+    {
+        return _name.name();
+    }
+
+    symbol const& attribute::symbol() const
     {
         return _name;
     }
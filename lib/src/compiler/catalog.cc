@@ -1,11 +1,13 @@
 #include <puppet/compiler/catalog.hpp>
 #include <puppet/compiler/exceptions.hpp>
+#include <puppet/utility/output_buffer.hpp>
 #include <puppet/cast.hpp>
 #include <boost/graph/hawick_circuits.hpp>
+#include <boost/graph/strong_components.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/format.hpp>
-#include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
+#include <algorithm>
 
 using namespace std;
 using namespace puppet::runtime;
@@ -51,7 +53,8 @@ namespace puppet { namespace compiler {
 
     catalog::catalog(string node, string environment) :
         _node(rvalue_cast(node)),
-        _environment(rvalue_cast(environment))
+        _environment(rvalue_cast(environment)),
+        _index(make_unique<resource_index>())
     {
     }
 
@@ -85,7 +88,13 @@ namespace puppet { namespace compiler {
         _resource_map[resource->type()] = resource;
 
         // Append to the type list
-        _resource_lists[resource->type().type_name()].emplace_back(resource);
+        auto& list = _resource_lists[resource->type().type_name()];
+        resource->_position = list.size();
+        list.emplace_back(resource);
+
+        // Add to the index
+        resource->_index = _index.get();
+        _index->add(*resource);
 
         // Realize the resource if not virtual
         if (!virtualized) {
@@ -120,6 +129,21 @@ namespace puppet { namespace compiler {
         return _resources.size();
     }
 
+    resource_index& catalog::index()
+    {
+        return *_index;
+    }
+
+    resource_index& catalog::index(string const& type)
+    {
+        if (!_index->indexed(type)) {
+            static vector<resource*> const empty;
+            auto it = _resource_lists.find(type);
+            _index->index(type, it == _resource_lists.end() ? empty : it->second);
+        }
+        return *_index;
+    }
+
     void catalog::each(function<bool(resource&)> const& callback, string const& type, size_t offset)
     {
         // Adapt the given function so that we cast away const-ness of the resource
@@ -127,7 +151,7 @@ namespace puppet { namespace compiler {
             return callback(const_cast<resource&>(r));
         };
         // Enumerate the resources using the const overload
-        return static_cast<catalog const*>(this)->each(adapted, type);
+        return static_cast<catalog const*>(this)->each(adapted, type, offset);
     }
 
     void catalog::each(function<bool(resource const&)> const& callback, std::string const& type, size_t offset) const
@@ -169,6 +193,15 @@ namespace puppet { namespace compiler {
         }
     }
 
+    size_t catalog::edge_key_hash::operator()(edge_key const& key) const
+    {
+        size_t seed = 0;
+        boost::hash_combine(seed, get<0>(key));
+        boost::hash_combine(seed, get<1>(key));
+        boost::hash_combine(seed, static_cast<size_t>(get<2>(key)));
+        return seed;
+    }
+
     void catalog::relate(relationship relation, resource const& source, resource const& target)
     {
         if (source.virtualized()) {
@@ -188,10 +221,8 @@ namespace puppet { namespace compiler {
         }
 
         // Add the edge to the graph if it doesn't already exist
-        for (auto const& edge : make_iterator_range(boost::out_edges(source_ptr->vertex_id(), _graph))) {
-            if (_graph[boost::target(edge, _graph)] == target_ptr && _graph[edge] == relation) {
-                return;
-            }
+        if (!_edges.emplace(source_ptr->vertex_id(), target_ptr->vertex_id(), relation).second) {
+            return;
         }
         boost::add_edge(source_ptr->vertex_id(), target_ptr->vertex_id(), relation, _graph);
     }
@@ -234,104 +265,89 @@ namespace puppet { namespace compiler {
         }
     }
 
-    void catalog::write(ostream& out) const
+    void catalog::write(ostream& out, bool pretty) const
     {
-        // Declare an adapter for RapidJSON's pretty writter
-        struct stream_adapter
-        {
-            explicit stream_adapter(ostream& stream) : _stream(stream)
-            {
-            }
-
-            void Put(char c)
-            {
-                _stream.put(c);
-            }
-
-            void Flush()
-            {
-            }
-
-        private:
-            ostream& _stream;
-        } adapter(out);
-
-        // Create the document and treat it as an object
-        json_document document;
-        document.SetObject();
+        utility::output_buffer buffer{ out };
+        write(buffer, pretty);
+        buffer.flush();
+    }
 
-        auto& allocator = document.GetAllocator();
+    void catalog::write(utility::output_buffer& buffer, bool pretty) const
+    {
+        if (pretty) {
+            json_pretty_writer writer{ buffer };
+            writer.SetIndent(' ', 2);
+            write_json(writer);
+        } else {
+            json_writer writer{ buffer };
+            write_json(writer);
+        }
 
-        // Create an array to store the classes
-        json_value classes;
-        classes.SetArray();
+        // Finish the catalog with one last newline
+        buffer.put('\n');
+    }
 
-        // Create an array to store the resources
-        json_value resources;
-        resources.SetArray();
-        resources.Reserve(_resources.size(),allocator);
+    template <typename Writer>
+    void catalog::write_json(Writer& writer) const
+    {
+        writer.StartObject();
 
-        // Create an array to store the dependency edges
-        json_value edges;
-        edges.SetArray();
+        // Write out the catalog attributes
+        writer.Key("name", 4);
+        writer.String(_node.c_str(), static_cast<rapidjson::SizeType>(_node.size()));
+        writer.Key("version", 7);
+        writer.Int64(static_cast<int64_t>(std::time(nullptr)));
+        writer.Key("environment", 11);
+        writer.String(_environment.c_str(), static_cast<rapidjson::SizeType>(_environment.size()));
 
+        // Write out the resources
+        writer.Key("resources", 9);
+        writer.StartArray();
         for (auto const& resource : _resources) {
             // Skip virtual resources
             if (resource.virtualized()) {
                 continue;
             }
+            resource.write(writer, *this);
+        }
+        writer.EndArray();
 
-            if (resource.type().is_class()) {
-                auto& title = resource.type().title();
-                classes.PushBack(rapidjson::StringRef(title.c_str(), title.size()), allocator);
+        // Write out the containment edges
+        writer.Key("edges", 5);
+        writer.StartArray();
+        for (auto const& resource : _resources) {
+            if (resource.virtualized()) {
+                continue;
             }
-
-            // Add the resource
-            resources.PushBack(resource.to_json(allocator, *this), allocator);
-
-            // Add the edges for this resource
             each_edge(resource, [&](relationship relation, compiler::resource const& target) {
                 if (relation != relationship::contains) {
                     // The top level edges are only containment edges
                     return true;
                 }
-                // Create an edge object from source to target
-                json_value edge;
-                edge.SetObject();
-                edge.AddMember(
-                    "source",
-                    json_value(boost::lexical_cast<string>(resource.type()).c_str(), allocator),
-                    allocator);
-                edge.AddMember(
-                    "target",
-                    json_value(boost::lexical_cast<string>(target.type()).c_str(), allocator),
-                    allocator);
-                edges.PushBack(rvalue_cast(edge), allocator);
+                writer.StartObject();
+                writer.Key("source", 6);
+                compiler::resource::write_reference(writer, resource.type());
+                writer.Key("target", 6);
+                compiler::resource::write_reference(writer, target.type());
+                writer.EndObject();
                 return true;
             });
         }
-
-        // Write out the catalog attributes
-        document.AddMember("name", rapidjson::StringRef(_node.c_str(), _node.size()), allocator);
-        document.AddMember("version", static_cast<int64_t>(std::time(nullptr)), allocator);
-        document.AddMember("environment", rapidjson::StringRef(_environment.c_str(), _environment.size()), allocator);
-
-        // Write out the resources
-        document.AddMember("resources", rvalue_cast(resources), allocator);
-
-        // Write out the containment edges
-        document.AddMember("edges", rvalue_cast(edges), allocator);
+        writer.EndArray();
 
         // Write out the declared classes
-        document.AddMember("classes", rvalue_cast(classes), allocator);
-
-        // Write the document to the stream
-        rapidjson::PrettyWriter<stream_adapter> writer{adapter};
-        writer.SetIndent(' ', 2);
-        document.Accept(writer);
+        writer.Key("classes", 7);
+        writer.StartArray();
+        for (auto const& resource : _resources) {
+            if (resource.virtualized() || !resource.type().is_class()) {
+                continue;
+            }
+            auto& title = resource.type().title();
+            writer.String(title.c_str(), static_cast<rapidjson::SizeType>(title.size()));
+        }
+        writer.EndArray();
 
-        // Flush the stream with one last newline
-        out << endl;
+        writer.EndObject();
     }
 
     void catalog::write_graph(ostream& out)
@@ -360,16 +376,30 @@ namespace puppet { namespace compiler {
         out << "}\n";
     }
 
+    struct cycle_limit_reached
+    {
+    };
+
+    template <typename Graph>
     struct cycle_visitor
     {
-        explicit cycle_visitor(vector<string>& cycles) :
-            _cycles(cycles)
+        cycle_visitor(Graph const& graph, vector<size_t> const& vertices, vector<string>& cycles, size_t limit) :
+            _graph(graph),
+            _vertices(vertices),
+            _cycles(cycles),
+            _limit(limit)
         {
         }
 
-        template <typename Path, typename Graph>
-        void cycle(Path const& path, Graph const& graph)
+        template <typename Path, typename Subgraph>
+        void cycle(Path const& path, Subgraph const&)
         {
+            // Stop enumerating circuits once the limit has been reached
+            if (_limit > 0 && _cycles.size() >= _limit) {
+                throw cycle_limit_reached();
+            }
+
+            // The path is in terms of the component's vertices, so map back to the catalog's graph
             ostringstream cycle;
             bool first = true;
             for (auto const& id : path) {
@@ -378,30 +408,100 @@ namespace puppet { namespace compiler {
                 } else {
                     cycle << " => ";
                 }
-                auto resource = graph[id];
+                auto resource = _graph[_vertices[id]];
                 cycle << resource->type() << " declared at " << resource->path() << ":" << resource->line();
             }
             // Append on the first vertex again to complete the cycle
-            auto resource = graph[path.front()];
+            auto resource = _graph[_vertices[path.front()]];
             cycle << " => " << resource->type();
             _cycles.push_back(cycle.str());
         }
 
+     private:
+        Graph const& _graph;
+        vector<size_t> const& _vertices;
         vector<string>& _cycles;
+        size_t _limit;
     };
 
-    void catalog::detect_cycles()
+    constexpr size_t catalog::default_cycle_limit;
+
+    void catalog::detect_cycles(size_t limit)
     {
-        // Check for cycles in the graph
-        vector<string> cycles;
-        boost::hawick_unique_circuits(_graph, cycle_visitor(cycles));
-        if (cycles.empty()) {
+        // Find the strongly connected components of the graph; this is linear in the size of the graph
+        auto vertex_count = boost::num_vertices(_graph);
+        vector<size_t> component_map(vertex_count);
+        auto component_count = boost::strong_components(
+            _graph,
+            boost::make_iterator_property_map(component_map.begin(), boost::get(boost::vertex_index, _graph)));
+
+        // A cycle exists only in a component with more than one vertex or in a component whose vertex has an edge to itself
+        vector<vector<size_t>> components(component_count);
+        vector<bool> cyclic(component_count, false);
+        for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+            auto component = component_map[vertex];
+            components[component].push_back(vertex);
+            if (components[component].size() > 1) {
+                cyclic[component] = true;
+            }
+        }
+        for (auto const& edge : make_iterator_range(boost::edges(_graph))) {
+            auto source = boost::source(edge, _graph);
+            if (source == boost::target(edge, _graph)) {
+                cyclic[component_map[source]] = true;
+            }
+        }
+
+        // Enumerate the circuits within each cyclic component only
+        // Components are visited in order of their lowest vertex so that the report is stable
+        vector<size_t> order;
+        for (size_t component = 0; component < component_count; ++component) {
+            if (cyclic[component]) {
+                order.push_back(component);
+            }
+        }
+        if (order.empty()) {
             return;
         }
+        sort(order.begin(), order.end(), [&](size_t left, size_t right) {
+            return components[left].front() < components[right].front();
+        });
+
+        vector<string> cycles;
+        bool truncated = false;
+        vector<size_t> local_map(vertex_count);
+        for (auto component : order) {
+            auto const& vertices = components[component];
+
+            // Build a graph of just the component's vertices and the edges between them
+            boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS> subgraph(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                local_map[vertices[i]] = i;
+            }
+            for (auto vertex : vertices) {
+                for (auto const& edge : make_iterator_range(boost::out_edges(vertex, _graph))) {
+                    auto target = boost::target(edge, _graph);
+                    if (component_map[target] == component) {
+                        boost::add_edge(local_map[vertex], local_map[target], subgraph);
+                    }
+                }
+            }
+
+            try {
+                boost::hawick_unique_circuits(subgraph, cycle_visitor<decltype(_graph)>(_graph, vertices, cycles, limit));
+            } catch (cycle_limit_reached const&) {
+                truncated = true;
+                break;
+            }
+        }
 
         // At least one cycle found, so throw an exception
         ostringstream message;
-        message << "found " << cycles.size() << " resource dependency cycle" << (cycles.size() == 1 ? ":\n" : "s:\n");
+        if (truncated) {
+            message << "found more than " << cycles.size() << " resource dependency cycles; showing the first " << cycles.size() << ":\n";
+        } else {
+            message << "found " << cycles.size() << " resource dependency cycle" << (cycles.size() == 1 ? ":\n" : "s:\n");
+        }
         for (size_t i = 0; i < cycles.size(); ++i) {
             if (i > 0) {
                 message << "\n";
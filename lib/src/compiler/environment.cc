@@ -9,6 +9,8 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
+#include <fstream>
+#include <sstream>
 
 using namespace std;
 using namespace puppet::runtime;
@@ -154,13 +156,10 @@ namespace puppet { namespace compiler {
     {
         auto& logger = context.node().logger();
 
-        vector<shared_ptr<ast::syntax_tree>> trees;
+        // Queue all the main manifests so that they are parsed in parallel
+        vector<pair<string, shared_ptr<parsed_file>>> pending;
         auto parse = [&](string const& manifest) {
-            try {
-                trees.emplace_back(import(logger, manifest));
-            } catch (parse_exception const& ex) {
-                throw compilation_exception(ex, manifest);
-            }
+            pending.emplace_back(manifest, queue_import(logger, manifest, nullptr, true));
         };
 
         // Load all the main manifests
@@ -184,6 +183,17 @@ namespace puppet { namespace compiler {
             }
         }
 
+        // Wait for every parse to complete before reporting any errors so that no parse outlives this call
+        for (auto& file : pending) {
+            file.second->tree.wait();
+        }
+
+        // Scan the trees in manifest order so that definitions are registered deterministically
+        vector<shared_ptr<ast::syntax_tree>> trees;
+        for (auto& file : pending) {
+            trees.emplace_back(finish_import(*file.second, file.first));
+        }
+
         {
             // Create the 'main' stack frame
             evaluation::scoped_stack_frame frame{ context, evaluation::stack_frame{ "<class main>", context.top_scope(), false }};
@@ -248,7 +258,7 @@ namespace puppet { namespace compiler {
 
     void environment::each_module(function<bool(module const&)> const& callback) const
     {
-        // TODO: this function needs to be thread safe
+        // Modules are only added when the environment is created, so enumeration does not require a lock
         for (auto& module : _modules) {
             if (!callback(module)) {
                 return;
@@ -257,6 +267,32 @@ namespace puppet { namespace compiler {
     }
 
     void environment::import(logging::logger& logger, find_type type, string name)
+    {
+        // Names that could not be found before are not searched for again
+        {
+            lock_guard<mutex> lock{ _misses_mutex };
+            auto misses = _misses.find(type);
+            if (misses != _misses.end() && misses->second.count(name) > 0) {
+                return;
+            }
+        }
+
+        compiler::module const* module = nullptr;
+        auto path = find_import(logger, type, name, module);
+
+        // Ignore files that don't exist
+        if (path.empty()) {
+            // Modules and their files are indexed once, so the miss holds for the lifetime of the environment
+            lock_guard<mutex> lock{ _misses_mutex };
+            _misses[type].emplace(rvalue_cast(name));
+            return;
+        }
+
+        // Import the file, but don't parse it if it's already been imported
+        import(logger, path, module);
+    }
+
+    string environment::find_import(logging::logger& logger, find_type type, string name, compiler::module const*& module) const
     {
         boost::to_lower(name);
         if (boost::starts_with(name, "::")) {
@@ -264,24 +300,23 @@ namespace puppet { namespace compiler {
         }
 
         string path;
-        compiler::module const* module = nullptr;
         auto pos = name.find("::");
         if (pos == string::npos) {
             // If not a manifest, the name could not be imported
             if (type != find_type::manifest) {
-                return;
+                return {};
             }
 
             if (name == "environment") {
                 // Don't load manifests from the environment
-                return;
+                return {};
             }
 
             // If the name is that of a module, translate to the init.pp manifest file
             module = find_module(name);
             if (!module) {
                 LOG(debug, "could not load 'init.pp' for module '%1%' because the module does not exist.", name);
-                return;
+                return {};
             }
             path = module->find_by_name(type, "init");
         } else {
@@ -292,26 +327,19 @@ namespace puppet { namespace compiler {
             if (ns == "environment") {
                 if (type == find_type::manifest) {
                     // Don't load manifests from the environment
-                    return;
+                    return {};
                 }
                 path = find_by_name(type, subname);
             } else {
                 module = find_module(ns);
                 if (!module) {
                     LOG(debug, "could not load a file for '%1%' because module '%2%' does not exist.", name, ns);
-                    return;
+                    return {};
                 }
                 path = module->find_by_name(type, subname);
             }
         }
-
-        // Ignore files that don't exist
-        if (path.empty()) {
-            return;
-        }
-
-        // Import the file, but don't parse it if it's already been imported
-        import(logger, path, module);
+        return path;
     }
 
     string environment::resolve_path(logging::logger& logger, find_type type, string const& path) const
@@ -420,35 +448,231 @@ namespace puppet { namespace compiler {
         }
     }
 
+    shared_ptr<ast::syntax_tree> environment::parse_template(logging::logger& logger, string const& path)
+    {
+        file_stamp current;
+        bool exists = stamp(path, current);
+        if (exists) {
+            lock_guard<mutex> lock{ _cache_mutex };
+            auto it = _templates.find(path);
+            if (it != _templates.end() && it->second.stamp == current) {
+                return it->second.value;
+            }
+        }
+
+        // Parse and validate the template outside of the lock; concurrent parses of the same template are harmless
+        auto tree = parser::parse_file(logger, path, nullptr, true);
+        LOG(debug, "parsed EPP AST:\n-----\n%1%\n-----", *tree);
+        tree->validate(true);
+
+        if (exists) {
+            lock_guard<mutex> lock{ _cache_mutex };
+            _templates[path] = { current, tree };
+        }
+        return tree;
+    }
+
+    shared_ptr<ast::syntax_tree> environment::parse_inline_template(logging::logger& logger, string const& source, string const& path)
+    {
+        {
+            lock_guard<mutex> lock{ _cache_mutex };
+            auto it = _inline_templates.find(source);
+            if (it != _inline_templates.end()) {
+                return it->second;
+            }
+        }
+
+        // Inline templates are keyed by their source, so bound the cache by both count and size
+        static size_t const MAX_INLINE_TEMPLATES = 256;
+        static size_t const MAX_INLINE_TEMPLATE_BYTES = 1024 * 1024;
+
+        auto tree = parser::parse_string(logger, source, path, nullptr, true);
+        LOG(debug, "parsed inline EPP AST:\n-----\n%1%\n-----", *tree);
+        tree->validate(true);
+
+        if (source.size() > MAX_INLINE_TEMPLATE_BYTES) {
+            return tree;
+        }
+
+        lock_guard<mutex> lock{ _cache_mutex };
+        auto result = _inline_templates.emplace(source, tree);
+        if (!result.second) {
+            return tree;
+        }
+        _inline_template_order.push_back(&result.first->first);
+        _inline_template_bytes += source.size();
+
+        // Evict the oldest templates first
+        while (_inline_template_order.size() > MAX_INLINE_TEMPLATES || _inline_template_bytes > MAX_INLINE_TEMPLATE_BYTES) {
+            auto it = _inline_templates.find(*_inline_template_order.front());
+            _inline_template_order.pop_front();
+            _inline_template_bytes -= it->first.size();
+            _inline_templates.erase(it);
+        }
+        return tree;
+    }
+
+    shared_ptr<string const> environment::read_file(string const& path)
+    {
+        file_stamp current;
+        bool exists = stamp(path, current);
+        if (exists) {
+            lock_guard<mutex> lock{ _cache_mutex };
+            auto it = _files.find(path);
+            if (it != _files.end() && it->second.stamp == current) {
+                return it->second.value;
+            }
+        }
+
+        ifstream stream{ path };
+        if (!stream) {
+            return nullptr;
+        }
+        ostringstream output;
+        output << stream.rdbuf();
+        auto contents = make_shared<string const>(output.str());
+
+        if (exists) {
+            lock_guard<mutex> lock{ _cache_mutex };
+            _files[path] = { current, contents };
+        }
+        return contents;
+    }
+
+    bool environment::file_stamp::operator==(file_stamp const& other) const
+    {
+        return modified == other.modified && size == other.size;
+    }
+
+    bool environment::stamp(string const& path, file_stamp& result)
+    {
+        sys::error_code ec;
+        result.modified = fs::last_write_time(path, ec);
+        if (ec) {
+            return false;
+        }
+        result.size = fs::file_size(path, ec);
+        return !ec;
+    }
+
+    shared_ptr<ast::syntax_tree> environment::load_precompiled(logging::logger& logger, string const& path, compiler::module const* module) const
+    {
+        auto precompiled = fs::path{ path }.replace_extension(".xpp");
+
+        sys::error_code ec;
+        if (!fs::is_regular_file(precompiled, ec)) {
+            return nullptr;
+        }
+
+        ifstream stream{ precompiled.string(), ios::in | ios::binary };
+        if (!stream) {
+            return nullptr;
+        }
+
+        auto tree = ast::syntax_tree::read(ast::format::xpp, stream, path, module);
+        if (!tree) {
+            LOG(debug, "ignoring precompiled AST '%1%' because it is invalid or out-of-date.", precompiled.string());
+            return nullptr;
+        }
+        LOG(debug, "loaded precompiled AST '%1%' into environment '%2%'.", precompiled.string(), name());
+        return tree;
+    }
+
     shared_ptr<ast::syntax_tree> environment::import(logging::logger& logger, string const& path, compiler::module const* module)
     {
-        // TODO: this needs to be made thread safe
-        // TODO: this needs to be made transactional
+        auto file = queue_import(logger, path, module, false);
+        return finish_import(*file, path);
+    }
 
-        try {
-            // Check for an already parsed AST
+    shared_ptr<environment::parsed_file> environment::queue_import(logging::logger& logger, string const& path, compiler::module const* module, bool defer)
+    {
+        auto file = make_shared<parsed_file>();
+        promise<shared_ptr<ast::syntax_tree>> result;
+        {
+            lock_guard<mutex> lock{ _parsed_mutex };
+
+            // Check for a file that has already been imported or is currently being parsed
             auto it = _parsed.find(path);
             if (it != _parsed.end()) {
                 LOG(debug, "using cached AST for '%1%' in environment '%2%'.", path, name());
                 return it->second;
             }
 
-            // Parse the file
-            LOG(debug, "loading '%1%' into environment '%2%'.", path, name());
-            auto tree = parser::parse_file(logger, path, module);
-            LOG(debug, "parsed AST for '%1%':\n-----\n%2%\n-----", path, *tree);
-            _parsed.emplace(path, tree);
+            // Concurrent imports of the same file will wait on the same result
+            if (defer) {
+                file->tree = _parse_pool.queue([this, &logger, path, module]() {
+                    return parse(logger, path, module);
+                }).share();
+            } else {
+                file->tree = result.get_future().share();
+            }
+            _parsed.emplace(path, file);
+        }
+
+        // The caller is going to wait for the result, so parse on this thread rather than handing off to the pool
+        if (!defer) {
+            try {
+                result.set_value(parse(logger, path, module));
+            } catch (...) {
+                result.set_exception(current_exception());
+            }
+        }
+        return file;
+    }
 
-            // Validate the AST
-            tree->validate();
+    shared_ptr<ast::syntax_tree> environment::finish_import(parsed_file& file, string const& path)
+    {
+        try {
+            shared_ptr<ast::syntax_tree> tree;
+            try {
+                tree = file.tree.get();
+            } catch (...) {
+                // Forget the failed parse so that a later import of the file parses it again
+                lock_guard<mutex> lock{ _parsed_mutex };
+                auto it = _parsed.find(path);
+                if (it != _parsed.end() && it->second.get() == &file) {
+                    _parsed.erase(it);
+                }
+                throw;
+            }
 
-            // Scan the tree for definitions
-            compiler::scanner scanner{ _registry, _dispatcher };
-            scanner.scan(*tree);
+            // Scan the tree for definitions exactly once; registration is serialized so that conflicts are detected consistently
+            // TODO: this needs to be made transactional
+            lock_guard<mutex> lock{ _scan_mutex };
+            if (!file.scanned) {
+                file.scanned = true;
+                try {
+                    compiler::scanner scanner{ _registry, _dispatcher };
+                    scanner.scan(*tree);
+                } catch (...) {
+                    file.error = current_exception();
+                }
+            }
+            if (file.error) {
+                rethrow_exception(file.error);
+            }
             return tree;
         } catch (parse_exception const& ex) {
             throw compilation_exception(ex, path);
         }
     }
 
+    shared_ptr<ast::syntax_tree> environment::parse(logging::logger& logger, string const& path, compiler::module const* module) const
+    {
+        // Use a precompiled AST if one exists for the current source; it was validated when written
+        auto tree = load_precompiled(logger, path, module);
+        if (tree) {
+            return tree;
+        }
+
+        // Parse the file
+        LOG(debug, "loading '%1%' into environment '%2%'.", path, name());
+        tree = parser::parse_file(logger, path, module);
+        LOG(debug, "parsed AST for '%1%':\n-----\n%2%\n-----", path, *tree);
+
+        // Validate the AST
+        tree->validate();
+        return tree;
+    }
+
 }}  // namespace puppet::compiler
@@ -2,6 +2,7 @@
 #include <puppet/compiler/evaluation/collectors/query_evaluator.hpp>
 #include <puppet/compiler/evaluation/context.hpp>
 #include <puppet/cast.hpp>
+#include <algorithm>
 
 using namespace std;
 
@@ -27,6 +28,32 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
         scoped_stack_frame frame{ context, stack_frame{ &_expression, _scope } };
         query_evaluator evaluator{ context, _expression.query };
 
+        // Answer the query from the catalog's index when possible
+        if (_expression.query) {
+            auto const& type = _expression.type.name;
+            auto& index = catalog.index(type);
+
+            // Nothing to do if no resources of the type have been added since the last collection
+            auto size = index.resources(type).size();
+            if (_index >= size) {
+                return;
+            }
+
+            if (auto candidates = evaluator.find(index, type)) {
+                // The candidates are sorted, so skip those that have already been considered
+                for (auto it = lower_bound(candidates->begin(), candidates->end(), _index); it != candidates->end(); ++it) {
+                    auto& resource = *index.resources(type)[*it];
+
+                    // The index may return stale candidates, so evaluate the query to be sure
+                    if (evaluator.evaluate(resource)) {
+                        collect_resource(context, resource, false);
+                    }
+                }
+                _index = size;
+                return;
+            }
+        }
+
         // Realize each resource that matches the query
         catalog.each(
             [&](compiler::resource& resource) {
@@ -1,7 +1,11 @@
 #include <puppet/compiler/evaluation/collectors/query_evaluator.hpp>
 #include <puppet/compiler/evaluation/evaluator.hpp>
 #include <puppet/compiler/evaluation/context.hpp>
+#include <puppet/unicode/string.hpp>
+#include <puppet/cast.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <iterator>
 
 using namespace std;
 using namespace puppet::runtime;
@@ -9,6 +13,23 @@ namespace x3 = boost::spirit::x3;
 
 namespace puppet { namespace compiler { namespace evaluation { namespace collectors {
 
+    struct query_evaluator::predicate
+    {
+        enum class kind
+        {
+            attribute,
+            title,
+            conjunction,
+            disjunction
+        };
+
+        kind type = kind::conjunction;
+        bool negated = false;
+        std::string const* name = nullptr;
+        values::value expected;
+        std::vector<predicate> operands;
+    };
+
     query_evaluator::query_evaluator(evaluation::context& context, boost::optional<ast::query_expression> const& expression) :
         _context(context),
         _expression(expression)
@@ -21,45 +42,147 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
         if (!_expression) {
             return true;
         }
+        return evaluate(compiled(), resource);
+    }
 
-        // Climb the remainder of the expression
-        auto begin = _expression->operations.begin();
-        return climb_expression(_expression->operand, 0, begin, _expression->operations.end(), resource);
+    boost::optional<vector<size_t>> query_evaluator::find(compiler::resource_index const& index, string const& type) const
+    {
+        // Without a query, every resource is a candidate
+        if (!_expression) {
+            return boost::none;
+        }
+        return find(compiled(), index, type);
     }
 
-    bool query_evaluator::evaluate(ast::basic_query_expression const& expression, compiler::resource const& resource) const
+    query_evaluator::predicate const& query_evaluator::compiled() const
     {
-        // Handle nested expressions
-        if (auto nested = boost::get<x3::forward_ast<ast::nested_query_expression>>(&expression)) {
-            query_evaluator evaluator{ _context, nested->get().expression };
-            return evaluator.evaluate(resource);
+        // Compile on first use so that the query's values are only evaluated if there are resources to test
+        if (!_predicate) {
+            _predicate = make_shared<predicate>(compile(*_expression));
         }
+        return *_predicate;
+    }
 
-        evaluation::evaluator evaluator{ _context };
+    query_evaluator::predicate query_evaluator::compile(ast::query_expression const& expression) const
+    {
+        auto begin = expression.operations.begin();
+        return compile(expression.operand, 0, begin, expression.operations.end());
+    }
+
+    query_evaluator::predicate query_evaluator::compile(ast::basic_query_expression const& expression) const
+    {
+        // Handle nested expressions
+        if (auto nested = boost::get<ast::forward_node<ast::nested_query_expression>>(&expression)) {
+            return compile(nested->get().expression);
+        }
 
         // Otherwise, this should be an attribute query
         auto& query = boost::get<ast::attribute_query>(expression);
 
-        // Evaluate the expected value
-        auto expected = evaluator.evaluate(query.value);
+        predicate result;
+        result.type = query.attribute.value == "title" ? predicate::kind::title : predicate::kind::attribute;
+        result.negated = query.operator_ == ast::query_operator::not_equals;
+        result.name = &query.attribute.value;
 
-        // If the query is on the title, search the resource's title
-        bool result = false;
-        if (query.attribute.value == "title") {
-            if (auto str = expected.as<string>()) {
-                result = resource.type().title() == *str;
+        // Evaluate the expected value once, dereferencing any variable
+        evaluation::evaluator evaluator{ _context };
+        result.expected = evaluator.evaluate(query.value);
+        if (auto variable = boost::get<values::variable>(&result.expected)) {
+            result.expected = values::value{ variable->value() };
+        }
+        return result;
+    }
+
+    query_evaluator::predicate query_evaluator::compile(
+        ast::basic_query_expression const& expression,
+        std::uint8_t min_precedence,
+        std::vector<ast::binary_query_operation>::const_iterator& begin,
+        std::vector<ast::binary_query_operation>::const_iterator const& end) const
+    {
+        auto result = compile(expression);
+
+        // Climb the binary operations based on operator precedence
+        uint8_t precedence;
+        while (begin != end && (precedence = get_precedence(begin->operator_)) >= min_precedence)
+        {
+            auto& operation = *begin;
+            ++begin;
+
+            uint8_t next_precedence = precedence + (is_right_associative(operation.operator_) ? static_cast<uint8_t>(0) : static_cast<uint8_t>(1));
+            auto right = compile(operation.operand, next_precedence, begin, end);
+
+            auto type = operation.operator_ == ast::binary_query_operator::logical_and ? predicate::kind::conjunction : predicate::kind::disjunction;
+
+            // Flatten chains of the same operator into a single predicate
+            if (result.type != type) {
+                predicate combined;
+                combined.type = type;
+                combined.operands.emplace_back(rvalue_cast(result));
+                result = rvalue_cast(combined);
             }
-        } else {
-            // If the attribute doesn't exist, return false
-            auto attribute = resource.get(query.attribute.value);
-            if (!attribute) {
+            result.operands.emplace_back(rvalue_cast(right));
+        }
+        return result;
+    }
+
+    bool query_evaluator::evaluate(predicate const& query, compiler::resource const& resource)
+    {
+        switch (query.type) {
+            case predicate::kind::conjunction:
+                for (auto const& operand : query.operands) {
+                    if (!evaluate(operand, resource)) {
+                        return false;
+                    }
+                }
+                return true;
+
+            case predicate::kind::disjunction:
+                for (auto const& operand : query.operands) {
+                    if (evaluate(operand, resource)) {
+                        return true;
+                    }
+                }
                 return false;
+
+            case predicate::kind::title: {
+                auto str = boost::get<string>(&query.expected);
+                bool result = str && resource.type().title() == *str;
+                return query.negated ? !result : result;
             }
 
+            case predicate::kind::attribute:
+                break;
+        }
+
+        // If the attribute doesn't exist, the query does not match regardless of the operator
+        auto attribute = resource.get(*query.name);
+        if (!attribute) {
+            return false;
+        }
+
+        auto const& actual = attribute->value();
+        bool result = false;
+        if (auto expected = boost::get<string>(&query.expected)) {
+            // Compare strings directly rather than through value equality
+            auto matches = [&](values::value const& value) {
+                auto str = value.as<string>();
+                return str && unicode::equals(*str, *expected);
+            };
+            if (auto array = actual.as<values::array>()) {
+                for (auto const& element : *array) {
+                    if (matches(element)) {
+                        result = true;
+                        break;
+                    }
+                }
+            } else {
+                result = matches(actual);
+            }
+        } else {
             // If the attribute's value is an array, first check for containment
-            if (auto array = attribute->value().as<values::array>()) {
+            if (auto array = actual.as<values::array>()) {
                 for (auto const& element : *array) {
-                    if (element == expected) {
+                    if (element == query.expected) {
                         result = true;
                         break;
                     }
@@ -67,42 +190,82 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
             }
 
             // Otherwise, compare for equality
-            result = result || attribute->value() == expected;
+            result = result || actual == query.expected;
         }
+        return query.negated ? !result : result;
+    }
 
-        if (query.operator_ == ast::query_operator::not_equals) {
-            result = !result;
+    static boost::optional<vector<size_t>> intersect(boost::optional<vector<size_t>> left, boost::optional<vector<size_t>> right)
+    {
+        // An unknown set is treated as every resource
+        if (!left) {
+            return right;
+        }
+        if (!right) {
+            return left;
         }
+        vector<size_t> result;
+        set_intersection(left->begin(), left->end(), right->begin(), right->end(), back_inserter(result));
         return result;
     }
 
-    bool query_evaluator::climb_expression(
-        ast::basic_query_expression const& expression,
-        std::uint8_t min_precedence,
-        std::vector<ast::binary_query_operation>::const_iterator& begin,
-        std::vector<ast::binary_query_operation>::const_iterator const& end,
-        compiler::resource const& resource) const
+    static vector<size_t> unite(vector<size_t> const& left, vector<size_t> const& right)
     {
-        // Evaluate the left-hand side of the expression
-        auto result = evaluate(expression, resource);
+        vector<size_t> result;
+        set_union(left.begin(), left.end(), right.begin(), right.end(), back_inserter(result));
+        return result;
+    }
 
-        // Climb the binary operations based on operator precedence
-        uint8_t precedence;
-        while (begin != end && (precedence = get_precedence(begin->operator_)) >= min_precedence)
-        {
-            auto& operation = *begin;
-            ++begin;
+    boost::optional<vector<size_t>> query_evaluator::find(predicate const& query, compiler::resource_index const& index, string const& type)
+    {
+        switch (query.type) {
+            case predicate::kind::conjunction: {
+                boost::optional<vector<size_t>> result;
+                for (auto const& operand : query.operands) {
+                    result = intersect(rvalue_cast(result), find(operand, index, type));
+                }
+                return result;
+            }
 
-            // Attempt short circuiting
-            if ((operation.operator_ == ast::binary_query_operator::logical_and && !result) ||
-                (operation.operator_ == ast::binary_query_operator::logical_or && result)) {
-                begin = end;
+            case predicate::kind::disjunction: {
+                // If any operand is unknown, the entire disjunction is
+                vector<size_t> result;
+                for (auto const& operand : query.operands) {
+                    auto positions = find(operand, index, type);
+                    if (!positions) {
+                        return boost::none;
+                    }
+                    result = unite(result, *positions);
+                }
                 return result;
             }
 
-            // Recurse and climb the expression
-            uint8_t next_precedence = precedence + (is_right_associative(operation.operator_) ? static_cast<uint8_t>(0) : static_cast<uint8_t>(1));
-            result = climb_expression(operation.operand, next_precedence, begin, end, resource);
+            default:
+                break;
+        }
+
+        // Only equality can be answered by the index
+        if (query.negated) {
+            return boost::none;
+        }
+
+        compiler::resource_index::position_set const* positions = nullptr;
+        if (query.type == predicate::kind::title) {
+            if (auto str = boost::get<string>(&query.expected)) {
+                positions = index.find_title(type, *str);
+            }
+        } else {
+            // Defaulted attributes are resolved through each resource's scope and are not indexed
+            if (index.defaulted(type, *query.name)) {
+                return boost::none;
+            }
+            positions = index.find(type, *query.name, query.expected);
+        }
+
+        vector<size_t> result;
+        if (positions) {
+            result.assign(positions->begin(), positions->end());
+            sort(result.begin(), result.end());
         }
         return result;
     }
@@ -23,11 +23,11 @@ namespace puppet { namespace compiler { namespace evaluation {
         _context._match_stack.pop_back();
     }
 
-    node_scope::node_scope(evaluation::context& context, compiler::resource& resource) :
+    node_scope::node_scope(evaluation::context& context, compiler::resource& resource, shared_ptr<ast::frame const> frame) :
         _context(context)
     {
         // Create a node scope that inherits from the top scope
-        _context._node_scope = make_shared<scope>(_context.top_scope(), &resource);
+        _context._node_scope = make_shared<scope>(_context.top_scope(), &resource, rvalue_cast(frame));
     }
 
     node_scope::~node_scope()
@@ -345,6 +345,11 @@ namespace puppet { namespace compiler { namespace evaluation {
         return *_catalog;
     }
 
+    bool context::has_catalog() const
+    {
+        return _catalog != nullptr;
+    }
+
     compiler::registry const& context::registry() const
     {
         if (!_registry) {
@@ -442,40 +447,76 @@ namespace puppet { namespace compiler { namespace evaluation {
     }
 
     shared_ptr<values::value const> context::lookup(ast::variable const& expression, bool warn)
+    {
+        auto& resolution = expression.resolution;
+        if (!resolution) {
+            // The variable was not resolved; look it up by name
+            return lookup(expression, expression.name, warn);
+        }
+
+        if (!resolution->qualified) {
+            auto& scope = current_scope();
+
+            // If the variable is local to the current scope's frame, use its slot
+            if (resolution->frame && scope->frame() == resolution->frame) {
+                auto& value = scope->get(resolution->slot);
+                if (value) {
+                    return value;
+                }
+            }
+            return scope->get(resolution->name);
+        }
+
+        // Lookup the namespace
+        auto scope = find_scope(resolution->scope);
+        if (scope) {
+            return scope->get(resolution->name);
+        }
+        if (warn) {
+            warn_lookup(expression, resolution->scope);
+        }
+        return nullptr;
+    }
+
+    shared_ptr<values::value const> context::lookup(ast::variable const& expression, string const& name, bool warn)
     {
         // Look for the last :: delimiter; if not found, use the current scope
-        auto pos = expression.name.rfind("::");
+        auto pos = name.rfind("::");
         if (pos == string::npos) {
-            return current_scope()->get(expression.name);
+            return current_scope()->get(name);
         }
 
         // Split into namespace and variable name
         // For global names, remove the leading ::
-        bool global = boost::starts_with(expression.name, "::");
-        auto ns = expression.name.substr(global ? 2 : 0, global ? (pos > 2 ? pos - 2 : 0) : pos);
-        auto var = expression.name.substr(pos + 2);
+        bool global = boost::starts_with(name, "::");
+        auto ns = name.substr(global ? 2 : 0, global ? (pos > 2 ? pos - 2 : 0) : pos);
+        auto var = name.substr(pos + 2);
 
         // Lookup the namespace
         auto scope = find_scope(ns);
         if (scope) {
             return scope->get(var);
         }
-
         if (warn) {
-            string message;
-            if (_registry && !_registry->find_class(ns)) {
-                message = (boost::format("could not look up variable $%1% because class '%2%' is not defined.") % expression.name % ns).str();
-            } else if (_catalog && !_catalog->find(types::resource("class", ns))) {
-                message = (boost::format("could not look up variable $%1% because class '%2%' has not been declared.") % expression.name % ns).str();
-            }
-
-            if (!message.empty()) {
-                log(logging::level::warning, message, &expression);
-            }
+            warn_lookup(expression, ns);
         }
         return nullptr;
     }
 
+    void context::warn_lookup(ast::variable const& expression, string const& ns)
+    {
+        string message;
+        if (_registry && !_registry->find_class(ns)) {
+            message = (boost::format("could not look up variable $%1% because class '%2%' is not defined.") % expression.name % ns).str();
+        } else if (_catalog && !_catalog->find(types::resource("class", ns))) {
+            message = (boost::format("could not look up variable $%1% because class '%2%' has not been declared.") % expression.name % ns).str();
+        }
+
+        if (!message.empty()) {
+            log(logging::level::warning, message, &expression);
+        }
+    }
+
     shared_ptr<values::value const> context::lookup(size_t index) const
     {
         // Walk the match scope stack for a non-null set of matches
@@ -546,15 +587,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             return;
         }
 
-        lexer::line_info info;
-        if (context->tree->source().empty()) {
-            ifstream input{ context->tree->path() };
-            if (input) {
-                info = lexer::get_line_info(input, context->begin.offset(), context->end.offset() - context->begin.offset());
-            }
-        } else {
-            info = lexer::get_line_info(context->tree->source(), context->begin.offset(), context->end.offset() - context->begin.offset());
-        }
+        auto info = context->tree->line_info(context->begin.offset(), context->end.offset() - context->begin.offset());
         logger.log(level, context->begin.line(), info.column, info.length, info.text, context->tree->path(), message);
     }
 
@@ -680,6 +713,23 @@ namespace puppet { namespace compiler { namespace evaluation {
         return descriptor;
     }
 
+    functions::call_site* context::call_site(ast::name const& name)
+    {
+        if (!name.tree) {
+            find_function(name.value);
+            return nullptr;
+        }
+
+        auto& site = _call_sites[&name];
+        if (!site.tree) {
+            site.tree = name.tree->shared_from_this();
+        }
+        if (!site.function) {
+            site.function = find_function(name.value);
+        }
+        return &site;
+    }
+
     compiler::type_alias* context::find_type_alias(string const& name, bool import)
     {
         return const_cast<compiler::type_alias*>(static_cast<context const*>(this)->find_type_alias(name, import));
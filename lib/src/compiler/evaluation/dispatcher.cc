@@ -138,6 +138,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             throw runtime_error("cannot add a function that is not dispatchable to the dispatcher.");
         }
         string name = descriptor.name();
+        unique_lock<shared_timed_mutex> lock{ _mutex };
         if (!_functions.emplace(rvalue_cast(name), rvalue_cast(descriptor)).second) {
             throw runtime_error((boost::format("function '%1%' already exists in the dispatcher.") % name).str());
         }
@@ -151,7 +152,12 @@ namespace puppet { namespace compiler { namespace evaluation {
         if (find(descriptor.oper())) {
             throw runtime_error((boost::format("operator '%1%' already exists in the dispatcher.") % descriptor.oper()).str());
         }
-        _binary_operators.emplace_back(rvalue_cast(descriptor));
+        // Operators are indexed by their enumeration value
+        auto index = static_cast<size_t>(descriptor.oper());
+        if (index >= _binary_operators.size()) {
+            _binary_operators.resize(index + 1);
+        }
+        _binary_operators[index] = rvalue_cast(descriptor);
     }
 
     void dispatcher::add(unary::descriptor descriptor)
@@ -162,7 +168,12 @@ namespace puppet { namespace compiler { namespace evaluation {
         if (find(descriptor.oper())) {
             throw runtime_error((boost::format("operator '%1%' already exists in the dispatcher.") % descriptor.oper()).str());
         }
-        _unary_operators.emplace_back(rvalue_cast(descriptor));
+        // Operators are indexed by their enumeration value
+        auto index = static_cast<size_t>(descriptor.oper());
+        if (index >= _unary_operators.size()) {
+            _unary_operators.resize(index + 1);
+        }
+        _unary_operators[index] = rvalue_cast(descriptor);
     }
 
     functions::descriptor* dispatcher::find(string const& name)
@@ -172,6 +183,7 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     functions::descriptor const* dispatcher::find(string const& name) const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
         auto it = _functions.find(name);
         if (it == _functions.end()) {
             return nullptr;
@@ -186,11 +198,11 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     binary::descriptor const* dispatcher::find(ast::binary_operator oper) const
     {
-        auto it = std::find_if(_binary_operators.begin(), _binary_operators.end(), [=](auto const& descriptor) { return descriptor.oper() == oper; });
-        if (it == _binary_operators.end()) {
+        auto index = static_cast<size_t>(oper);
+        if (index >= _binary_operators.size() || !_binary_operators[index]) {
             return nullptr;
         }
-        return &*it;
+        return &*_binary_operators[index];
     }
 
     unary::descriptor* dispatcher::find(ast::unary_operator oper)
@@ -200,17 +212,23 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     unary::descriptor const* dispatcher::find(ast::unary_operator oper) const
     {
-        auto it = std::find_if(_unary_operators.begin(), _unary_operators.end(), [=](auto const& descriptor) { return descriptor.oper() == oper; });
-        if (it == _unary_operators.end()) {
+        auto index = static_cast<size_t>(oper);
+        if (index >= _unary_operators.size() || !_unary_operators[index]) {
             return nullptr;
         }
-        return &*it;
+        return &*_unary_operators[index];
     }
 
-    values::value dispatcher::dispatch(functions::call_context& context) const
+    values::value dispatcher::dispatch(functions::call_context& context, functions::call_site* site) const
     {
-        // Find the requested function
-        auto descriptor = find(context.name().value);
+        // Find the requested function, unless already resolved for the call site
+        auto descriptor = site ? site->function : nullptr;
+        if (!descriptor) {
+            descriptor = find(context.name().value);
+            if (site) {
+                site->function = descriptor;
+            }
+        }
         if (!descriptor) {
             throw evaluation_exception(
                 (boost::format("function '%1%' was not found.") %
@@ -221,7 +239,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             );
         }
 
-        return descriptor->dispatch(context);
+        return descriptor->dispatch(context, site);
     }
 
     values::value dispatcher::dispatch(binary::call_context& context) const
@@ -5,6 +5,7 @@
 #include <puppet/compiler/evaluation/operators/binary/call_context.hpp>
 #include <puppet/compiler/evaluation/operators/unary/call_context.hpp>
 #include <puppet/compiler/exceptions.hpp>
+#include <boost/container/small_vector.hpp>
 
 using namespace std;
 using namespace puppet::compiler::ast;
@@ -29,7 +30,7 @@ namespace puppet { namespace compiler { namespace evaluation {
     {
         if (tree.parameters) {
             // Use a function evaluator if there were parameters specified in the EPP
-            function_evaluator evaluator{ _context, "<epp-eval>", *tree.parameters, tree.statements };
+            function_evaluator evaluator{ _context, "<epp-eval>", *tree.parameters, tree.statements, tree.frame };
 
             values::hash empty;
             return evaluator.evaluate(arguments ? *arguments : empty);
@@ -156,7 +157,13 @@ namespace puppet { namespace compiler { namespace evaluation {
     value evaluator::operator()(ast::regex const& expression)
     {
         try {
-            return values::regex{ expression.value };
+            // Compile the literal once per AST node; racing evaluations store equivalent regexes
+            auto compiled = atomic_load(&expression.compiled);
+            if (!compiled) {
+                compiled = make_shared<values::regex const>(expression.value);
+                atomic_store(&expression.compiled, compiled);
+            }
+            return *compiled;
         } catch (utility::regex_exception const& ex) {
             throw evaluation_exception(
                 (boost::format("invalid regular expression: %1%") %
@@ -174,13 +181,13 @@ namespace puppet { namespace compiler { namespace evaluation {
             throw evaluation_exception("variable name cannot be empty.", expression, _context.backtrace());
         }
 
-        shared_ptr<values::value const> value;
         if (isdigit(expression.name[0])) {
-            value = _context.lookup(stoi(expression.name));
-        } else {
-            value = _context.lookup(expression);
+            return values::variable(expression.name, _context.lookup(stoi(expression.name)));
         }
-        return values::variable(expression.name, rvalue_cast(value));
+
+        // Remember the variable's slot so that an assignment to it does not need to look it up again
+        auto value = _context.lookup(expression);
+        return values::variable(expression.name, rvalue_cast(value), _context.current_scope()->slot(expression));
     }
 
     value evaluator::operator()(name const& expression)
@@ -235,7 +242,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             } else if (auto ptr = boost::get<ast::variable>(&part)) {
                 current_margin = 0;
                 _context.write(operator()(*ptr));
-            } else if (auto ptr = boost::get<x3::forward_ast<ast::expression>>(&part)) {
+            } else if (auto ptr = boost::get<ast::forward_node<ast::expression>>(&part)) {
                 current_margin = 0;
                 auto value = evaluate(*ptr);
                 value.ensure();
@@ -390,8 +397,8 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     value evaluator::operator()(function_call_expression const& expression)
     {
-        // Find the function before executing the call to ensure it is imported
-        _context.find_function(expression.function.value);
+        // Resolve the call site before executing the call to ensure the function is imported
+        auto site = _context.call_site(expression.function);
 
         // Construct the call context and check to see if any of the arguments was a control transfer
         functions::call_context context{ _context, expression };
@@ -399,7 +406,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         if (transfer) {
             return rvalue_cast(*transfer);
         }
-        return _context.dispatcher().dispatch(context);
+        return _context.dispatcher().dispatch(context, site);
     }
 
     value evaluator::operator()(new_expression const& expression)
@@ -487,6 +494,11 @@ namespace puppet { namespace compiler { namespace evaluation {
     {
         _context.current_context(expression.context());
 
+        // Execute the lowered instructions if the expression was resolved
+        if (!expression.instructions.empty()) {
+            return execute(expression);
+        }
+
         // Climb the expression
         auto begin = expression.operations.begin();
         auto result = climb_expression(expression.operand, 0, begin, expression.operations.end());
@@ -551,8 +563,8 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     value evaluator::operator()(function_call_statement const& statement)
     {
-        // Find the function before executing the call to ensure it is imported
-        _context.find_function(statement.function.value);
+        // Resolve the call site before executing the call to ensure the function is imported
+        auto site = _context.call_site(statement.function);
 
         // Construct the call context and check to see if any of the arguments was a control transfer
         functions::call_context context{ _context, statement };
@@ -560,7 +572,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         if (transfer) {
             return rvalue_cast(*transfer);
         }
-        return _context.dispatcher().dispatch(context);
+        return _context.dispatcher().dispatch(context, site);
     }
 
     value evaluator::operator()(relationship_statement const& statement)
@@ -1176,16 +1188,17 @@ namespace puppet { namespace compiler { namespace evaluation {
             ++begin;
 
             // If the operator is a logical and/or operator, attempt short circuiting
+            unsigned int next = current + (is_right_associative(operation.operator_) ? 0 : 1);
             if ((operation.operator_ == binary_operator::logical_and && !lhs.first.is_truthy()) ||
                 (operation.operator_ == binary_operator::logical_or && lhs.first.is_truthy())) {
+                // Skip only the right-hand side; any lower precedence operations still apply to the result
                 lhs.first = operation.operator_ == binary_operator::logical_or;
-                lhs.second.end = operation.context().end;
-                begin = end;
-                break;
+                for (; begin != end && precedence(begin->operator_) >= next; ++begin);
+                lhs.second.end = (begin - 1)->context().end;
+                continue;
             }
 
             // Recurse and climb the right-hand side
-            unsigned int next = current + (is_right_associative(operation.operator_) ? 0 : 1);
             auto rhs = climb_expression(operation.operand, next, begin, end);
             if (rhs.first.is_transfer()) {
                 return rhs;
@@ -1214,6 +1227,78 @@ namespace puppet { namespace compiler { namespace evaluation {
         return lhs;
     }
 
+    value evaluator::execute(ast::expression const& expression)
+    {
+        using opcode = ast::instruction::opcode;
+
+        auto const& instructions = expression.instructions;
+        auto const& operations = expression.operations;
+        auto operand = [&](size_t index) -> postfix_expression const& {
+            return index == 0 ? expression.operand : operations[index - 1].operand;
+        };
+
+        boost::container::small_vector<std::pair<value, ast::context>, 4> stack;
+        for (size_t pc = 0; pc < instructions.size(); ++pc) {
+            auto const& instruction = instructions[pc];
+            switch (instruction.code) {
+                case opcode::operand: {
+                    auto const& current = operand(instruction.index);
+                    auto result = evaluate(current);
+                    if (result.is_transfer()) {
+                        return result;
+                    }
+                    stack.emplace_back(rvalue_cast(result), current.context());
+                    break;
+                }
+
+                case opcode::short_circuit: {
+                    auto& lhs = stack.back();
+                    bool is_or = operations[instruction.index].operator_ == binary_operator::logical_or;
+                    if (lhs.first.is_truthy() != is_or) {
+                        break;
+                    }
+
+                    // The result spans the skipped right-hand side, which ends with the last operand before the jump target
+                    lhs.first = is_or;
+                    auto last = instruction.target;
+                    while (instructions[--last].code != opcode::operand);
+                    lhs.second.end = operand(instructions[last].index).context().end;
+                    pc = instruction.target - 1;
+                    break;
+                }
+
+                case opcode::binary: {
+                    auto rhs = rvalue_cast(stack.back());
+                    stack.pop_back();
+                    auto& lhs = stack.back();
+                    auto const& operation = operations[instruction.index];
+
+                    // Dispatch the operator "call"
+                    binary::call_context context{
+                        _context,
+                        operation.operator_,
+                        ast::context{
+                            operation.operator_position,
+                            lexer::position{ operation.operator_position.offset() + 1, operation.operator_position.line() },
+                            rhs.second.tree
+                        },
+                        lhs.first,
+                        lhs.second,
+                        rhs.first,
+                        rhs.second
+                    };
+                    lhs.first = _context.dispatcher().dispatch(context);
+                    if (lhs.first.is_transfer()) {
+                        return rvalue_cast(lhs.first);
+                    }
+                    lhs.second.end = rhs.second.end;
+                    break;
+                }
+            }
+        }
+        return rvalue_cast(stack.back().first);
+    }
+
     void evaluator::align_text(std::string const& text, size_t margin, size_t& current_margin, function<void(char const*, size_t)> const& callback)
     {
         auto begin = text.begin();
@@ -1292,16 +1377,18 @@ namespace puppet { namespace compiler { namespace evaluation {
         _name(nullptr),
         _statement(&statement),
         _parameters(statement.parameters),
-        _body(statement.body)
+        _body(statement.body),
+        _frame(statement.frame)
     {
     }
 
-    function_evaluator::function_evaluator(evaluation::context& context, char const* name, vector<parameter> const& parameters, vector<statement> const& body) :
+    function_evaluator::function_evaluator(evaluation::context& context, char const* name, vector<parameter> const& parameters, vector<statement> const& body, shared_ptr<ast::frame const> frame) :
         _context(context),
         _name(name),
         _statement(nullptr),
         _parameters(parameters),
-        _body(body)
+        _body(body),
+        _frame(rvalue_cast(frame))
     {
     }
 
@@ -1325,7 +1412,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         }
 
         // Create a new scope and stack frame
-        auto scope = std::make_shared<evaluation::scope>(parent ? parent : _context.top_scope());
+        auto scope = std::make_shared<evaluation::scope>(parent ? parent : _context.top_scope(), nullptr, _frame);
         scoped_stack_frame frame = _name ?
             scoped_stack_frame{ _context, stack_frame{ _name, scope, false } } :
             scoped_stack_frame{ _context, stack_frame{ _statement, scope } };
@@ -1379,7 +1466,16 @@ namespace puppet { namespace compiler { namespace evaluation {
                 }
             }
 
-            if (scope->set(name, std::make_shared<values::value>(rvalue_cast(value)), parameter.variable)) {
+            // If the argument references a value, share it rather than copying it into the scope
+            shared_ptr<values::value const> shared_value;
+            auto variable = boost::get<values::variable>(&value);
+            if (variable && variable->shared_value()) {
+                shared_value = variable->shared_value();
+            } else {
+                shared_value = std::make_shared<values::value const>(rvalue_cast(value));
+            }
+
+            if (scope->set(name, rvalue_cast(shared_value), parameter.variable, scope->slot(parameter.variable))) {
                 throw evaluation_exception(
                     (boost::format("parameter $%1% already exists in the parameter list.") %
                      name
@@ -1396,7 +1492,7 @@ namespace puppet { namespace compiler { namespace evaluation {
     values::value function_evaluator::evaluate(values::hash& arguments, shared_ptr<scope> parent) const
     {
         // Create a new scope and stack frame
-        auto scope = std::make_shared<evaluation::scope>(parent ? parent : _context.top_scope());
+        auto scope = std::make_shared<evaluation::scope>(parent ? parent : _context.top_scope(), nullptr, _frame);
         scoped_stack_frame frame = _name ?
            scoped_stack_frame{ _context, stack_frame{ _name, scope } } :
            scoped_stack_frame{ _context, stack_frame{ _statement, scope } };
@@ -1429,7 +1525,7 @@ namespace puppet { namespace compiler { namespace evaluation {
                 throw evaluation_exception(rvalue_cast(message), parameter.default_value->context(), _context.backtrace());
             });
 
-            if (scope->set(name, std::make_shared<values::value>(rvalue_cast(value)), parameter.variable)) {
+            if (scope->set(name, std::make_shared<values::value>(rvalue_cast(value)), parameter.variable, scope->slot(parameter.variable))) {
                 throw evaluation_exception(
                     (boost::format("parameter $%1% already exists in the parameter list.") %
                      name
@@ -1480,7 +1576,7 @@ namespace puppet { namespace compiler { namespace evaluation {
                 throw argument_exception(rvalue_cast(message), index);
             });
 
-            if (scope->set(*name, std::make_shared<values::value>(rvalue_cast(kvp.value())), parameter->variable)) {
+            if (scope->set(*name, std::make_shared<values::value>(rvalue_cast(kvp.value())), parameter->variable, scope->slot(parameter->variable))) {
                 throw evaluation_exception(
                     (boost::format("parameter $%1% already exists in the parameter list.") %
                      *name
@@ -1503,16 +1599,16 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     void resource_evaluator::prepare_scope(evaluation::scope& scope, compiler::resource& resource) const
     {
-        // Set the title in the scope
+        // Set the title in the scope; resource frames always store the title and name in the first two slots
         shared_ptr<values::value const> title = std::make_shared<values::value const>(resource.type().title());
-        scope.set("title", title, resource.context());
+        scope.set("title", title, resource.context(), 0);
 
         // Set the name in the scope
         shared_ptr<values::value const> name = rvalue_cast(title);
         if (auto attribute = resource.get("name")) {
             name = attribute->shared_value();
         }
-        scope.set("name", rvalue_cast(name), resource.context());
+        scope.set("name", rvalue_cast(name), resource.context(), 1);
 
         // Verify the resource's attributes
         resource.each_attribute([&](compiler::attribute const& attribute) {
@@ -1595,7 +1691,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             });
 
             // Set the parameter in the scope
-            if (scope.set(name, rvalue_cast(value), context)) {
+            if (scope.set(name, rvalue_cast(value), context, scope.slot(parameter.variable))) {
                 throw evaluation_exception(
                     (boost::format("parameter $%1% already exists in the parameter list.") %
                      name
@@ -1620,7 +1716,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         if (!scope) {
             // Create a temporary stack frame to show the child calling into the parent if parent evaluation fails
             scoped_stack_frame frame{ _context, stack_frame{ &_statement, nullptr } };
-            scope = std::make_shared<evaluation::scope>(evaluate_parent(), &resource);
+            scope = std::make_shared<evaluation::scope>(evaluate_parent(), &resource, _statement.frame);
             _context.add_scope(scope);
             created = true;
         }
@@ -1666,7 +1762,7 @@ namespace puppet { namespace compiler { namespace evaluation {
     void defined_type_evaluator::evaluate(compiler::resource& resource) const
     {
         // Create a scope for evaluating the defined type
-        auto scope = std::make_shared<evaluation::scope>(_context.node_or_top(), &resource);
+        auto scope = std::make_shared<evaluation::scope>(_context.node_or_top(), &resource, _statement.frame);
         scoped_stack_frame frame{ _context, stack_frame{ &_statement, scope } };
 
         prepare_scope(*scope, resource);
@@ -1685,7 +1781,7 @@ namespace puppet { namespace compiler { namespace evaluation {
     {
         // Set the node scope for the remainder of the evaluation
         // Nodes don't have parameters, so nothing to prepare in scope
-        node_scope scope{ _context, resource };
+        node_scope scope{ _context, resource, _statement.frame };
 
         scoped_stack_frame frame{ _context, stack_frame{ &_statement, _context.node_scope() } };
 
@@ -35,10 +35,17 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         evaluate_arguments(statement.arguments);
     }
 
-    call_context::call_context(evaluation::context& context, ast::method_call_expression const& expression, values::value& instance, ast::context const& instance_context, bool splat) :
+    call_context::call_context(
+        evaluation::context& context,
+        ast::method_call_expression const& expression,
+        values::value& instance,
+        ast::context const& instance_context,
+        bool splat,
+        bool lazy) :
         _context(context),
         _name(expression.method),
-        _block(expression.lambda)
+        _block(expression.lambda),
+        _lazy(lazy)
     {
         // Capture the closure scope if there is a block
         if (_block) {
@@ -119,6 +126,47 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         return _arguments.at(index);
     }
 
+    shared_ptr<values::value const> call_context::share_argument(size_t index)
+    {
+        values::value& argument = _arguments.at(index);
+        if (!argument.as<values::array>() && !argument.as<values::hash>()) {
+            return nullptr;
+        }
+
+        // If the argument is a variable, share the variable's value
+        if (auto variable = boost::get<values::variable>(&argument)) {
+            auto shared = variable->shared_value();
+            while (shared) {
+                auto inner = boost::get<values::variable>(shared.get());
+                if (!inner) {
+                    break;
+                }
+                shared = inner->shared_value();
+            }
+            return shared;
+        }
+
+        // Otherwise, move the argument into a shared value and reference it
+        auto shared = std::make_shared<values::value const>(rvalue_cast(argument));
+        argument = values::variable{ string{}, shared };
+        return shared;
+    }
+
+    values::value call_context::share(shared_ptr<values::value const> const& owner, values::value const& element)
+    {
+        if (!owner) {
+            return element;
+        }
+
+        // Reference variable elements directly rather than nesting variables
+        if (auto variable = boost::get<values::variable>(&element)) {
+            return *variable;
+        }
+
+        // Alias the element so that it keeps the entire argument alive
+        return values::variable{ string{}, shared_ptr<values::value const>{ owner, &element } };
+    }
+
     ast::context const& call_context::argument_context(size_t index) const
     {
         return _argument_contexts.at(index);
@@ -143,8 +191,36 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         if (!_block) {
             return values::undef();
         }
-        function_evaluator evaluator{ _context, "<block>", _block->parameters, _block->body };
-        auto result = evaluator.evaluate(arguments, _closure_scope);
+        return invoke_block(_context, *_block, _closure_scope, arguments);
+    }
+
+    function<values::value(values::array&)> call_context::yielder() const
+    {
+        auto& context = _context;
+        auto block = _block ? &*_block : nullptr;
+        auto closure_scope = _closure_scope;
+
+        return [&context, block, closure_scope](values::array& arguments) -> values::value {
+            if (!block) {
+                return values::undef();
+            }
+            try {
+                return invoke_block(context, *block, closure_scope, arguments);
+            } catch (argument_exception const& ex) {
+                throw evaluation_exception(ex.what(), block->parameters[ex.index()].context(), context.backtrace());
+            }
+        };
+    }
+
+    bool call_context::lazy() const
+    {
+        return _lazy;
+    }
+
+    values::value call_context::invoke_block(evaluation::context& context, ast::lambda_expression const& block, shared_ptr<scope> const& closure_scope, values::array& arguments)
+    {
+        function_evaluator evaluator{ context, "<block>", block.parameters, block.body, block.frame };
+        auto result = evaluator.evaluate(arguments, closure_scope);
 
         // Check for "yield return" and return the contained value
         if (result.as<values::yield_return>()) {
@@ -3,12 +3,38 @@
 #include <puppet/compiler/evaluation/evaluator.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
 
 using namespace std;
 using namespace puppet::runtime;
 
 namespace puppet { namespace compiler { namespace evaluation { namespace functions {
 
+    static bool is_unconstrained(values::type const& type)
+    {
+        // The types of built-in function arguments only check the kind of the argument value
+        static values::type const types[] = {
+            argument_type<values::value>::create(),
+            argument_type<int64_t>::create(),
+            argument_type<double>::create(),
+            argument_type<bool>::create(),
+            argument_type<string>::create(),
+            argument_type<values::regex>::create(),
+            argument_type<values::type>::create(),
+            argument_type<values::array>::create(),
+            argument_type<values::hash>::create()
+        };
+        return find(begin(types), end(types), type) != end(types);
+    }
+
+    static int argument_kind(values::value const& argument)
+    {
+        if (auto variable = boost::get<values::variable>(&argument)) {
+            return argument_kind(variable->value());
+        }
+        return argument.which();
+    }
+
     descriptor::descriptor(string name, ast::function_statement const* statement) :
         _name(rvalue_cast(name)),
         _statement(statement)
@@ -35,18 +61,26 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
 
     void descriptor::add(string const& signature, callback_type callback)
     {
-        auto callable = values::type::parse_as<types::callable>(signature);
+        auto type = values::type::parse_cached(signature);
+        auto callable = type ? boost::get<types::callable>(&type->get()) : nullptr;
         if (!callable) {
             throw runtime_error((boost::format("function '%1%' cannot add an overload with invalid signature '%2%'.") % _name % signature).str());
         }
+        add(rvalue_cast(*callable), rvalue_cast(callback));
+    }
 
+    void descriptor::add(types::callable signature, callback_type callback)
+    {
         dispatch_descriptor descriptor;
-        descriptor.signature = rvalue_cast(*callable);
+        descriptor.unconstrained = all_of(signature.types().begin(), signature.types().end(), [](auto const& type) {
+            return is_unconstrained(*type);
+        });
+        descriptor.signature = rvalue_cast(signature);
         descriptor.callback = rvalue_cast(callback);
         _dispatch_descriptors.emplace_back(rvalue_cast(descriptor));
     }
 
-    values::value descriptor::dispatch(call_context& context) const
+    values::value descriptor::dispatch(call_context& context, call_site* site) const
     {
         auto& evaluation_context = context.context();
 
@@ -95,13 +129,20 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
 
         // Search for a dispatch descriptor with a matching signature
         // TODO: in the future, this should dispatch to the most specific overload rather than the first dispatchable overload
-        for (auto& descriptor : _dispatch_descriptors) {
-            if (descriptor.signature.can_dispatch(context)) {
+        bool matched = false;
+        for (size_t i = find_overload(context, site, matched); i < _dispatch_descriptors.size(); ++i) {
+            auto& descriptor = _dispatch_descriptors[i];
+            if (matched || descriptor.signature.can_dispatch(context)) {
+                if (site && !matched) {
+                    cache_overload(context, *site, i);
+                }
+
+                // Built-in functions do not define variables, so the frame shares the top scope rather than allocating a new one
                 scoped_stack_frame frame{
                     evaluation_context,
                     stack_frame{
                         _name.c_str(),
-                        make_shared<evaluation::scope>(evaluation_context.top_scope())
+                        evaluation_context.top_scope()
                     }
                 };
                 return descriptor.callback(context);
@@ -123,6 +164,79 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         );
     }
 
+    size_t descriptor::find_overload(call_context const& context, call_site const* site, bool& matched) const
+    {
+        auto& arguments = context.arguments();
+        auto argument_count = static_cast<int64_t>(arguments.size());
+        auto block = context.block();
+        int64_t block_parameter_count = block ? static_cast<int64_t>(block->parameters.size()) : -1;
+
+        // Reuse the call site's overload without checking types if the call has the same shape and argument kinds as the last call
+        if (site && site->reusable && site->arguments == argument_count && site->block_parameters == block_parameter_count) {
+            size_t index = 0;
+            for (; index < arguments.size(); ++index) {
+                if (argument_kind(arguments[index]) != site->kinds[index]) {
+                    break;
+                }
+            }
+            if (index == arguments.size()) {
+                matched = true;
+                return site->overload;
+            }
+        }
+
+        // Skip the overloads that cannot accept the call; the remaining overloads are still checked in order
+        size_t index = 0;
+        for (; index < _dispatch_descriptors.size(); ++index) {
+            if (accepts(_dispatch_descriptors[index].signature, argument_count, block_parameter_count)) {
+                break;
+            }
+        }
+        return index;
+    }
+
+    void descriptor::cache_overload(call_context const& context, call_site& site, size_t index) const
+    {
+        auto& arguments = context.arguments();
+        auto block = context.block();
+        site.arguments = static_cast<int64_t>(arguments.size());
+        site.block_parameters = block ? static_cast<int64_t>(block->parameters.size()) : -1;
+        site.overload = index;
+
+        // Earlier overloads that accept the call's shape rejected it; that only holds for the same argument kinds if they check nothing else
+        site.reusable = true;
+        for (size_t i = 0; i <= index; ++i) {
+            auto& descriptor = _dispatch_descriptors[i];
+            if (!descriptor.unconstrained && accepts(descriptor.signature, site.arguments, site.block_parameters)) {
+                site.reusable = false;
+                break;
+            }
+        }
+
+        site.kinds.clear();
+        if (site.reusable) {
+            for (auto& argument : arguments) {
+                site.kinds.push_back(argument_kind(argument));
+            }
+        }
+    }
+
+    bool descriptor::accepts(types::callable const& signature, int64_t argument_count, int64_t block_parameter_count)
+    {
+        if (argument_count < signature.min() || argument_count > signature.max()) {
+            return false;
+        }
+
+        types::callable const* block = nullptr;
+        bool required = false;
+        tie(block, required) = signature.block();
+        bool passed_block = block_parameter_count >= 0;
+        if ((!block && passed_block) || (block && required && !passed_block)) {
+            return false;
+        }
+        return !block || !passed_block || (block_parameter_count >= block->min() && block_parameter_count <= block->max());
+    }
+
     vector<descriptor::dispatch_descriptor const*> descriptor::check_argument_count(call_context const& context) const
     {
         auto& evaluation_context = context.context();
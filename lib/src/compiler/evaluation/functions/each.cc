@@ -15,6 +15,9 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
             values::array block_arguments(context.block()->parameters.size());
             int64_t index = 0;
 
+            // Share the elements of the argument with the block rather than copying them
+            auto shared = context.share_argument(0);
+
             boost::optional<values::value> transfer;
             boost::apply_visitor(
                 values::iteration_visitor{
@@ -22,19 +25,19 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                         if (key) {
                             if (block_arguments.size() == 1) {
                                 values::array pair(2);
-                                pair[0] = *key;
-                                pair[1] = value;
+                                pair[0] = call_context::share(shared, *key);
+                                pair[1] = call_context::share(shared, value);
                                 block_arguments[0] = rvalue_cast(pair);
                             } else {
-                                block_arguments[0] = *key;
-                                block_arguments[1] = value;
+                                block_arguments[0] = call_context::share(shared, *key);
+                                block_arguments[1] = call_context::share(shared, value);
                             }
                         } else {
                             if (block_arguments.size() == 1) {
-                                block_arguments[0] = value;
+                                block_arguments[0] = call_context::share(shared, value);
                             } else {
                                 block_arguments[0] = index++;
-                                block_arguments[1] = value;
+                                block_arguments[1] = call_context::share(shared, value);
                             }
                         }
                         auto result = context.yield(block_arguments);
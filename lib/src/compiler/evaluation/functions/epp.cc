@@ -1,11 +1,10 @@
 #include <puppet/compiler/evaluation/functions/epp.hpp>
 #include <puppet/compiler/evaluation/functions/call_context.hpp>
-#include <puppet/compiler/evaluation/functions/call_context.hpp>
 #include <puppet/compiler/lexer/lexer.hpp>
-#include <puppet/compiler/parser/parser.hpp>
 #include <puppet/compiler/evaluation/evaluator.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <boost/format.hpp>
+#include <sstream>
 
 using namespace std;
 using namespace puppet::runtime;
@@ -35,13 +34,10 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
             arguments = context.argument(1).move_as<values::hash>();
         }
 
+        shared_ptr<ast::syntax_tree> tree;
         try {
-            // Parse the EPP template
-            auto tree = parser::parse_file(logger, path, nullptr, true);
-            LOG(debug, "parsed EPP AST:\n-----\n%1%\n-----", *tree);
-
-            // Validate as EPP
-            tree->validate(true);
+            // Get the parsed and validated EPP template
+            tree = environment.parse_template(logger, path);
 
             // Create a local output stream
             ostringstream os;
@@ -53,18 +49,16 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
             return os.str();
         } catch (parse_exception const& ex) {
             // Log the underlying problem and then throw an error pointing at the argument
-            ifstream input{ path };
-            auto info = lexer::get_line_info(input, ex.begin().offset(), ex.end().offset() - ex.begin().offset());
-            logger.log(logging::level::error, ex.begin().line(), info.column, info.length, info.text, path, ex.what());
+            compilation_exception error{ ex, path };
+            logger.log(logging::level::error, error.line(), error.column(), error.length(), error.text(), path, ex.what());
             throw evaluation_exception(
                 "parsing of EPP template failed.",
                 context.argument_context(0),
                 context.context().backtrace()
             );
         } catch (evaluation_exception const& ex) {
-            ifstream input{ path };
             auto& c = ex.context();
-            auto info = lexer::get_line_info(input, c.begin.offset(), c.end.offset() - c.begin.offset());
+            auto info = tree->line_info(c.begin.offset(), c.end.offset() - c.begin.offset());
             logger.log(logging::level::error, c.begin.line(), info.column, info.length, info.text, path, ex.what());
             throw evaluation_exception(
                 "evaluation of EPP template failed.",
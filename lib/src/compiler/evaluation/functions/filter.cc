@@ -11,6 +11,9 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         values::array block_arguments(context.block()->parameters.size());
         values::hash result;
 
+        // Share the elements of the argument with the block rather than copying them
+        auto shared = context.share_argument(0);
+
         boost::optional<values::value> transfer;
         boost::apply_visitor(
             values::iteration_visitor{
@@ -20,12 +23,12 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                     }
                     if (block_arguments.size() == 1) {
                         values::array pair(2);
-                        pair[0] = *key;
-                        pair[1] = value;
+                        pair[0] = call_context::share(shared, *key);
+                        pair[1] = call_context::share(shared, value);
                         block_arguments[0] = rvalue_cast(pair);
                     } else {
-                        block_arguments[0] = *key;
-                        block_arguments[1] = value;
+                        block_arguments[0] = call_context::share(shared, *key);
+                        block_arguments[1] = call_context::share(shared, value);
                     }
                     auto filtered = context.yield(block_arguments);
                     if (filtered.as<values::break_iteration>()) {
@@ -38,6 +41,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                         return false;
                     }
                     if (filtered.is_true()) {
+                        // Store the element itself so that aliases of the argument do not escape into the result
                         result.set(*key, value);
                     }
                     return true;
@@ -51,18 +55,71 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         return result;
     }
 
+    static values::value filter_lazily(call_context& context)
+    {
+        auto& evaluation_context = context.context();
+        auto& argument = context.argument(0);
+        auto iterator = argument.as<values::iterator>();
+        bool keyed = iterator ? iterator->keyed() : static_cast<bool>(argument.as<values::hash>());
+
+        // Share the elements of the argument with the block rather than copying them
+        auto shared = context.share_argument(0);
+
+        values::iterator::stage_type stage = [&evaluation_context, yield = context.yielder(), parameters = context.block()->parameters.size(), shared](auto const& next) {
+            return [&evaluation_context, &next, yield, shared, block_arguments = values::array(parameters), index = static_cast<int64_t>(0)](auto const* key, auto const& value) mutable {
+                if (key) {
+                    if (block_arguments.size() == 1) {
+                        values::array pair(2);
+                        pair[0] = call_context::share(shared, *key);
+                        pair[1] = call_context::share(shared, value);
+                        block_arguments[0] = rvalue_cast(pair);
+                    } else {
+                        block_arguments[0] = call_context::share(shared, *key);
+                        block_arguments[1] = call_context::share(shared, value);
+                    }
+                } else {
+                    if (block_arguments.size() == 1) {
+                        block_arguments[0] = call_context::share(shared, value);
+                    } else {
+                        block_arguments[0] = index++;
+                        block_arguments[1] = call_context::share(shared, value);
+                    }
+                }
+
+                values::value filtered;
+                {
+                    scoped_stack_frame frame{ evaluation_context, stack_frame{ "filter", evaluation_context.top_scope() } };
+                    filtered = yield(block_arguments);
+                }
+                if (filtered.as<values::break_iteration>()) {
+                    // Break the iteration
+                    return false;
+                }
+                return !filtered.is_true() || next(key, value);
+            };
+        };
+        return values::iterator{ rvalue_cast(argument), rvalue_cast(stage), keyed };
+    }
+
     descriptor filter::create_descriptor()
     {
         functions::descriptor descriptor{ "filter" };
 
         descriptor.add("Callable[Iterable, 1, 1, Callable[1, 2]]", [](call_context& context) -> values::value {
+            // If the result is only iterated by another function, filter as the elements are iterated
+            if (context.lazy()) {
+                auto& argument = context.argument(0);
+                if (argument.as<values::array>() || argument.as<values::hash>() || argument.as<values::iterator>()) {
+                    return filter_lazily(context);
+                }
+            }
 
             // If a hash or iterating a hash, return a hash
             if (context.argument(0).as<values::hash>()) {
                 return iterate_hash(context);
             }
             if (auto iterator = context.argument(0).as<values::iterator>()) {
-                if (iterator->value().as<values::hash>()) {
+                if (iterator->keyed()) {
                     return iterate_hash(context);
                 }
             }
@@ -71,6 +128,9 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
             int64_t index = 0;
             values::array result;
 
+            // Share the elements of the argument with the block rather than copying them
+            auto shared = context.share_argument(0);
+
             boost::optional<values::value> transfer;
             boost::apply_visitor(
                 values::iteration_visitor{
@@ -79,10 +139,10 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                             throw runtime_error("expected a null key.");
                         }
                         if (block_arguments.size() == 1) {
-                            block_arguments[0] = value;
+                            block_arguments[0] = call_context::share(shared, value);
                         } else {
                             block_arguments[0] = index++;
-                            block_arguments[1] = value;
+                            block_arguments[1] = call_context::share(shared, value);
                         }
                         auto filtered = context.yield(block_arguments);
                         if (filtered.as<values::break_iteration>()) {
@@ -95,6 +155,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                             return false;
                         }
                         if (filtered.is_true()) {
+                            // Store the element itself so that aliases of the argument do not escape into the result
                             result.emplace_back(value);
                         }
                         return true;
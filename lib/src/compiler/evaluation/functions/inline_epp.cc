@@ -1,7 +1,6 @@
 #include <puppet/compiler/evaluation/functions/inline_epp.hpp>
 #include <puppet/compiler/evaluation/functions/call_context.hpp>
 #include <puppet/compiler/lexer/lexer.hpp>
-#include <puppet/compiler/parser/parser.hpp>
 #include <puppet/compiler/evaluation/evaluator.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <boost/format.hpp>
@@ -26,12 +25,8 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         static auto path = "<epp>";
 
         try {
-            // Parse the string as an EPP template
-            auto tree = parser::parse_string(logger, input, path, nullptr, true);
-            LOG(debug, "parsed inline EPP AST:\n-----\n%1%\n-----", *tree);
-
-            // Validate as EPP
-            tree->validate(true);
+            // Get the parsed and validated EPP template
+            auto tree = evaluation_context.node().environment().parse_inline_template(logger, input, path);
 
             // Create a local output stream
             ostringstream os;
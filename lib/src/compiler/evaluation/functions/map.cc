@@ -6,15 +6,69 @@ using namespace puppet::runtime;
 
 namespace puppet { namespace compiler { namespace evaluation { namespace functions {
 
+    static values::value map_lazily(call_context& context)
+    {
+        auto& evaluation_context = context.context();
+
+        // Share the elements of the argument with the block rather than copying them
+        auto shared = context.share_argument(0);
+
+        values::iterator::stage_type stage = [&evaluation_context, yield = context.yielder(), parameters = context.block()->parameters.size(), shared](auto const& next) {
+            return [&evaluation_context, &next, yield, shared, block_arguments = values::array(parameters), index = static_cast<int64_t>(0)](auto const* key, auto const& value) mutable {
+                if (key) {
+                    if (block_arguments.size() == 1) {
+                        values::array pair(2);
+                        pair[0] = call_context::share(shared, *key);
+                        pair[1] = call_context::share(shared, value);
+                        block_arguments[0] = rvalue_cast(pair);
+                    } else {
+                        block_arguments[0] = call_context::share(shared, *key);
+                        block_arguments[1] = call_context::share(shared, value);
+                    }
+                } else {
+                    if (block_arguments.size() == 1) {
+                        block_arguments[0] = call_context::share(shared, value);
+                    } else {
+                        block_arguments[0] = index++;
+                        block_arguments[1] = call_context::share(shared, value);
+                    }
+                }
+
+                values::value replacement;
+                {
+                    scoped_stack_frame frame{ evaluation_context, stack_frame{ "map", evaluation_context.top_scope() } };
+                    replacement = yield(block_arguments);
+                }
+                if (replacement.as<values::break_iteration>()) {
+                    // Break the iteration
+                    return false;
+                }
+                return next(nullptr, replacement);
+            };
+        };
+        return values::iterator{ rvalue_cast(context.argument(0)), rvalue_cast(stage), false };
+    }
+
     descriptor map::create_descriptor()
     {
         functions::descriptor descriptor{ "map" };
 
         descriptor.add("Callable[Iterable, 1, 1, Callable[1, 2]]", [](call_context& context) -> values::value {
+            // If the result is only iterated by another function, map as the elements are iterated
+            if (context.lazy()) {
+                auto& argument = context.argument(0);
+                if (argument.as<values::array>() || argument.as<values::hash>() || argument.as<values::iterator>()) {
+                    return map_lazily(context);
+                }
+            }
+
             values::array block_arguments(context.block()->parameters.size());
             int64_t index = 0;
             values::array result;
 
+            // Share the elements of the argument with the block rather than copying them
+            auto shared = context.share_argument(0);
+
             boost::optional<values::value> transfer;
             boost::apply_visitor(
                 values::iteration_visitor{
@@ -22,19 +76,19 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                         if (key) {
                             if (block_arguments.size() == 1) {
                                 values::array pair(2);
-                                pair[0] = *key;
-                                pair[1] = value;
+                                pair[0] = call_context::share(shared, *key);
+                                pair[1] = call_context::share(shared, value);
                                 block_arguments[0] = rvalue_cast(pair);
                             } else {
-                                block_arguments[0] = *key;
-                                block_arguments[1] = value;
+                                block_arguments[0] = call_context::share(shared, *key);
+                                block_arguments[1] = call_context::share(shared, value);
                             }
                         } else {
                             if (block_arguments.size() == 1) {
-                                block_arguments[0] = value;
+                                block_arguments[0] = call_context::share(shared, value);
                             } else {
                                 block_arguments[0] = index++;
-                                block_arguments[1] = value;
+                                block_arguments[1] = call_context::share(shared, value);
                             }
                         }
                         auto replacement = context.yield(block_arguments);
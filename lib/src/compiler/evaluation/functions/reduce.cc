@@ -19,27 +19,33 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                 memo = rvalue_cast(context.argument(1));
             }
 
+            // Share the elements of the argument with the block rather than copying them
+            auto shared = context.share_argument(0);
+
             boost::optional<values::value> transfer;
             boost::apply_visitor(
                 values::iteration_visitor{
                     [&](auto const* key, auto const& value) {
+                        // The first element becomes the memo, which may be returned, so it is stored rather than aliased
                         if (key) {
                             values::array pair(2);
-                            pair[0] = *key;
-                            pair[1] = value;
-
                             if (!memo) {
+                                pair[0] = *key;
+                                pair[1] = value;
                                 memo.emplace(rvalue_cast(pair));
                                 return true;
                             }
+                            pair[0] = call_context::share(shared, *key);
+                            pair[1] = call_context::share(shared, value);
                             block_arguments[1] = rvalue_cast(pair);
                         } else {
                             if (!memo) {
                                 memo = value;
                                 return true;
                             }
-                            block_arguments[1] = value;
+                            block_arguments[1] = call_context::share(shared, value);
                         }
+                        // Move the memo into the block; it is replaced by the block's result below
                         block_arguments[0] = rvalue_cast(*memo);
 
                         auto result = context.yield(block_arguments);
@@ -23,9 +23,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
     {
         functions::descriptor descriptor{ "split" };
 
-        descriptor.add("Callable[String, String]", [](call_context& context) -> values::value {
-            auto& first = context.argument(0).require<string>();
-            auto& second = context.argument(1).require<string>();
+        descriptor.add([](call_context& context, string const& first, string const& second) -> values::value {
             if (second.empty()) {
                 return split_characters(first);
             }
@@ -41,10 +39,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
             }
             return result;
         });
-        descriptor.add("Callable[String, Regexp]", [](call_context& context) -> values::value {
-            auto& first = context.argument(0).require<string>();
-            auto& second = context.argument(1).require<values::regex>();
-
+        descriptor.add([](call_context& context, string const& first, values::regex const& second) -> values::value {
             if (second.pattern().empty()) {
                 return split_characters(first);
             }
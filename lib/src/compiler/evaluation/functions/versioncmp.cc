@@ -11,11 +11,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
     {
         functions::descriptor descriptor{ "versioncmp" };
 
-        descriptor.add("Callable[String, String]", [](call_context& context) {
-            // Both arguments should be Strings
-            auto& version_a = context.argument(0).require<string>();
-            auto& version_b = context.argument(1).require<string>();
-
+        descriptor.add([](call_context& context, string const& version_a, string const& version_b) {
             // The regex used to split the version numbers into sub-sections
             static const utility::regex version_regex(R"([-.]|\d+|[^-.\d])");
             // The regex used to determine if all characters in a sub-section are numeric.
@@ -24,7 +24,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
         }
 
         // Set the variable in the current scope
-        auto previous = evaluation_context.current_scope()->set(variable.name(), shared_value, context.left_context());
+        auto previous = evaluation_context.current_scope()->set(variable.name(), shared_value, context.left_context(), variable.slot());
         if (previous) {
             if (previous->path()) {
                 throw evaluation_exception(
@@ -9,7 +9,8 @@ using namespace puppet::runtime;
 namespace puppet { namespace compiler { namespace evaluation { namespace operators { namespace binary {
 
     descriptor::descriptor(ast::binary_operator oper) :
-        _operator(oper)
+        _operator(oper),
+        _table(kind_count * kind_count)
     {
     }
 
@@ -25,16 +26,36 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
     void descriptor::add(string const& left_type, string const& right_type, callback_type callback)
     {
-        auto left = values::type::parse(left_type);
+        auto left = values::type::parse_cached(left_type);
         if (!left) {
             throw runtime_error((boost::format("binary operator '%1%' cannot add an overload with invalid left operand type '%2%'.") % _operator % left_type).str());
         }
 
-        auto right = values::type::parse(right_type);
+        auto right = values::type::parse_cached(right_type);
         if (!right) {
             throw runtime_error((boost::format("binary operator '%1%' cannot add an overload with invalid right operand type '%2%'.") % _operator % right_type).str());
         }
 
+        // Add the overload to the dispatch table for every combination of operand kinds it may accept
+        auto index = _dispatch_descriptors.size();
+        for (size_t left_kind = 0; left_kind < kind_count; ++left_kind) {
+            auto left_match = match_kind(*left, left_kind);
+            if (left_match == kind_match::never) {
+                continue;
+            }
+            for (size_t right_kind = 0; right_kind < kind_count; ++right_kind) {
+                auto right_match = match_kind(*right, right_kind);
+                if (right_match == kind_match::never) {
+                    continue;
+                }
+                add_candidate(
+                    _table[left_kind * kind_count + right_kind],
+                    index,
+                    (left_match == kind_match::always && right_match == kind_match::always) ? kind_match::always : kind_match::maybe
+                );
+            }
+        }
+
         dispatch_descriptor descriptor;
         descriptor.left_type = rvalue_cast(*left);
         descriptor.right_type = rvalue_cast(*right);
@@ -44,12 +65,13 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
     values::value descriptor::dispatch(call_context& context) const
     {
-
-        // Search for a dispatch descriptor with the matching left and right types
+        // Search the overloads that may accept the operand kinds for a dispatch descriptor with the matching left and right types
         // TODO: in the future, this should dispatch to the most specific overload rather than the first dispatchable overload
         types::recursion_guard guard;
-        for (auto& descriptor : _dispatch_descriptors) {
-            if (descriptor.left_type.is_instance(context.left(), guard) && descriptor.right_type.is_instance(context.right(), guard)) {
+        for (auto const& candidate : _table[kind_of(context.left()) * kind_count + kind_of(context.right())]) {
+            auto& descriptor = _dispatch_descriptors[candidate.index];
+            if (!candidate.check ||
+                (descriptor.left_type.is_instance(context.left(), guard) && descriptor.right_type.is_instance(context.right(), guard))) {
                 return descriptor.callback(context);
             }
         }
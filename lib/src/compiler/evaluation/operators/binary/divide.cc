@@ -3,7 +3,7 @@
 #include <puppet/compiler/exceptions.hpp>
 #include <boost/format.hpp>
 #include <limits>
-#include <cfenv>
+#include <cmath>
 
 using namespace std;
 using namespace puppet::runtime::values;
@@ -31,32 +31,42 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
         return left / right;
     }
 
+    static bool is_exact_quotient(double left, double right, double result)
+    {
+        // A subnormal quotient requires the dividend to be less than 4, so scaling keeps fma's exact remainder in range
+        return fma(ldexp(result, 512), right, -ldexp(left, 512)) == 0;
+    }
+
     static value divide_by(call_context& context, double left, double right)
     {
         auto& evaluation_context = context.context();
 
-        feclearexcept(FE_OVERFLOW | FE_UNDERFLOW | FE_DIVBYZERO);
-        double result = left / right;
-        if (fetestexcept(FE_DIVBYZERO)) {
+        // Check the operands and result rather than the floating point environment; zero or subnormal results underflowed only if precision was lost
+        if (right == 0 && isfinite(left) && left != 0) {
             throw evaluation_exception("cannot divide by zero.", context.right_context(), evaluation_context.backtrace());
-        } else if (fetestexcept(FE_OVERFLOW)) {
-            throw evaluation_exception(
-                (boost::format("division of %1% and %2% results in an arithmetic overflow.") %
-                 left %
-                 right
-                ).str(),
-                context.right_context(),
-                evaluation_context.backtrace()
-            );
-        } else if (fetestexcept(FE_UNDERFLOW)) {
-            throw evaluation_exception(
-                (boost::format("division of %1% and %2% results in an arithmetic underflow.") %
-                 left %
-                 right
-                ).str(),
-                context.right_context(),
-                evaluation_context.backtrace()
-            );
+        }
+        double result = left / right;
+        if (isfinite(left) && isfinite(right)) {
+            if (isinf(result)) {
+                throw evaluation_exception(
+                    (boost::format("division of %1% and %2% results in an arithmetic overflow.") %
+                     left %
+                     right
+                    ).str(),
+                    context.right_context(),
+                    evaluation_context.backtrace()
+                );
+            }
+            if ((result == 0 && left != 0) || (fpclassify(result) == FP_SUBNORMAL && !is_exact_quotient(left, right, result))) {
+                throw evaluation_exception(
+                    (boost::format("division of %1% and %2% results in an arithmetic underflow.") %
+                     left %
+                     right
+                    ).str(),
+                    context.right_context(),
+                    evaluation_context.backtrace()
+                );
+            }
         }
         return result;
     }
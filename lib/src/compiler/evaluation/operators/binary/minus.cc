@@ -2,8 +2,7 @@
 #include <puppet/compiler/evaluation/operators/binary/call_context.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <boost/format.hpp>
-#include <limits>
-#include <cfenv>
+#include <cmath>
 
 using namespace std;
 using namespace puppet::runtime;
@@ -14,39 +13,28 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
     {
         auto& evaluation_context = context.context();
 
-        if (right > 0) {
-            if (left < numeric_limits<int64_t>::min() + right) {
-                throw evaluation_exception(
-                    (boost::format("subtraction of %1% and %2% results in an arithmetic underflow.") %
-                     left %
-                     right
-                    ).str(),
-                    context.right_context(),
-                    evaluation_context.backtrace()
-                );
-            }
-        } else {
-            if (left > numeric_limits<int64_t>::max() + right) {
-                throw evaluation_exception(
-                    (boost::format("subtraction of %1% and %2% results in an arithmetic overflow.") %
-                     left %
-                     right
-                    ).str(),
-                    context.right_context(),
-                    evaluation_context.backtrace()
-                );
-            }
+        int64_t result;
+        if (__builtin_sub_overflow(left, right, &result)) {
+            throw evaluation_exception(
+                (boost::format("subtraction of %1% and %2% results in an arithmetic %3%.") %
+                 left %
+                 right %
+                 (right < 0 ? "overflow" : "underflow")
+                ).str(),
+                context.right_context(),
+                evaluation_context.backtrace()
+            );
         }
-        return left - right;
+        return result;
     }
 
     static values::value subtract(call_context& context, double left, double right)
     {
         auto& evaluation_context = context.context();
 
-        feclearexcept(FE_OVERFLOW | FE_UNDERFLOW);
+        // An infinite result of finite operands is an overflow; the difference of two doubles cannot inexactly underflow
         double result = left - right;
-        if (fetestexcept(FE_OVERFLOW)) {
+        if (isinf(result) && isfinite(left) && isfinite(right)) {
             throw evaluation_exception(
                 (boost::format("subtraction of %1% and %2% results in an arithmetic overflow.") %
                  left %
@@ -55,15 +43,6 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
                 context.right_context(),
                 evaluation_context.backtrace()
             );
-        } else if (fetestexcept(FE_UNDERFLOW)) {
-            throw evaluation_exception(
-                (boost::format("subtraction of %1% and %2% results in an arithmetic underflow.") %
-                 left %
-                 right
-                ).str(),
-                context.right_context(),
-                evaluation_context.backtrace()
-            );
         }
         return result;
     }
@@ -2,8 +2,8 @@
 #include <puppet/compiler/evaluation/operators/binary/call_context.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <boost/format.hpp>
-#include <limits>
-#include <cfenv>
+#include <cmath>
+#include <utility>
 
 using namespace std;
 using namespace puppet::runtime::values;
@@ -14,26 +14,19 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
     {
         auto& evaluation_context = context.context();
 
-        bool overflow = false;
-        bool underflow = false;
-        if (right > 0) {
-            if (left > (numeric_limits<int64_t>::max() / right)) {
-                overflow = true;
-            } else if (left < (numeric_limits<int64_t>::min() / right)) {
-                underflow = true;
+        int64_t result;
+        if (__builtin_mul_overflow(left, right, &result)) {
+            // Operands of differing signs underflow; otherwise the multiplication overflowed
+            if ((left < 0) != (right < 0)) {
+                throw evaluation_exception(
+                    (boost::format("multiplication of %1% and %2% results in an arithmetic underflow.") %
+                     left %
+                     right
+                    ).str(),
+                    context.right_context(),
+                    evaluation_context.backtrace()
+                );
             }
-        } else if (right < -1) {
-            if (left > (numeric_limits<int64_t>::min() / right)) {
-                underflow = true;
-            } else if (left < (numeric_limits<int64_t>::max() / right)) {
-                overflow = true;
-            }
-        } else if (right == -1) {
-            if (left == numeric_limits<int64_t>::min()) {
-                overflow = true;
-            }
-        }
-        if (overflow) {
             throw evaluation_exception(
                 (boost::format("multiplication of %1% and %2% results in an arithmetic overflow.") %
                  left %
@@ -43,43 +36,46 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
                 evaluation_context.backtrace()
             );
         }
-        if (underflow) {
-            throw evaluation_exception(
-                (boost::format("multiplication of %1% and %2% results in an arithmetic underflow.") %
-                 left %
-                 right
-                ).str(),
-                context.right_context(),
-                evaluation_context.backtrace()
-            );
+        return result;
+    }
+
+    static bool is_exact_product(double left, double right, double result)
+    {
+        // Scale the smaller operand (less than 2^-511 for a subnormal product) so that fma computes the exact rounding error of the product
+        if (fabs(left) > fabs(right)) {
+            swap(left, right);
         }
-        return left * right;
+        return fma(ldexp(left, 512), right, -ldexp(result, 512)) == 0;
     }
 
     static value multiply_by(call_context& context, double left, double right)
     {
         auto& evaluation_context = context.context();
 
-        feclearexcept(FE_OVERFLOW | FE_UNDERFLOW);
+        // Check the result rather than the floating point environment: infinite results of finite operands overflowed
+        // Zero or subnormal results underflowed only if precision was lost
         double result = left * right;
-        if (fetestexcept(FE_OVERFLOW)) {
-            throw evaluation_exception(
-                (boost::format("multiplication of %1% and %2% results in an arithmetic overflow.") %
-                 left %
-                 right
-                ).str(),
-                context.right_context(),
-                evaluation_context.backtrace()
-            );
-        } else if (fetestexcept(FE_UNDERFLOW)) {
-            throw evaluation_exception(
-                (boost::format("multiplication of %1% and %2% results in an arithmetic underflow.") %
-                 left %
-                 right
-                ).str(),
-                context.right_context(),
-                evaluation_context.backtrace()
-            );
+        if (isfinite(left) && isfinite(right)) {
+            if (isinf(result)) {
+                throw evaluation_exception(
+                    (boost::format("multiplication of %1% and %2% results in an arithmetic overflow.") %
+                     left %
+                     right
+                    ).str(),
+                    context.right_context(),
+                    evaluation_context.backtrace()
+                );
+            }
+            if ((result == 0 && left != 0 && right != 0) || (fpclassify(result) == FP_SUBNORMAL && !is_exact_product(left, right, result))) {
+                throw evaluation_exception(
+                    (boost::format("multiplication of %1% and %2% results in an arithmetic underflow.") %
+                     left %
+                     right
+                    ).str(),
+                    context.right_context(),
+                    evaluation_context.backtrace()
+                );
+            }
         }
         return result;
     }
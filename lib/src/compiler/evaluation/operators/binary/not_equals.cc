@@ -15,10 +15,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
             auto& left = context.left().require<std::string>();
             auto& right = context.right().require<std::string>();
 
-            if (left.size() < right.size()) {
-                return unicode::string{ left }.compare(right, true) != 0;
-            }
-            return unicode::string{ right }.compare(left, true) != 0;
+            return !unicode::equals(left, right, true);
         });
         descriptor.add("Type", "Type", [](call_context& context) {
             auto& left = context.left().require<values::type>();
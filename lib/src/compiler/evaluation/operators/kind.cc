@@ -0,0 +1,98 @@
+#include <puppet/compiler/evaluation/operators/kind.hpp>
+#include <boost/mpl/begin.hpp>
+#include <boost/mpl/distance.hpp>
+#include <boost/mpl/find.hpp>
+#include <limits>
+
+using namespace std;
+using namespace puppet::runtime;
+
+namespace puppet { namespace compiler { namespace evaluation { namespace operators {
+
+    template <typename T>
+    static constexpr size_t kind_index()
+    {
+        using kinds = values::value_base::types;
+        return boost::mpl::distance<typename boost::mpl::begin<kinds>::type, typename boost::mpl::find<kinds, T>::type>::value;
+    }
+
+    static bool is_any(values::type const& type)
+    {
+        return boost::get<types::any>(&type.get());
+    }
+
+    template <typename T>
+    static bool is_unbounded(T const& type)
+    {
+        return type.from() == 0 && type.to() == numeric_limits<int64_t>::max();
+    }
+
+    size_t kind_of(values::value const& value)
+    {
+        if (auto variable = boost::get<values::variable>(&value)) {
+            return kind_of(variable->value());
+        }
+        return static_cast<size_t>(value.which());
+    }
+
+    kind_match match_kind(values::type const& type, size_t kind)
+    {
+        // Returns always if the kinds are equal and the type is unconstrained, maybe if constrained, otherwise never
+        auto match = [&](size_t expected, bool unconstrained) {
+            if (kind != expected) {
+                return kind_match::never;
+            }
+            return unconstrained ? kind_match::always : kind_match::maybe;
+        };
+
+        auto& variant = type.get();
+        if (boost::get<types::any>(&variant)) {
+            return kind_match::always;
+        }
+        if (boost::get<types::numeric>(&variant)) {
+            return (kind == kind_index<int64_t>() || kind == kind_index<double>()) ? kind_match::always : kind_match::never;
+        }
+        if (auto integer = boost::get<types::integer>(&variant)) {
+            return match(kind_index<int64_t>(), integer->from() == numeric_limits<int64_t>::min() && integer->to() == numeric_limits<int64_t>::max());
+        }
+        if (auto floating = boost::get<types::floating>(&variant)) {
+            return match(kind_index<double>(), floating->from() == numeric_limits<double>::lowest() && floating->to() == numeric_limits<double>::max());
+        }
+        if (boost::get<types::boolean>(&variant)) {
+            return match(kind_index<bool>(), true);
+        }
+        if (auto string = boost::get<types::string>(&variant)) {
+            return match(kind_index<std::string>(), is_unbounded(*string));
+        }
+        if (auto regexp = boost::get<types::regexp>(&variant)) {
+            return match(kind_index<values::regex>(), regexp->pattern().empty());
+        }
+        if (auto array = boost::get<types::array>(&variant)) {
+            return match(kind_index<values::array>(), is_unbounded(*array) && is_any(array->element_type()));
+        }
+        if (auto hash = boost::get<types::hash>(&variant)) {
+            return match(kind_index<values::hash>(), is_unbounded(*hash) && is_any(hash->key_type()) && is_any(hash->value_type()));
+        }
+        if (boost::get<types::undef>(&variant)) {
+            return match(kind_index<values::undef>(), true);
+        }
+        if (boost::get<types::defaulted>(&variant)) {
+            return match(kind_index<values::defaulted>(), true);
+        }
+
+        // Other types require a full instance check
+        return kind_match::maybe;
+    }
+
+    void add_candidate(vector<kind_candidate>& candidates, size_t index, kind_match match)
+    {
+        if (match == kind_match::never) {
+            return;
+        }
+        if (!candidates.empty() && !candidates.back().check) {
+            return;
+        }
+        candidates.push_back({ index, match == kind_match::maybe });
+    }
+
+}}}}  // namespace puppet::compiler::evaluation::operators
@@ -9,7 +9,8 @@ using namespace puppet::runtime;
 namespace puppet { namespace compiler { namespace evaluation { namespace operators { namespace unary {
 
     descriptor::descriptor(ast::unary_operator oper) :
-        _operator(oper)
+        _operator(oper),
+        _table(kind_count)
     {
     }
 
@@ -25,11 +26,17 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
     void descriptor::add(string const& type, callback_type callback)
     {
-        auto operand_type = values::type::parse(type);
+        auto operand_type = values::type::parse_cached(type);
         if (!operand_type) {
             throw runtime_error((boost::format("unary operator '%1%' cannot add an overload with invalid operand type '%2%'.") % _operator % type).str());
         }
 
+        // Add the overload to the dispatch table for every operand kind it may accept
+        auto index = _dispatch_descriptors.size();
+        for (size_t kind = 0; kind < kind_count; ++kind) {
+            add_candidate(_table[kind], index, match_kind(*operand_type, kind));
+        }
+
         dispatch_descriptor descriptor;
         descriptor.type = rvalue_cast(*operand_type);
         descriptor.callback = rvalue_cast(callback);
@@ -38,11 +45,12 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
     values::value descriptor::dispatch(call_context& context) const
     {
-        // Search for a dispatch descriptor with a matching operand type
+        // Search the overloads that may accept the operand kind for a dispatch descriptor with a matching operand type
         // TODO: in the future, this should dispatch to the most specific overload rather than the first dispatchable overload
         types::recursion_guard guard;
-        for (auto& descriptor : _dispatch_descriptors) {
-            if (descriptor.type.is_instance(context.operand(), guard)) {
+        for (auto const& candidate : _table[kind_of(context.operand())]) {
+            auto& descriptor = _dispatch_descriptors[candidate.index];
+            if (!candidate.check || descriptor.type.is_instance(context.operand(), guard)) {
                 return descriptor.callback(context);
             }
         }
@@ -21,11 +21,14 @@ namespace puppet { namespace compiler { namespace evaluation {
             _value_context = expression.operand.context();
             _splat = expression.is_splat();
 
-            for (auto const& operation : expression.operations) {
+            auto& operations = expression.operations;
+            _operations = &operations;
+            for (_index = 0; _index < operations.size(); ++_index) {
                 if (_value.is_transfer()) {
                     break;
                 }
-                boost::apply_visitor(*this, operation);
+                _next = _index + 1 < operations.size() ? &operations[_index + 1] : nullptr;
+                boost::apply_visitor(*this, operations[_index]);
                 _splat = false;
             }
         }
@@ -98,16 +101,25 @@ namespace puppet { namespace compiler { namespace evaluation {
 
         void operator()(method_call_expression const& expression)
         {
-            // Find the function before executing the call to ensure it is imported
-            _evaluator.context().find_function(expression.method.value);
+            // Resolve the call site before executing the call to ensure the function is imported
+            auto site = _evaluator.context().call_site(expression.method);
+
+            // Remember the value at the start of a lazy pipeline in case the pipeline must be evaluated eagerly
+            bool lazy = is_lazy(expression);
+            if (lazy && !_pipeline) {
+                _pipeline = std::make_pair(_value, _value_context);
+                _pipeline_start = _index;
+            }
 
             // Construct the call context and check to see if any of the arguments evaluated to a control transfer
-            functions::call_context context{ _evaluator.context(), expression, _value, _value_context, _splat };
+            functions::call_context context{ _evaluator.context(), expression, _value, _value_context, _splat, lazy };
             auto& transfer = context.transfer();
             if (transfer) {
                 _value = rvalue_cast(*transfer);
+            } else if (lazy || !_pipeline) {
+                _value = _evaluator.context().dispatcher().dispatch(context, site);
             } else {
-                _value = _evaluator.context().dispatcher().dispatch(context);
+                _value = consume(context, site);
             }
             _value_context.end = expression.context().end;
         }
@@ -118,10 +130,62 @@ namespace puppet { namespace compiler { namespace evaluation {
         }
 
      private:
+        bool is_lazy(method_call_expression const& expression) const
+        {
+            // A map or filter may produce its result lazily when a pure block is given and the result is only iterated by the next call
+            auto& name = expression.method.value;
+            if ((name != "map" && name != "filter") || !is_pure(expression) || _splat || !_next) {
+                return false;
+            }
+            auto next = boost::get<ast::forward_node<method_call_expression>>(_next);
+            if (!next) {
+                return false;
+            }
+
+            // The next call must also be pure so that interleaving the blocks cannot reorder any side effects
+            auto& next_name = next->get().method.value;
+            return (next_name == "map" || next_name == "filter" || next_name == "reduce") && is_pure(next->get());
+        }
+
+        static bool is_pure(method_call_expression const& expression)
+        {
+            return expression.lambda && expression.lambda->pure && expression.arguments.empty();
+        }
+
+        value consume(functions::call_context& context, functions::call_site* site)
+        {
+            auto& evaluation_context = _evaluator.context();
+            auto& dispatcher = evaluation_context.dispatcher();
+
+            auto pipeline = rvalue_cast(*_pipeline);
+            _pipeline = boost::none;
+
+            try {
+                return dispatcher.dispatch(context, site);
+            } catch (evaluation_exception const&) {
+                // Interleaving the blocks may raise a different evaluation error than eager evaluation would
+                // Every block in the pipeline is pure, so evaluate it again eagerly to raise the same error
+            }
+
+            for (size_t i = _pipeline_start; i < _index; ++i) {
+                auto& stage = boost::get<ast::forward_node<method_call_expression>>((*_operations)[i]).get();
+                functions::call_context stage_context{ evaluation_context, stage, pipeline.first, pipeline.second, false };
+                pipeline.first = dispatcher.dispatch(stage_context, evaluation_context.call_site(stage.method));
+                pipeline.second.end = stage.context().end;
+            }
+            context.argument(0) = rvalue_cast(pipeline.first);
+            return dispatcher.dispatch(context, site);
+        }
+
         evaluator _evaluator;
         value _value;
         ast::context _value_context;
         bool _splat;
+        vector<postfix_operation> const* _operations = nullptr;
+        size_t _index = 0;
+        postfix_operation const* _next = nullptr;
+        boost::optional<std::pair<value, ast::context>> _pipeline;
+        size_t _pipeline_start = 0;
     };
 
     postfix_evaluator::postfix_evaluator(evaluation::context& context) :
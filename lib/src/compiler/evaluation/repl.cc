@@ -91,12 +91,16 @@ namespace puppet { namespace compiler { namespace evaluation {
             tree->statements.emplace_back();
             auto& statement = tree->statements.front();
 
-            bool success = x3::parse(
-                token_begin,
-                token_end,
-                x3::with<compiler::parser::tree_context_tag>(tree.get())[compiler::parser::statement],
-                statement
-            );
+            bool success = false;
+            {
+                ast::scoped_arena arena{ &tree->arena() };
+                success = x3::parse(
+                    token_begin,
+                    token_end,
+                    x3::with<compiler::parser::tree_context_tag>(tree.get())[compiler::parser::statement],
+                    statement
+                );
+            }
             if (success && (token_begin == token_end || token_begin->id() == boost::lexer::npos)) {
                 // Copy the source into the tree
                 tree->source(_buffer);
@@ -30,13 +30,17 @@ namespace puppet { namespace compiler { namespace evaluation {
         return _line;
     }
 
-    scope::scope(shared_ptr<scope> parent, compiler::resource* resource) :
+    scope::scope(shared_ptr<scope> parent, compiler::resource* resource, shared_ptr<ast::frame const> frame) :
         _parent(rvalue_cast(parent)),
-        _resource(resource)
+        _resource(resource),
+        _frame(rvalue_cast(frame))
     {
         if (!_parent) {
             throw runtime_error("expected a parent scope.");
         }
+        if (_frame) {
+            _slots.resize(_frame->size());
+        }
     }
 
     scope::scope(shared_ptr<facts::provider> facts) :
@@ -81,7 +85,12 @@ namespace puppet { namespace compiler { namespace evaluation {
         return _resource->type().title() + "::" + name;
     }
 
-    assignment_context const* scope::set(string name, shared_ptr<values::value const> value, ast::context const& context)
+    assignment_context const* scope::set(string name, shared_ptr<values::value const> value, ast::context const& context, size_t slot)
+    {
+        return set(symbol{ name }, rvalue_cast(value), context, slot);
+    }
+
+    assignment_context const* scope::set(symbol const& name, shared_ptr<values::value const> value, ast::context const& context, size_t slot)
     {
         static assignment_context no_context(nullptr);
 
@@ -98,20 +107,37 @@ namespace puppet { namespace compiler { namespace evaluation {
                 return &no_context;
             }
         }
-        _variables.emplace(rvalue_cast(name), make_pair(rvalue_cast(value), assignment_context(&context)));
+        // Local variables of the frame are also stored in their slot
+        if (slot < _slots.size()) {
+            _slots[slot] = value;
+        }
+        _variables.emplace(name, make_pair(rvalue_cast(value), assignment_context(&context)));
         return nullptr;
     }
 
     shared_ptr<values::value const> scope::get(string const& name)
     {
-        auto it = _variables.find(name);
-        if (it != _variables.end()) {
-            return it->second.first;
+        // A name that was never interned cannot be set in any scope, but may still be a fact
+        return get(symbol::find(name), name);
+    }
+
+    shared_ptr<values::value const> scope::get(symbol const& name)
+    {
+        return get(name, name.name());
+    }
+
+    shared_ptr<values::value const> scope::get(symbol const& symbol, string const& name)
+    {
+        if (symbol) {
+            auto it = _variables.find(symbol);
+            if (it != _variables.end()) {
+                return it->second.first;
+            }
         }
 
         // Go up the parent if there is one
         if (_parent) {
-            return _parent->get(name);
+            return _parent->get(symbol, name);
         }
 
         // Lookup the fact if there's a fact provider
@@ -121,8 +147,35 @@ namespace puppet { namespace compiler { namespace evaluation {
         return _facts->lookup(name);
     }
 
+    size_t scope::slot(ast::variable const& variable) const
+    {
+        auto& resolution = variable.resolution;
+        if (!resolution || !resolution->frame || resolution->frame != _frame.get()) {
+            return ast::frame::npos;
+        }
+        return resolution->slot;
+    }
+
+    ast::frame const* scope::frame() const
+    {
+        return _frame.get();
+    }
+
+    shared_ptr<values::value const> const& scope::get(size_t slot) const
+    {
+        return _slots[slot];
+    }
+
     void scope::add_defaults(evaluation::context& context, types::resource const& type, compiler::attributes attributes)
     {
+        // Defaults are resolved through the scope, so let the catalog's index know which attributes it cannot answer for
+        if (context.has_catalog()) {
+            auto& index = context.catalog().index();
+            for (auto const& attribute : attributes) {
+                index.add_default(type.type_name(), attribute.second->name());
+            }
+        }
+
         auto it = _defaults.find(type.type_name());
         if (it != _defaults.end()) {
             // The defaults already exist, so ensure there are no conflicts at this scope
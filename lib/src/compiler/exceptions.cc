@@ -27,6 +27,14 @@ namespace puppet { namespace compiler {
     {
     }
 
+    parse_exception::parse_exception(parse_exception const& ex, shared_ptr<ast::syntax_tree const> tree) :
+        runtime_error(ex.what()),
+        _begin(ex.begin()),
+        _end(ex.end()),
+        _tree(rvalue_cast(tree))
+    {
+    }
+
     lexer::position const& parse_exception::begin() const
     {
         return _begin;
@@ -37,6 +45,11 @@ namespace puppet { namespace compiler {
         return _end;
     }
 
+    ast::syntax_tree const* parse_exception::tree() const
+    {
+        return _tree.get();
+    }
+
     string parse_exception::format_message(lexer::token_id id)
     {
         return (boost::format("syntax error: unexpected %1%.") % id).str();
@@ -124,20 +137,16 @@ namespace puppet { namespace compiler {
         _column(0),
         _length(0)
     {
-        if (source.empty()) {
-            ifstream input{path};
-            if (input) {
-                auto info = lexer::get_line_info(input, ex.begin().offset(), ex.end().offset() - ex.begin().offset());
-                _text = rvalue_cast(info.text);
-                _column = info.column;
-                _length = info.length;
-            }
-        } else {
-            auto info = lexer::get_line_info(source, ex.begin().offset(), ex.end().offset() - ex.begin().offset());
-            _text = rvalue_cast(info.text);
-            _column = info.column;
-            _length = info.length;
+        lexer::line_info info;
+        auto length = ex.end().offset() - ex.begin().offset();
+        if (auto tree = ex.tree()) {
+            info = tree->line_info(ex.begin().offset(), length);
+        } else if (!source.empty()) {
+            info = lexer::get_line_info(source, ex.begin().offset(), length);
         }
+        _text = rvalue_cast(info.text);
+        _column = info.column;
+        _length = info.length;
     }
 
     compilation_exception::compilation_exception(evaluation_exception const& ex) :
@@ -151,20 +160,10 @@ namespace puppet { namespace compiler {
         if (context.tree) {
             _path = context.tree->path();
             _line = context.begin.line();
-            if (context.tree->source().empty()) {
-                ifstream input{ _path };
-                if (input) {
-                    auto info = lexer::get_line_info(input, context.begin.offset(), context.end.offset() - context.begin.offset());
-                    _text = rvalue_cast(info.text);
-                    _column = info.column;
-                    _length = info.length;
-                }
-            } else {
-                auto info = lexer::get_line_info(context.tree->source(), context.begin.offset(), context.end.offset() - context.begin.offset());
-                _text = rvalue_cast(info.text);
-                _column = info.column;
-                _length = info.length;
-            }
+            auto info = context.tree->line_info(context.begin.offset(), context.end.offset() - context.begin.offset());
+            _text = rvalue_cast(info.text);
+            _column = info.column;
+            _length = info.length;
         }
     }
 
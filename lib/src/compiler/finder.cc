@@ -57,6 +57,34 @@ namespace puppet { namespace compiler {
         }
     }
 
+    static void index_directory(find_type type, fs::path const& directory, string const& prefix, unordered_map<string, string>& files, unordered_set<string>& links)
+    {
+        auto ext = extension(type);
+
+        sys::error_code ec;
+        for (fs::directory_iterator it{ directory, ec }, end; !ec && it != end; it.increment(ec)) {
+            auto status = it->status(ec);
+            if (ec) {
+                ec.clear();
+                continue;
+            }
+            auto name = it->path().filename().string();
+            if (fs::is_directory(status)) {
+                // Don't descend into symbolic links to directories; they may form cycles or lead to arbitrarily large trees
+                if (fs::is_symlink(it->symlink_status(ec))) {
+                    links.emplace(prefix + name);
+                    continue;
+                }
+                index_directory(type, it->path(), prefix + name + '/', files, links);
+                continue;
+            }
+            if (!fs::is_regular_file(status) || (ext && it->path().extension() != ext)) {
+                continue;
+            }
+            files.emplace(prefix + name, it->path().string());
+        }
+    }
+
     static bool each_file(find_type type, fs::path const& directory, std::locale const& locale, function<bool(string const&)> const& callback)
     {
         auto ext = extension(type);
@@ -94,7 +122,8 @@ namespace puppet { namespace compiler {
     }
 
     finder::finder(string directory, compiler::settings const* settings) :
-        _directory(rvalue_cast(directory))
+        _directory(rvalue_cast(directory)),
+        _indexes(make_shared<array<file_index, 5>>())
     {
         if (settings) {
             auto manifest = settings->get(settings::manifest);
@@ -120,10 +149,8 @@ namespace puppet { namespace compiler {
             return {};
         }
 
-        // Start with the base
-        auto path = base_path(*this, type);
-
         // Split the name on '::' and treat all but the last component as a subdirectory
+        fs::path path;
         boost::split_iterator<string::const_iterator> end;
         for (auto it = boost::make_split_iterator(name, boost::first_finder("::", boost::is_equal())); it != end; ++it) {
             path.append(it->begin(), it->end());
@@ -133,12 +160,8 @@ namespace puppet { namespace compiler {
             path.replace_extension(ext);
         }
 
-        // Otherwise, check that the file exists
-        sys::error_code ec;
-        if (!fs::is_regular_file(path, ec)) {
-            return {};
-        }
-        return path.string();
+        // Look up the relative path in the index rather than checking the file system
+        return find(type, path.generic_string());
     }
 
     string finder::find_by_path(find_type type, string const& subpath) const
@@ -147,13 +170,23 @@ namespace puppet { namespace compiler {
             return {};
         }
 
-        auto path = base_path(*this, type) / subpath;
-        // Otherwise, check that the file exists
-        sys::error_code ec;
-        if (!fs::is_regular_file(path, ec)) {
-            return {};
+        // Paths that may leave the base directory cannot be answered by the index, so check the file system
+        fs::path relative;
+        for (auto const& part : fs::path{ subpath }.lexically_normal()) {
+            if (part != ".") {
+                relative /= part;
+            }
         }
-        return path.string();
+        if (relative.is_absolute() || (!relative.empty() && *relative.begin() == "..")) {
+            auto path = base_path(*this, type) / subpath;
+            sys::error_code ec;
+            if (!fs::is_regular_file(path, ec)) {
+                return {};
+            }
+            return path.string();
+        }
+
+        return find(type, relative.generic_string());
     }
 
     void finder::each_file(find_type type, function<bool(string const&)> const& callback) const
@@ -177,4 +210,40 @@ namespace puppet { namespace compiler {
         compiler::each_file(type, base, locale, callback);
     }
 
+    finder::file_index const& finder::index(find_type type) const
+    {
+        auto& index = (*_indexes)[static_cast<size_t>(type)];
+        call_once(index.built, [&]() {
+            auto base = base_path(*this, type);
+            sys::error_code ec;
+            if (fs::is_directory(base, ec)) {
+                index_directory(type, base, {}, index.files, index.links);
+            }
+        });
+        return index;
+    }
+
+    string finder::find(find_type type, string const& relative) const
+    {
+        auto& index = this->index(type);
+        auto it = index.files.find(relative);
+        if (it != index.files.end()) {
+            return it->second;
+        }
+
+        // Check the file system only for paths beneath a symbolic link to a directory
+        for (auto separator = relative.find('/'); separator != string::npos; separator = relative.find('/', separator + 1)) {
+            if (!index.links.count(relative.substr(0, separator))) {
+                continue;
+            }
+            auto path = base_path(*this, type) / relative;
+            sys::error_code ec;
+            if (!fs::is_regular_file(path, ec)) {
+                return {};
+            }
+            return path.string();
+        }
+        return {};
+    }
+
 }}  // namespace puppet::compiler
@@ -41,6 +41,16 @@ namespace puppet { namespace compiler { namespace lexer {
         return range.end();
     }
 
+    lexer_buffer_iterator lex_begin(utility::filesystem::mapped_file const& file)
+    {
+        return lexer_buffer_iterator(file.begin());
+    }
+
+    lexer_buffer_iterator lex_end(utility::filesystem::mapped_file const& file)
+    {
+        return lexer_buffer_iterator(file.end());
+    }
+
     struct scoped_file_position
     {
         scoped_file_position(ifstream& fs) :
@@ -136,28 +146,32 @@ namespace puppet { namespace compiler { namespace lexer {
         return info;
     }
 
-    line_info get_line_info(std::string const& input, size_t position, size_t length, size_t tab_width)
+    static line_info get_buffer_line_info(char const* data, size_t size, size_t position, size_t length, size_t tab_width)
     {
         // Truncate to the end if needed
-        if (position > input.size()) {
-            position = input.size() - 1;
+        if (position > size) {
+            position = size - 1;
         }
 
         // Find the starting newline by walking backwards from the given position
-        auto start = input.rfind('\n', position == 0 ? 0 : position - 1);
-        if (start == string::npos) {
+        boost::string_ref input{ data, size };
+        auto start = input.substr(0, position == 0 ? 1 : position).rfind('\n');
+        if (start == boost::string_ref::npos) {
             start = 0;
         } else {
             ++start;
         }
 
         // Find the ending newline by walking forward from the start
-        auto end = input.find('\n', start);
+        auto end = input.substr(start).find('\n');
+        if (end != boost::string_ref::npos) {
+            end += start;
+        }
 
         line_info info;
 
         // Use a unicode string to count graphemes
-        info.text = input.substr(start, end == string::npos ? end : end - start);
+        info.text = input.substr(start, end == boost::string_ref::npos ? end : end - start).to_string();
         unicode::string unicode_text{ info.text };
 
         // The column is 1-based, so start at 1
@@ -181,6 +195,21 @@ namespace puppet { namespace compiler { namespace lexer {
         return info;
     }
 
+    line_info get_line_info(std::string const& input, size_t position, size_t length, size_t tab_width)
+    {
+        return get_buffer_line_info(input.data(), input.size(), position, length, tab_width);
+    }
+
+    line_info get_line_info(utility::filesystem::mapped_file const& input, size_t position, size_t length, size_t tab_width)
+    {
+        return get_buffer_line_info(input.data(), input.size(), position, length, tab_width);
+    }
+
+    line_info get_line_info(boost::string_ref const& input, size_t position, size_t length, size_t tab_width)
+    {
+        return get_buffer_line_info(input.data(), input.size(), position, length, tab_width);
+    }
+
     position get_last_position(ifstream& input)
     {
         // We need to read the entire file looking for new lines
@@ -205,11 +234,12 @@ namespace puppet { namespace compiler { namespace lexer {
         return position(offset, line);
     }
 
-    position get_last_position(string const& input)
+    template <typename Iterator>
+    static position get_last_position(Iterator begin, Iterator end)
     {
         std::size_t offset = 0, line = 1;
         std::size_t current_offset = 0, current_line = 1;
-        for (auto it = input.begin(); it != input.end(); ++it) {
+        for (auto it = begin; it != end; ++it) {
             if (*it == '\n') {
                 ++current_line;
             }
@@ -224,6 +254,16 @@ namespace puppet { namespace compiler { namespace lexer {
         return position(offset, line);
     }
 
+    position get_last_position(string const& input)
+    {
+        return get_last_position(input.begin(), input.end());
+    }
+
+    position get_last_position(utility::filesystem::mapped_file const& input)
+    {
+        return get_last_position(input.begin(), input.end());
+    }
+
     position get_last_position(boost::iterator_range<lexer_string_iterator> const& range)
     {
         // Get the last position in the range (end is non-inclusive)
@@ -12,8 +12,8 @@ namespace puppet { namespace compiler { namespace lexer {
     }
 
     position::position(size_t offset, size_t line) :
-        _offset(offset),
-        _line(line)
+        _offset(static_cast<uint32_t>(offset)),
+        _line(static_cast<uint32_t>(line))
     {
     }
 
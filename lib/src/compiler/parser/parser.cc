@@ -3,10 +3,11 @@
 #include <puppet/compiler/lexer/static_lexer.hpp>
 #include <puppet/compiler/lexer/lexer.hpp>
 #include <puppet/compiler/exceptions.hpp>
+#include <puppet/utility/filesystem/mapped_file.hpp>
 #include <puppet/cast.hpp>
 #include <sstream>
-#include <fstream>
 #include <iomanip>
+#include <limits>
 
 using namespace std;
 using namespace puppet::compiler::lexer;
@@ -31,6 +32,9 @@ namespace puppet { namespace compiler { namespace parser {
     {
         namespace x3 = boost::spirit::x3;
 
+        // Allocate the parsed nodes from the tree's arena
+        ast::scoped_arena arena{ &tree.arena() };
+
         try {
             // Get lexer iterators from the input
             auto begin = lex_begin(input);
@@ -55,6 +59,7 @@ namespace puppet { namespace compiler { namespace parser {
                 if (epp) {
                     check_missing_epp_end(begin);
                 }
+                tree.resolve();
                 return;
             }
 
@@ -81,39 +86,55 @@ namespace puppet { namespace compiler { namespace parser {
     shared_ptr<ast::syntax_tree> parse_file(logging::logger& logger, std::string path, compiler::module const* module, bool epp)
     {
         auto tree = ast::syntax_tree::create(rvalue_cast(path), module);
-        ifstream input(tree->path());
-        if (!input) {
+
+        // Map the file into memory so that it can be lexed without buffering through a stream
+        auto input = make_shared<utility::filesystem::mapped_file const>(tree->path());
+        if (!*input) {
             throw compilation_exception((boost::format("file '%1%' does not exist or cannot be read.") % tree->path()).str());
         }
+        if (input->size() > numeric_limits<uint32_t>::max()) {
+            throw compilation_exception((boost::format("file '%1%' is too large to parse.") % tree->path()).str());
+        }
 
-        file_static_lexer lexer{ [&](logging::level level, std::string const& message, lexer::position const& position, size_t length) {
+        // The tree keeps the mapping so that diagnostics are resolved from memory
+        tree->source(input);
+
+        buffer_static_lexer lexer{ [&](logging::level level, std::string const& message, lexer::position const& position, size_t length) {
             if (!logger.would_log(level)) {
                 return;
             }
 
-            auto info = lexer::get_line_info(input, position.offset(), length);
+            auto info = tree->line_info(position.offset(), length);
             logger.log(level, position.line(), info.column, info.length, info.text, tree->path(), message);
         }};
 
-        parse(lexer, input, *tree, epp);
+        try {
+            parse(lexer, *input, *tree, epp);
+        } catch (parse_exception const& ex) {
+            throw parse_exception{ ex, tree };
+        }
         return tree;
     }
 
     shared_ptr<ast::syntax_tree> parse_string(logging::logger& logger, std::string source, std::string path, compiler::module const* module, bool epp)
     {
         auto tree = ast::syntax_tree::create(rvalue_cast(path), module);
+        tree->source(rvalue_cast(source));
 
         string_static_lexer lexer{ [&](logging::level level, std::string const& message, lexer::position const& position, size_t length) {
             if (!logger.would_log(level)) {
                 return;
             }
 
-            auto info = lexer::get_line_info(source, position.offset(), length);
+            auto info = tree->line_info(position.offset(), length);
             logger.log(level, position.line(), info.column, info.length, info.text, tree->path(), message);
         }};
 
-        parse(lexer, source, *tree, epp);
-        tree->source(rvalue_cast(source));
+        try {
+            parse(lexer, tree->source(), *tree, epp);
+        } catch (parse_exception const& ex) {
+            throw parse_exception{ ex, tree };
+        }
         return tree;
     }
 
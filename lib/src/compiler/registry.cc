@@ -68,6 +68,7 @@ namespace puppet { namespace compiler {
 
     klass const* registry::find_class(string const& name) const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
         auto it = _classes.find(name);
         if (it == _classes.end()) {
             return nullptr;
@@ -78,11 +79,13 @@ namespace puppet { namespace compiler {
     void registry::register_class(compiler::klass klass)
     {
         auto name = klass.name();
+        unique_lock<shared_timed_mutex> lock{ _mutex };
         _classes.emplace(rvalue_cast(name), rvalue_cast(klass));
     }
 
     defined_type const* registry::find_defined_type(string const& name) const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
         auto it = _defined_types.find(name);
         if (it == _defined_types.end()) {
             return nullptr;
@@ -93,11 +96,14 @@ namespace puppet { namespace compiler {
     void registry::register_defined_type(defined_type type)
     {
         auto name = type.name();
+        unique_lock<shared_timed_mutex> lock{ _mutex };
         _defined_types.emplace(rvalue_cast(name), rvalue_cast(type));
     }
 
     std::pair<node_definition const*, std::string> registry::find_node(compiler::node const& node) const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
+
         // If there are no node definitions, do nothing
         if (_nodes.empty()) {
             return make_pair(nullptr, string());
@@ -136,6 +142,12 @@ namespace puppet { namespace compiler {
     }
 
     node_definition const* registry::find_node(ast::node_statement const& statement) const
+    {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
+        return find_node_definition(statement);
+    }
+
+    node_definition const* registry::find_node_definition(ast::node_statement const& statement) const
     {
         for (auto const& hostname : statement.hostnames) {
             // Check for default node
@@ -168,8 +180,10 @@ namespace puppet { namespace compiler {
 
     node_definition const* registry::register_node(node_definition node)
     {
+        unique_lock<shared_timed_mutex> lock{ _mutex };
+
         // Check for a node that would conflict with the given one
-        if (auto existing = find_node(node.statement())) {
+        if (auto existing = find_node_definition(node.statement())) {
             return existing;
         }
 
@@ -222,11 +236,13 @@ namespace puppet { namespace compiler {
 
     bool registry::has_nodes() const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
         return !_nodes.empty();
     }
 
     void registry::register_type_alias(type_alias alias)
     {
+        unique_lock<shared_timed_mutex> lock{ _mutex };
         _aliases.emplace(alias.statement().alias.name, rvalue_cast(alias));
     }
 
@@ -237,6 +253,7 @@ namespace puppet { namespace compiler {
 
     type_alias const* registry::find_type_alias(string const& name) const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
         auto it = _aliases.find(name);
         if (it == _aliases.end()) {
             return nullptr;
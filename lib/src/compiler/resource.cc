@@ -1,10 +1,11 @@
 #include <puppet/compiler/resource.hpp>
 #include <puppet/compiler/catalog.hpp>
+#include <puppet/compiler/resource_index.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <puppet/compiler/evaluation/scope.hpp>
 #include <puppet/cast.hpp>
-#include <rapidjson/document.h>
-#include <boost/lexical_cast.hpp>
+#include <puppet/utility/output_buffer.hpp>
+#include <rapidjson/prettywriter.h>
 #include <boost/algorithm/string.hpp>
 
 using namespace std;
@@ -68,7 +69,8 @@ namespace puppet { namespace compiler {
 
     shared_ptr<attribute> resource::get(string const& name) const
     {
-        auto it = _attributes.find(name);
+        // A name that was never interned cannot be an attribute of the resource, but may still be a default
+        auto it = _attributes.find(symbol::find(name));
         if (it == _attributes.end()) {
             return _scope ? _scope->find_default(_type, name) : nullptr;
         }
@@ -81,7 +83,17 @@ namespace puppet { namespace compiler {
             return;
         }
 
-        _attributes[attribute->name()] = rvalue_cast(attribute);
+        auto& existing = _attributes[attribute->symbol()];
+
+        // Keep the catalog's index up to date
+        if (_index) {
+            if (existing) {
+                _index->remove(*this, attribute->name(), existing->value());
+            }
+            _index->insert(*this, attribute->name(), attribute->value());
+        }
+
+        existing = rvalue_cast(attribute);
     }
 
     bool resource::append(shared_ptr<compiler::attribute> attribute)
@@ -105,6 +117,10 @@ namespace puppet { namespace compiler {
         // If the attribute owns the value (is unique), modify it; otherwise copy it as it is shared
         values::array existing_value;
         if (existing->unique()) {
+            // The existing value is about to be moved from, so remove it from the index first
+            if (_index) {
+                _index->remove(*this, existing->name(), existing->value());
+            }
             existing_value = existing->value().move_as<values::array>();
         } else {
             existing_value = *existing->value().as<values::array>();
@@ -178,7 +194,9 @@ namespace puppet { namespace compiler {
         _scope(rvalue_cast(scope)),
         _context(rvalue_cast(context)),
         _vertex_id(numeric_limits<size_t>::max()),
-        _exported(exported)
+        _exported(exported),
+        _index(nullptr),
+        _position(0)
     {
         if (_container && _type.is_stage()) {
             throw runtime_error("stages cannot have a container.");
@@ -188,40 +206,70 @@ namespace puppet { namespace compiler {
         }
     }
 
-    json_value resource::to_json(json_allocator& allocator, compiler::catalog const& catalog) const
+    template <typename Writer>
+    void resource::write(Writer& writer, compiler::catalog const& catalog) const
     {
-        json_value value;
-        value.SetObject();
+        writer.StartObject();
 
         auto& type_name = _type.type_name();
         auto& title = _type.title();
 
         // Write out the type and title
-        value.AddMember("type", rapidjson::StringRef(type_name.c_str(), type_name.size()), allocator);
-        value.AddMember("title", rapidjson::StringRef(title.c_str(), title.size()), allocator);
+        writer.Key("type", 4);
+        writer.String(type_name.c_str(), static_cast<rapidjson::SizeType>(type_name.size()));
+        writer.Key("title", 5);
+        writer.String(title.c_str(), static_cast<rapidjson::SizeType>(title.size()));
 
         // Write out the tags
         auto tags = calculate_tags();
-        json_value tags_array;
-        tags_array.SetArray();
+        writer.Key("tags", 4);
+        writer.StartArray();
         for (auto& tag : tags) {
-            tags_array.PushBack(json_value(rapidjson::StringRef(tag->c_str()), tag->size()), allocator);
+            writer.String(tag->c_str(), static_cast<rapidjson::SizeType>(tag->size()));
         }
-        value.AddMember("tags", rvalue_cast(tags_array), allocator);
+        writer.EndArray(static_cast<rapidjson::SizeType>(tags.size()));
 
         // Write out the file and line
         if (_context) {
             auto const& path = this->path();
-            value.AddMember("file", rapidjson::StringRef(path.c_str(), path.size()), allocator);
-            value.AddMember("line", static_cast<uint64_t>(line()), allocator);
+            writer.Key("file", 4);
+            writer.String(path.c_str(), static_cast<rapidjson::SizeType>(path.size()));
+            writer.Key("line", 4);
+            writer.Uint64(static_cast<uint64_t>(line()));
         }
 
         // Write out whether or not the resource is exported
-        value.AddMember("exported", _exported, allocator);
+        writer.Key("exported", 8);
+        writer.Bool(_exported);
+
+        // Gather the relationship parameters from the dependency graph
+        // Since the edges represent those resources this resource depends on, treat before as require and notify as subscribe
+        vector<types::resource const*> require_parameter;
+        vector<types::resource const*> subscribe_parameter;
+        catalog.each_edge(*this, [&](relationship relation, resource const& target) {
+            // Ignore containment edges; those are handled by the catalog
+            if (relation == relationship::contains) {
+                return true;
+            }
+            if (relation == relationship::before || relation == relationship::require) {
+                require_parameter.push_back(&target.type());
+            } else if (relation == relationship::notify || relation == relationship::subscribe) {
+                subscribe_parameter.push_back(&target.type());
+            } else {
+                throw runtime_error("unexpected relationship.");
+            }
+            return true;
+        });
 
-        // Write out the parameters
-        json_value parameters;
-        parameters.SetObject();
+        // Write out the parameters; the object is only started once there is a parameter to write
+        rapidjson::SizeType parameters = 0;
+        auto write_name = [&](char const* name, size_t size) {
+            if (parameters++ == 0) {
+                writer.Key("parameters", 10);
+                writer.StartObject();
+            }
+            writer.Key(name, static_cast<rapidjson::SizeType>(size));
+        };
 
         each_attribute([&](auto& attribute) {
             auto const& name = attribute.name();
@@ -232,66 +280,58 @@ namespace puppet { namespace compiler {
                 return true;
             }
 
-            // Do not write out relationship metaparameters (sourced from dependency graph below)
+            // Do not write out relationship metaparameters (sourced from dependency graph above)
             if (name == "before" || name == "notify" || name == "require"  || name == "subscribe") {
                 return true;
             }
 
-            parameters.AddMember(
-                rapidjson::StringRef(name.c_str(), name.size()),
-                value.to_json(allocator),
-                allocator);
+            write_name(name.c_str(), name.size());
+            value.write(writer);
             return true;
         });
 
-        // Add the relationship parameters
-        add_relationship_parameters(parameters, allocator, catalog);
+        // Write out the relationship parameters
+        auto write_relationships = [&](char const* name, size_t size, vector<types::resource const*> const& targets) {
+            if (targets.empty()) {
+                return;
+            }
+            write_name(name, size);
+            writer.StartArray();
+            for (auto target : targets) {
+                write_reference(writer, *target);
+            }
+            writer.EndArray(static_cast<rapidjson::SizeType>(targets.size()));
+        };
+        write_relationships("require", 7, require_parameter);
+        write_relationships("subscribe", 9, subscribe_parameter);
 
-        if (parameters.MemberCount() > 0) {
-            value.AddMember("parameters", rvalue_cast(parameters), allocator);
+        if (parameters > 0) {
+            writer.EndObject(parameters);
         }
-        return value;
+        writer.EndObject();
     }
 
-    void resource::add_relationship_parameters(json_value& parameters, json_allocator& allocator, compiler::catalog const& catalog) const
+    template <typename Writer>
+    void resource::write_reference(Writer& writer, types::resource const& type)
     {
-        json_value require_parameter;
-        json_value subscribe_parameter;
-
-        require_parameter.SetArray();
-        subscribe_parameter.SetArray();
-
-        catalog.each_edge(*this, [&](relationship relation, resource const& target) {
-            // Ignore containment edges; those are handled by the catalog
-            if (relation == relationship::contains) {
-                return true;
-            }
-
-            // Since the edges represent those resources this resource depends on, treat before as require and notify as subscribe
-            json_value* parameter = nullptr;
-            if (relation == relationship::before || relation == relationship::require) {
-                parameter = &require_parameter;
-            } else if (relation == relationship::notify || relation == relationship::subscribe) {
-                parameter = &subscribe_parameter;
-            }
-
-            if (!parameter) {
-                throw runtime_error("unexpected relationship.");
-            }
-
-            // Add the target to the parameter
-            parameter->PushBack(json_value(boost::lexical_cast<string>(target.type()).c_str(), allocator), allocator);
-            return true;
-        });
-
-        if (require_parameter.Size() > 0) {
-            parameters.AddMember("require", rvalue_cast(require_parameter), allocator);
-        }
-        if (subscribe_parameter.Size() > 0) {
-            parameters.AddMember("subscribe", rvalue_cast(subscribe_parameter), allocator);
-        }
+        // Format the reference as Type[title] without going through a stream
+        auto& type_name = type.type_name();
+        auto& title = type.title();
+
+        string reference;
+        reference.reserve(type_name.size() + title.size() + 2);
+        reference += type_name;
+        reference += '[';
+        reference += title;
+        reference += ']';
+        writer.String(reference.c_str(), static_cast<rapidjson::SizeType>(reference.size()));
     }
 
+    template void resource::write<json_writer>(json_writer&, compiler::catalog const&) const;
+    template void resource::write<json_pretty_writer>(json_pretty_writer&, compiler::catalog const&) const;
+    template void resource::write_reference<json_writer>(json_writer&, types::resource const&);
+    template void resource::write_reference<json_pretty_writer>(json_pretty_writer&, types::resource const&);
+
     void resource::realize(size_t vertex_id)
     {
         _vertex_id = vertex_id;
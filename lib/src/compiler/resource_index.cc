@@ -0,0 +1,162 @@
+#include <puppet/compiler/resource_index.hpp>
+#include <puppet/compiler/resource.hpp>
+
+using namespace std;
+using namespace puppet::runtime;
+
+namespace puppet { namespace compiler {
+
+    static values::value const& dereference(values::value const& value)
+    {
+        // Index the values of variables so that lookups are consistent with value equality
+        if (auto variable = boost::get<values::variable>(&value)) {
+            return variable->value();
+        }
+        return value;
+    }
+
+    bool resource_index::indexed(string const& type) const
+    {
+        return find_type(type) != nullptr;
+    }
+
+    void resource_index::index(string const& type, vector<resource*> const& resources)
+    {
+        if (indexed(type)) {
+            return;
+        }
+
+        auto& index = _types[type];
+        index.resources.reserve(resources.size());
+        for (auto resource : resources) {
+            index.resources.push_back(resource);
+            index.titles[resource->type().title()].insert(resource->_position);
+            for (auto const& kvp : resource->_attributes) {
+                insert(*resource, kvp.second->name(), kvp.second->value());
+            }
+        }
+    }
+
+    void resource_index::add(compiler::resource& resource)
+    {
+        auto index = find_type(resource.type().type_name());
+        if (!index) {
+            return;
+        }
+        if (index->resources.size() <= resource._position) {
+            index->resources.resize(resource._position + 1, nullptr);
+        }
+        index->resources[resource._position] = &resource;
+        index->titles[resource.type().title()].insert(resource._position);
+    }
+
+    void resource_index::insert(compiler::resource const& resource, string const& name, values::value const& value)
+    {
+        auto index = find_type(resource.type().type_name());
+        if (!index) {
+            return;
+        }
+
+        // Index the value itself and, for arrays, each element so that containment queries can be answered
+        auto& entries = index->attributes[name];
+        entries[dereference(value)].insert(resource._position);
+        if (auto array = value.as<values::array>()) {
+            for (auto const& element : *array) {
+                entries[dereference(element)].insert(resource._position);
+            }
+        }
+    }
+
+    void resource_index::remove(compiler::resource const& resource, string const& name, values::value const& value)
+    {
+        auto index = find_type(resource.type().type_name());
+        if (!index) {
+            return;
+        }
+
+        auto entries = index->attributes.find(name);
+        if (entries == index->attributes.end()) {
+            return;
+        }
+
+        auto erase = [&](values::value const& key) {
+            auto it = entries->second.find(key);
+            if (it == entries->second.end()) {
+                return;
+            }
+            it->second.erase(resource._position);
+            if (it->second.empty()) {
+                entries->second.erase(it);
+            }
+        };
+
+        erase(dereference(value));
+        if (auto array = value.as<values::array>()) {
+            for (auto const& element : *array) {
+                erase(dereference(element));
+            }
+        }
+    }
+
+    void resource_index::add_default(string const& type, string const& name)
+    {
+        _defaults[type].insert(name);
+    }
+
+    bool resource_index::defaulted(string const& type, string const& name) const
+    {
+        auto it = _defaults.find(type);
+        if (it == _defaults.end()) {
+            return false;
+        }
+        return it->second.count(name) > 0;
+    }
+
+    resource_index::position_set const* resource_index::find_title(string const& type, values::value const& title) const
+    {
+        auto index = find_type(type);
+        if (!index) {
+            return nullptr;
+        }
+        return find(index->titles, title);
+    }
+
+    resource_index::position_set const* resource_index::find(string const& type, string const& name, values::value const& value) const
+    {
+        auto index = find_type(type);
+        if (!index) {
+            return nullptr;
+        }
+        auto entries = index->attributes.find(name);
+        if (entries == index->attributes.end()) {
+            return nullptr;
+        }
+        return find(entries->second, dereference(value));
+    }
+
+    vector<resource*> const& resource_index::resources(string const& type) const
+    {
+        static vector<resource*> const empty;
+        auto index = find_type(type);
+        return index ? index->resources : empty;
+    }
+
+    resource_index::type_index* resource_index::find_type(string const& type)
+    {
+        auto it = _types.find(type);
+        return it == _types.end() ? nullptr : &it->second;
+    }
+
+    resource_index::type_index const* resource_index::find_type(string const& type) const
+    {
+        auto it = _types.find(type);
+        return it == _types.end() ? nullptr : &it->second;
+    }
+
+    resource_index::position_set const* resource_index::find(value_map const& map, values::value const& value)
+    {
+        auto it = map.find(value);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+}}  // namespace puppet::compiler
@@ -44,7 +44,11 @@ namespace puppet { namespace compiler {
                 registered = true;
             }
         };
-        visitor.visit(tree);
+        try {
+            visitor.visit(tree);
+        } catch (parse_exception const& ex) {
+            throw parse_exception{ ex, tree.shared_from_this() };
+        }
         return registered;
     }
 
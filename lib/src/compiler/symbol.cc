@@ -0,0 +1,128 @@
+#include <puppet/compiler/symbol.hpp>
+#include <shared_mutex>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace puppet { namespace compiler {
+
+    struct symbol::entry
+    {
+        string const* name = nullptr;
+        size_t hash = 0;
+    };
+
+    struct symbol::table
+    {
+        entry const* find(string const& name) const
+        {
+            // Entries are never removed, so each thread can remember the entries it has found without taking the lock again
+            auto& found = cache();
+            auto it = found.find(name);
+            if (it != found.end()) {
+                return it->second;
+            }
+
+            shared_lock<shared_timed_mutex> lock{ _mutex };
+            auto entry = _entries.find(name);
+            if (entry == _entries.end()) {
+                return nullptr;
+            }
+            found.emplace(name, &entry->second);
+            return &entry->second;
+        }
+
+        entry const* intern(string const& name)
+        {
+            if (auto existing = find(name)) {
+                return existing;
+            }
+
+            // The entry stores a pointer to the map's key, which is stable because the map is node-based
+            unique_lock<shared_timed_mutex> lock{ _mutex };
+            auto result = _entries.emplace(name, entry{});
+            auto& interned = result.first->second;
+            if (result.second) {
+                interned.name = &result.first->first;
+                interned.hash = std::hash<string>()(name);
+            }
+            cache().emplace(name, &interned);
+            return &interned;
+        }
+
+     private:
+        static unordered_map<string, entry const*>& cache()
+        {
+            thread_local unordered_map<string, entry const*> cache;
+            return cache;
+        }
+
+        mutable shared_timed_mutex _mutex;
+        unordered_map<string, entry> _entries;
+    };
+
+    symbol::table& symbol::instance()
+    {
+        static table instance;
+        return instance;
+    }
+
+    symbol::symbol() :
+        _entry(nullptr)
+    {
+    }
+
+    symbol::symbol(string const& name) :
+        _entry(instance().intern(name))
+    {
+    }
+
+    symbol::symbol(entry const* entry) :
+        _entry(entry)
+    {
+    }
+
+    symbol symbol::find(string const& name)
+    {
+        return symbol{ instance().find(name) };
+    }
+
+    string const& symbol::name() const
+    {
+        static string const empty;
+        return _entry ? *_entry->name : empty;
+    }
+
+    size_t symbol::hash() const
+    {
+        return _entry ? _entry->hash : 0;
+    }
+
+    symbol::operator bool() const
+    {
+        return _entry != nullptr;
+    }
+
+    bool operator==(symbol const& left, symbol const& right)
+    {
+        return left._entry == right._entry;
+    }
+
+    bool operator!=(symbol const& left, symbol const& right)
+    {
+        return !(left == right);
+    }
+
+    size_t hash_value(compiler::symbol const& symbol)
+    {
+        return symbol.hash();
+    }
+
+    ostream& operator<<(ostream& os, compiler::symbol const& symbol)
+    {
+        os << symbol.name();
+        return os;
+    }
+
+}}  // namespace puppet::compiler
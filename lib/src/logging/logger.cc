@@ -53,6 +53,8 @@ namespace puppet { namespace logging {
         if (!would_log(level)) {
             return;
         }
+
+        lock_guard<mutex> lock{ _mutex };
         if (level == logging::level::warning) {
             ++_warnings;
         } else if (level >= logging::level::error) {
@@ -67,6 +69,7 @@ namespace puppet { namespace logging {
             return;
         }
 
+        lock_guard<mutex> lock{ _mutex };
         log_backtrace(backtrace);
     }
 
@@ -92,6 +95,7 @@ namespace puppet { namespace logging {
 
     void logger::reset()
     {
+        lock_guard<mutex> lock{ _mutex };
         _warnings = _errors = 0;
     }
 
@@ -5,9 +5,13 @@
 #include <puppet/facts/facter.hpp>
 #include <puppet/facts/yaml.hpp>
 #include <puppet/utility/filesystem/helpers.hpp>
+#include <puppet/utility/output_buffer.hpp>
+#include <puppet/utility/thread_pool.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <fstream>
+#include <mutex>
+#include <unordered_set>
 
 using namespace std;
 using namespace puppet::facts;
@@ -20,6 +24,75 @@ namespace sys = boost::system;
 
 namespace puppet { namespace options { namespace commands {
 
+    struct batch_output
+    {
+        string directory;
+        ostream* stream = nullptr;
+        mutex stream_mutex;
+    };
+
+    static bool compile_batch_node(
+        logging::logger& logger,
+        shared_ptr<compiler::environment> const& environment,
+        string const& name,
+        string const& facts_directory,
+        vector<string> const& manifests,
+        batch_output& output,
+        size_t cycle_limit,
+        bool trace)
+    {
+        try {
+            auto facts_file = (fs::path{ facts_directory } / (name + ".yaml")).string();
+            sys::error_code ec;
+            if (!fs::is_regular_file(facts_file, ec)) {
+                LOG(error, "node '%1%': facts file '%2%' does not exist.", name, facts_file);
+                return false;
+            }
+
+            compiler::node node{ logger, name, environment, make_shared<facts::yaml>(facts_file) };
+
+            LOG(info, "compiling for node '%1%' with environment '%2%'.", node.name(), node.environment().name());
+
+            auto catalog = node.compile(manifests);
+
+            // Detect dependency cycles
+            catalog.detect_cycles(cycle_limit);
+
+            if (!output.directory.empty()) {
+                auto path = (fs::path{ output.directory } / (name + ".json")).string();
+                ofstream file{ path };
+                if (!file) {
+                    LOG(error, "node '%1%': cannot open '%2%' for writing.", name, path);
+                    return false;
+                }
+                LOG(info, "writing catalog for node '%1%' to '%2%'.", name, path);
+                catalog.write(file);
+                return true;
+            }
+
+            // Serialize outside of the lock so that only the write to the stream is serialized
+            utility::output_buffer buffer;
+            catalog.write(buffer, false);
+
+            auto const& contents = buffer.contents();
+            lock_guard<mutex> lock{ output.stream_mutex };
+            output.stream->write(contents.data(), static_cast<streamsize>(contents.size()));
+            return true;
+        } catch (compilation_exception const& ex) {
+            LOG(error, ex.line(), ex.column(), ex.length(), ex.text(), ex.path(), "node '%1%': %2%", name, ex.what());
+            if (trace) {
+                logger.log(ex.backtrace());
+            }
+        } catch (resource_cycle_exception const& ex) {
+            LOG(error, "node '%1%': %2%", name, ex.what());
+        } catch (yaml_parse_exception const& ex) {
+            LOG(error, ex.line(), 1, ex.column(), ex.text(), ex.path(), "node '%1%': %2%", name, ex.what());
+        } catch (exception const& ex) {
+            LOG(error, "node '%1%': %2%", name, ex.what());
+        }
+        return false;
+    }
+
     char const* compile::name() const
     {
         return "compile";
@@ -37,7 +110,11 @@ namespace puppet { namespace options { namespace commands {
             " <p> "
             "When invoked with no options, the compiler will compile a catalog for the 'production' environment."
             " <p> "
-            "Manifests will be evaluated in the order they are presented on the command line.";
+            "Manifests will be evaluated in the order they are presented on the command line."
+            " <p> "
+            "The --nodes option compiles a batch of nodes using a single environment. Facts for each node are read from "
+            "'<node>.yaml' in the directory given by the --facts-dir option. Catalogs are written to '<node>.json' in the "
+            "directory given by the --output-dir option or, if not specified, to the output file as newline-delimited JSON.";
     }
 
     char const* compile::arguments() const
@@ -52,17 +129,22 @@ namespace puppet { namespace options { namespace commands {
         options.add_options()
             (CODE_DIRECTORY_OPTION, po::value<string>(), CODE_DIRECTORY_DESCRIPTION)
             (COLOR_OPTION, COLOR_DESCRIPTION)
+            (CYCLE_LIMIT_OPTION, po::value<size_t>()->default_value(catalog::default_cycle_limit), CYCLE_LIMIT_DESCRIPTION)
             (DEBUG_OPTION_FULL, DEBUG_DESCRIPTION)
             (ENVIRONMENT_OPTION_FULL, po::value<string>()->default_value("production"), ENVIRONMENT_DESCRIPTION)
             (ENVIRONMENT_PATH_OPTION, po::value<string>(), ENVIRONMENT_PATH_DESCRIPTION)
             (FACTS_OPTION_FULL, po::value<string>(), FACTS_DESCRIPTION)
+            (FACTS_DIRECTORY_OPTION, po::value<string>(), FACTS_DIRECTORY_DESCRIPTION)
             (GRAPH_FILE_OPTION_FULL, po::value<string>(), GRAPH_FILE_DESCRIPTION)
             (HELP_OPTION, HELP_DESCRIPTION)
+            (JOBS_OPTION_FULL, po::value<size_t>(), JOBS_DESCRIPTION)
             (LOG_LEVEL_OPTION_FULL, po::value<string>()->default_value("notice"), command::LOG_LEVEL_DESCRIPTION)
             (MODULE_PATH_OPTION, po::value<string>(), MODULE_PATH_DESCRIPTION)
             (NODE_OPTION_FULL, po::value<string>(), NODE_DESCRIPTION)
+            (NODES_OPTION, po::value<string>(), NODES_DESCRIPTION)
             (NO_COLOR_OPTION, NO_COLOR_DESCRIPTION)
             (OUTPUT_OPTION_FULL, po::value<string>()->default_value("catalog.json"), OUTPUT_DESCRIPTION)
+            (OUTPUT_DIRECTORY_OPTION, po::value<string>(), OUTPUT_DIRECTORY_DESCRIPTION)
             (TRACE_OPTION, TRACE_DESCRIPTION)
             (VERBOSE_OPTION, VERBOSE_DESCRIPTION)
             ;
@@ -75,6 +157,19 @@ namespace puppet { namespace options { namespace commands {
             return parser().parse({ HELP_OPTION, name() });
         }
 
+        if (options.count(NODES_OPTION)) {
+            return create_batch_executor(options);
+        }
+        if (options.count(FACTS_DIRECTORY_OPTION) || options.count(OUTPUT_DIRECTORY_OPTION) || options.count(JOBS_OPTION)) {
+            throw option_exception(
+                (boost::format("%1%, %2%, and %3% options can only be used with the %4% option.") %
+                 FACTS_DIRECTORY_OPTION %
+                 OUTPUT_DIRECTORY_OPTION %
+                 JOBS_OPTION %
+                 NODES_OPTION
+                ).str(), this);
+        }
+
         // Get the options
         auto level = command::get_level(options);
         auto colorization = get_colorization(options);
@@ -84,6 +179,7 @@ namespace puppet { namespace options { namespace commands {
         auto settings = create_settings(options);
         auto node_name = get_node(options, *facts);
         auto manifests = get_manifests(options);
+        auto cycle_limit = options[CYCLE_LIMIT_OPTION].as<size_t>();
         bool trace = options.count(TRACE_OPTION) > 0;
 
         // Move the options into the lambda capture
@@ -97,6 +193,7 @@ namespace puppet { namespace options { namespace commands {
                 facts = rvalue_cast(facts),
                 output_file = rvalue_cast(output_file),
                 graph_file = rvalue_cast(graph_file),
+                cycle_limit,
                 trace = trace,
                 this
             ] () {
@@ -142,7 +239,7 @@ namespace puppet { namespace options { namespace commands {
                         }
 
                         // Detect dependency cycles
-                        catalog.detect_cycles();
+                        catalog.detect_cycles(cycle_limit);
 
                         // Write the catalog
                         LOG(notice, "writing catalog to '%1%'.", output_file);
@@ -185,6 +282,183 @@ namespace puppet { namespace options { namespace commands {
         };
     }
 
+    executor compile::create_batch_executor(po::variables_map const& options) const
+    {
+        if (options.count(NODE_OPTION) || options.count(FACTS_OPTION) || options.count(GRAPH_FILE_OPTION)) {
+            throw option_exception(
+                (boost::format("%1%, %2%, and %3% options cannot be used with the %4% option.") %
+                 NODE_OPTION %
+                 FACTS_OPTION %
+                 GRAPH_FILE_OPTION %
+                 NODES_OPTION
+                ).str(), this);
+        }
+
+        // Get the options
+        auto level = command::get_level(options);
+        auto settings = create_settings(options);
+        auto manifests = get_manifests(options);
+        auto nodes = get_nodes(options);
+        auto facts_directory = get_facts_directory(options);
+        auto output_directory = get_output_directory(options);
+        auto output_file = output_directory.empty() ? get_output_file(options) : string{};
+        auto jobs = get_jobs(options);
+        auto cycle_limit = options[CYCLE_LIMIT_OPTION].as<size_t>();
+        bool trace = options.count(TRACE_OPTION) > 0;
+
+        // Move the options into the lambda capture
+        return {
+            *this,
+            [
+                level,
+                settings = rvalue_cast(settings),
+                manifests = rvalue_cast(manifests),
+                nodes = rvalue_cast(nodes),
+                facts_directory = rvalue_cast(facts_directory),
+                output_directory = rvalue_cast(output_directory),
+                output_file = rvalue_cast(output_file),
+                jobs,
+                cycle_limit,
+                trace,
+                this
+            ] () {
+                size_t failures = 0;
+                logging::console_logger logger;
+
+                try {
+                    logger.level(level);
+
+                    LOG(debug, "using code directory '%1%'.", settings.get(settings::code_directory));
+
+                    // Create the environment once; it is shared by every node in the batch
+                    auto environment = compiler::environment::create(logger, settings);
+                    environment->dispatcher().add_builtin_functions();
+                    environment->dispatcher().add_builtin_operators();
+
+                    batch_output output;
+                    output.directory = output_directory;
+
+                    ofstream stream;
+                    if (output.directory.empty()) {
+                        stream.open(output_file);
+                        if (!stream) {
+                            throw option_exception((boost::format("cannot open '%1%' for writing.") % output_file).str(), this);
+                        }
+                        output.stream = &stream;
+                        LOG(notice, "writing catalogs to '%1%'.", output_file);
+                    }
+
+                    LOG(notice, "compiling %1% %2% with environment '%3%'.", nodes.size(), (nodes.size() != 1 ? "nodes" : "node"), environment->name());
+
+                    vector<future<bool>> results;
+                    results.reserve(nodes.size());
+                    {
+                        utility::thread_pool pool{ jobs };
+                        for (auto const& name : nodes) {
+                            results.emplace_back(pool.queue([&, &name = name]() {
+                                return compile_batch_node(logger, environment, name, facts_directory, manifests, output, cycle_limit, trace);
+                            }));
+                        }
+                        for (auto& result : results) {
+                            if (!result.get()) {
+                                ++failures;
+                            }
+                        }
+                    }
+                } catch (compilation_exception const& ex) {
+                    LOG(error, ex.line(), ex.column(), ex.length(), ex.text(), ex.path(), ex.what());
+                    if (trace) {
+                        logger.log(ex.backtrace());
+                    }
+                    failures = nodes.size();
+                } catch (exception const& ex) {
+                    LOG(critical, "unhandled exception: %1%", ex.what());
+                    failures = nodes.size();
+                }
+
+                auto errors = logger.errors();
+                auto warnings = logger.warnings();
+
+                LOG(notice, "compiled %1% of %2% %3% with %4% %5% and %6% %7%.",
+                    nodes.size() - failures,
+                    nodes.size(),
+                    (nodes.size() != 1 ? "nodes" : "node"),
+                    errors,
+                    (errors != 1 ? "errors" : "error"),
+                    warnings,
+                    (warnings != 1 ? "warnings" : "warning")
+                );
+                return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+            }
+        };
+    }
+
+    vector<string> compile::get_nodes(po::variables_map const& options) const
+    {
+        auto path = make_absolute(options[NODES_OPTION].as<string>());
+        ifstream file{ path };
+        if (!file) {
+            throw option_exception((boost::format("cannot open node list '%1%' for reading.") % path).str(), this);
+        }
+
+        // Read one node name per line, ignoring blank lines, comments, and duplicates
+        vector<string> nodes;
+        unordered_set<string> seen;
+        string line;
+        while (getline(file, line)) {
+            boost::trim(line);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            // Node names are used as file names in the facts and output directories
+            if (line.find_first_of("/\\") != string::npos || line.find("..") != string::npos) {
+                throw option_exception((boost::format("node name '%1%' in node list '%2%' cannot contain path separators or '..'.") % line % path).str(), this);
+            }
+            if (seen.insert(line).second) {
+                nodes.emplace_back(rvalue_cast(line));
+            }
+        }
+        if (nodes.empty()) {
+            throw option_exception((boost::format("node list '%1%' does not contain any node names.") % path).str(), this);
+        }
+        return nodes;
+    }
+
+    string compile::get_facts_directory(po::variables_map const& options) const
+    {
+        if (!options.count(FACTS_DIRECTORY_OPTION)) {
+            throw option_exception(
+                (boost::format("the %1% option is required when using the %2% option.") %
+                 FACTS_DIRECTORY_OPTION %
+                 NODES_OPTION
+                ).str(), this);
+        }
+        auto directory = make_absolute(options[FACTS_DIRECTORY_OPTION].as<string>());
+        sys::error_code ec;
+        if (!fs::is_directory(directory, ec)) {
+            throw option_exception((boost::format("facts directory '%1%' does not exist or is not a directory.") % directory).str(), this);
+        }
+        return directory;
+    }
+
+    string compile::get_output_directory(po::variables_map const& options) const
+    {
+        if (!options.count(OUTPUT_DIRECTORY_OPTION)) {
+            return {};
+        }
+        auto directory = make_absolute(options[OUTPUT_DIRECTORY_OPTION].as<string>());
+        sys::error_code ec;
+        if (!fs::is_directory(directory, ec) && !fs::create_directories(directory, ec)) {
+            throw option_exception((boost::format("failed to create output directory '%1%'.") % directory).str(), this);
+        }
+        return directory;
+    }
+
+    size_t compile::get_jobs(po::variables_map const& options) const
+    {
+        return options.count(JOBS_OPTION) ? options[JOBS_OPTION].as<size_t>() : 0;
+    }
+
     shared_ptr<facts::provider> compile::get_facts(po::variables_map const& options) const
     {
         if (options.count(FACTS_OPTION)) {
@@ -282,16 +556,27 @@ namespace puppet { namespace options { namespace commands {
         return {};
     }
 
+    char const* const compile::CYCLE_LIMIT_OPTION     = "cycle-limit";
+    char const* const compile::CYCLE_LIMIT_DESCRIPTION = "The maximum number of resource dependency cycles to report. Use 0 to report every cycle.";
     char const* const compile::FACTS_OPTION           = "facts";
     char const* const compile::FACTS_OPTION_FULL      = "facts,f";
     char const* const compile::FACTS_DESCRIPTION      = "The path to the YAML facts file to use. Defaults to the current system's facts.";
+    char const* const compile::FACTS_DIRECTORY_OPTION      = "facts-dir";
+    char const* const compile::FACTS_DIRECTORY_DESCRIPTION = "The directory containing '<node>.yaml' facts files for batch compilation.";
     char const* const compile::GRAPH_FILE_OPTION      = "graph-file";
     char const* const compile::GRAPH_FILE_OPTION_FULL = "graph-file,g";
     char const* const compile::GRAPH_FILE_DESCRIPTION = "The path to write a DOT language file for viewing the catalog dependency graph.";
+    char const* const compile::JOBS_OPTION            = "jobs";
+    char const* const compile::JOBS_OPTION_FULL       = "jobs,j";
+    char const* const compile::JOBS_DESCRIPTION       = "The number of nodes to compile concurrently in batch mode. Defaults to the number of hardware threads.";
     char const* const compile::NODE_OPTION            = "node";
     char const* const compile::NODE_OPTION_FULL       = "node,n";
     char const* const compile::NODE_DESCRIPTION       = "The node name to use. Defaults to the 'fqdn' fact.";
+    char const* const compile::NODES_OPTION           = "nodes";
+    char const* const compile::NODES_DESCRIPTION      = "The path to a file listing node names, one per line, to compile in batch.";
     char const* const compile::OUTPUT_DESCRIPTION     = "The output path for the compiled catalog.";
+    char const* const compile::OUTPUT_DIRECTORY_OPTION      = "output-dir";
+    char const* const compile::OUTPUT_DIRECTORY_DESCRIPTION = "The directory to write '<node>.json' catalogs to in batch mode.";
     char const* const compile::TRACE_OPTION           = "trace";
     char const* const compile::TRACE_DESCRIPTION      = "Display Puppet backtraces for evaluation errors.";
 
@@ -2,7 +2,6 @@
 #include <puppet/options/parser.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <puppet/compiler/environment.hpp>
-#include <puppet/compiler/lexer/lexer.hpp>
 #include <puppet/compiler/parser/parser.hpp>
 #include <puppet/utility/filesystem/helpers.hpp>
 #include <boost/filesystem.hpp>
@@ -70,13 +69,6 @@ namespace puppet { namespace options { namespace commands {
             }
         }
 
-        ofstream stream{ output_path };
-        if (!stream) {
-            LOG(error, "failed to open output file '%1%' for writing.", output_path);
-            stats.failed = true;
-            return;
-        }
-
         LOG(debug, "parsing manifest file '%1%'.", manifest);
         ++stats.parsed;
 
@@ -85,16 +77,17 @@ namespace puppet { namespace options { namespace commands {
             auto tree = compiler::parser::parse_file(logger, manifest);
             tree->validate();
 
-            // TODO: write in the actual XPP file format
-            tree->write(compiler::ast::format::yaml, stream);
-            stream << '\n';
-        } catch (parse_exception const& ex) {
-            compiler::lexer::line_info info;
-            ifstream input{ manifest };
-            if (input) {
-                info = lexer::get_line_info(input, ex.begin().offset(), ex.end().offset() - ex.begin().offset());
+            // Only write the output file once the manifest has successfully parsed
+            ofstream stream{ output_path, ios::out | ios::trunc | ios::binary };
+            if (!stream) {
+                LOG(error, "failed to open output file '%1%' for writing.", output_path);
+                stats.failed = true;
+                return;
             }
-            LOG(error, ex.begin().line(), info.column, info.length, info.text, manifest, ex.what());
+            tree->write(compiler::ast::format::xpp, stream);
+        } catch (parse_exception const& ex) {
+            compilation_exception error{ ex, manifest };
+            LOG(error, error.line(), error.column(), error.length(), error.text(), manifest, ex.what());
             // TODO: write out an XPP with the diagnostics
         }
     }
@@ -5,6 +5,28 @@ using namespace std;
 
 namespace puppet { namespace runtime { namespace values {
 
+    array::array(size_type count) :
+        _elements(make_shared<vector_type>(count))
+    {
+    }
+
+    array::array(initializer_list<value_type> elements) :
+        _elements(make_shared<vector_type>(elements))
+    {
+    }
+
+    void array::unshare()
+    {
+        // Copy the elements if shared; nested arrays and hashes remain shared until they are modified
+        _elements = _elements ? make_shared<vector_type>(*_elements) : make_shared<vector_type>();
+    }
+
+    array::vector_type const& array::empty_elements()
+    {
+        static const vector_type empty;
+        return empty;
+    }
+
     void array::join(ostream& os, string const& separator) const
     {
         bool first = true;
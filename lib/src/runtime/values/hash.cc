@@ -25,104 +25,113 @@ namespace puppet { namespace runtime { namespace values {
         return _value;
     }
 
-    hash::hash(hash const& other)
+    hash::storage::storage(storage const& other) :
+        elements(other.elements)
     {
-        operator=(other);
+        // Rebuild the index as it is reference-based
+        index.reserve(elements.size());
+        for (auto it = elements.begin(); it != elements.end(); ++it) {
+            index.emplace(&it->key(), it);
+        }
     }
 
-    hash& hash::operator=(hash const& other)
+    hash::storage const& hash::data() const
     {
-        // Copy the elements
-        _elements = other._elements;
+        static const storage empty;
+        return _storage ? *_storage : empty;
+    }
 
-        // Rebuild the index as it is reference-based
-        _index.clear();
-        _index.reserve(_elements.size());
-        for (auto it = _elements.begin(); it != _elements.end(); ++it) {
-            _index.emplace(&it->key(), it);
+    hash::storage& hash::mutate()
+    {
+        // Copy the elements if shared; nested arrays and hashes remain shared until they are modified
+        if (!_storage) {
+            _storage = make_shared<storage>();
+        } else if (_storage.use_count() > 1) {
+            _storage = make_shared<storage>(*_storage);
         }
-        return *this;
+        return *_storage;
     }
 
     hash::iterator hash::begin()
     {
-        return _elements.begin();
+        return mutate().elements.begin();
     }
 
     hash::const_iterator hash::begin() const
     {
-        return _elements.begin();
+        return data().elements.begin();
     }
 
     hash::iterator hash::end()
     {
-        return _elements.end();
+        return mutate().elements.end();
     }
 
     hash::const_iterator hash::end() const
     {
-        return _elements.end();
+        return data().elements.end();
     }
 
     hash::const_iterator hash::cbegin() const
     {
-        return _elements.cbegin();
+        return data().elements.cbegin();
     }
 
     hash::const_iterator hash::cend() const
     {
-        return _elements.cend();
+        return data().elements.cend();
     }
 
     hash::reverse_iterator hash::rbegin()
     {
-        return _elements.rbegin();
+        return mutate().elements.rbegin();
     }
 
     hash::const_reverse_iterator hash::rbegin() const
     {
-        return _elements.rbegin();
+        return data().elements.rbegin();
     }
 
     hash::reverse_iterator hash::rend()
     {
-        return _elements.rend();
+        return mutate().elements.rend();
     }
 
     hash::const_reverse_iterator hash::rend() const
     {
-        return _elements.rend();
+        return data().elements.rend();
     }
 
     hash::const_reverse_iterator hash::crbegin() const
     {
-        return _elements.crbegin();
+        return data().elements.crbegin();
     }
 
     hash::const_reverse_iterator hash::crend() const
     {
-        return _elements.crend();
+        return data().elements.crend();
     }
 
     size_t hash::size() const
     {
-        return _elements.size();
+        return data().elements.size();
     }
 
     bool hash::empty() const
     {
-        return _elements.empty();
+        return data().elements.empty();
     }
 
     void hash::set(value key, values::value value)
     {
-        auto it = _index.find(&key);
-        if (it != _index.end()) {
+        auto& storage = mutate();
+        auto it = storage.index.find(&key);
+        if (it != storage.index.end()) {
             it->second->value() = rvalue_cast(value);
             return;
         }
-        auto element = _elements.emplace(_elements.end(), rvalue_cast(key), rvalue_cast(value));
-        _index[&element->key()] = element;
+        auto element = storage.elements.emplace(storage.elements.end(), rvalue_cast(key), rvalue_cast(value));
+        storage.index[&element->key()] = element;
     }
 
     void hash::set(const_iterator begin, const_iterator end)
@@ -135,13 +144,19 @@ namespace puppet { namespace runtime { namespace values {
 
     value* hash::get(value const& key)
     {
-        return const_cast<value*>(static_cast<hash const*>(this)->get(key));
+        // Avoid unsharing the elements if the key is not present
+        if (!static_cast<hash const*>(this)->get(key)) {
+            return nullptr;
+        }
+        auto& storage = mutate();
+        return &storage.index.find(&key)->second->value();
     }
 
     value const* hash::get(value const& key) const
     {
-        auto it = _index.find(&key);
-        if (it == _index.end()) {
+        auto& storage = data();
+        auto it = storage.index.find(&key);
+        if (it == storage.index.end()) {
             return nullptr;
         }
         return &it->second->value();
@@ -149,12 +164,13 @@ namespace puppet { namespace runtime { namespace values {
 
     bool hash::erase(value const& key)
     {
-        auto it = _index.find(&key);
-        if (it == _index.end()) {
+        if (!static_cast<hash const*>(this)->get(key)) {
             return false;
         }
-        _elements.erase(it->second);
-        _index.erase(it);
+        auto& storage = mutate();
+        auto it = storage.index.find(&key);
+        storage.elements.erase(it->second);
+        storage.index.erase(it);
         return true;
     }
 
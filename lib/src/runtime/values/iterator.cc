@@ -10,13 +10,23 @@ namespace puppet { namespace runtime { namespace values {
     iterator::iterator(wrapper<values::value> value, int64_t step, bool reverse) :
         _value(rvalue_cast(value)),
         _step(step),
-        _reverse(reverse)
+        _reverse(reverse),
+        _keyed(false)
     {
         if (_step == 0) {
             throw runtime_error("invalid step value.");
         }
     }
 
+    iterator::iterator(wrapper<values::value> value, stage_type stage, bool keyed) :
+        _value(rvalue_cast(value)),
+        _step(1),
+        _reverse(false),
+        _stage(rvalue_cast(stage)),
+        _keyed(keyed)
+    {
+    }
+
     values::value const& iterator::value() const
     {
         if (auto iterator = _value->as<values::iterator>()) {
@@ -25,8 +35,24 @@ namespace puppet { namespace runtime { namespace values {
         return _value;
     }
 
+    bool iterator::keyed() const
+    {
+        if (_stage) {
+            return _keyed;
+        }
+        if (auto iterator = _value->as<values::iterator>()) {
+            return iterator->keyed();
+        }
+        return _value->as<values::hash>();
+    }
+
     values::type iterator::infer_produced_type() const
     {
+        // The elements produced by a lazy iterator are not known until iterated
+        if (_stage) {
+            return types::any{};
+        }
+
         auto& value = this->value();
 
         if (value.as<int64_t>()) {
@@ -76,12 +102,37 @@ namespace puppet { namespace runtime { namespace values {
             return;
         }
 
-        boost::apply_visitor(iteration_visitor{ callback, _step, reverse ? !_reverse : _reverse }, _value.get());
+        if (!_stage) {
+            boost::apply_visitor(iteration_visitor{ callback, _step, reverse ? !_reverse : _reverse }, _value.get());
+            return;
+        }
+
+        if (!reverse) {
+            boost::apply_visitor(iteration_visitor{ _stage(callback) }, _value.get());
+            return;
+        }
+
+        // The transformed elements must be produced before they can be iterated in reverse
+        vector<pair<boost::optional<values::value>, values::value>> elements;
+        boost::apply_visitor(
+            iteration_visitor{
+                _stage([&](auto const* key, auto const& value) {
+                    elements.emplace_back(key ? boost::optional<values::value>(*key) : boost::none, value);
+                    return true;
+                })
+            },
+            _value.get()
+        );
+        for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+            if (!callback(it->first ? &*it->first : nullptr, it->second)) {
+                break;
+            }
+        }
     }
 
     ostream& operator<<(ostream& os, values::iterator const& iterator)
     {
-        bool is_hash = iterator.value().as<values::hash>();
+        bool is_hash = iterator.keyed();
 
         if (is_hash) {
             os << '{';
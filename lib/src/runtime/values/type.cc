@@ -3,6 +3,8 @@
 #include <puppet/compiler/evaluation/evaluator.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <boost/format.hpp>
+#include <mutex>
+#include <unordered_map>
 
 using namespace std;
 using namespace puppet::compiler;
@@ -454,6 +456,27 @@ namespace puppet { namespace runtime { namespace values {
         return create(*postfix, context);
     }
 
+    boost::optional<type> type::parse_cached(string const& expression)
+    {
+        // Environments add the same built-in signatures, so only parse each expression once per process
+        static mutex cache_mutex;
+        static unordered_map<string, boost::optional<type>> cache;
+
+        {
+            lock_guard<mutex> lock{ cache_mutex };
+            auto it = cache.find(expression);
+            if (it != cache.end()) {
+                return it->second;
+            }
+        }
+
+        auto result = parse(expression);
+
+        lock_guard<mutex> lock{ cache_mutex };
+        cache.emplace(expression, result);
+        return result;
+    }
+
     ostream& operator<<(ostream& os, values::type const& type)
     {
         type.write(os);
@@ -2,11 +2,13 @@
 #include <puppet/compiler/evaluation/collectors/collector.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <puppet/utility/indirect_collection.hpp>
+#include <puppet/utility/output_buffer.hpp>
 #include <puppet/unicode/string.hpp>
 #include <puppet/cast.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
-#include <rapidjson/document.h>
+#include <boost/functional/hash.hpp>
+#include <rapidjson/prettywriter.h>
 #include <algorithm>
 
 using namespace std;
@@ -588,13 +590,9 @@ namespace puppet { namespace runtime { namespace values {
 
     bool equality_visitor::operator()(std::string const& left, std::string const& right) const
     {
-        // Build the unicode string depending on which is shorter (faster "invariant" check)
         // Note: this is not a case insensitive check
         // String equality is case sensitive; Puppet's binary '==' operator is case insensitive
-        if (left.size() < right.size()) {
-            return unicode::string{ left } == right;
-        }
-        return unicode::string{ right } == left;
+        return unicode::equals(left, right);
     }
 
     bool operator==(value const& left, value const& right)
@@ -610,7 +608,11 @@ namespace puppet { namespace runtime { namespace values {
     size_t hash_value(values::value const& value)
     {
         // If a string, hash using unicode::string to handle Unicode normalization
+        // Invariant strings hash their code units directly, which is what unicode::string would do
         if (auto ptr = value.as<std::string>()) {
+            if (unicode::is_invariant(ptr->data(), ptr->size())) {
+                return boost::hash_range(ptr->data(), ptr->data() + ptr->size());
+            }
             unicode::string string{ *ptr };
             return hash_value(string);
         }
@@ -672,128 +674,104 @@ namespace puppet { namespace runtime { namespace values {
         }
     }
 
-    struct json_visitor : boost::static_visitor<json_value>
+    template <typename Writer>
+    struct json_visitor : boost::static_visitor<>
     {
-        json_visitor(json_allocator& allocator) :
-            _allocator(allocator)
+        explicit json_visitor(Writer& writer) :
+            _writer(writer)
         {
         }
 
         result_type operator()(undef const&) const
         {
-            json_value value;
-            value.SetNull();
-            return value;
+            _writer.Null();
         }
 
         result_type operator()(defaulted const&) const
         {
-            json_value value;
-            value.SetString("default");
-            return value;
+            _writer.String("default", 7);
         }
 
         result_type operator()(int64_t i) const
         {
-            json_value value;
-            value.SetInt64(i);
-            return value;
+            _writer.Int64(i);
         }
 
         result_type operator()(double d) const
         {
-            json_value value;
-            value.SetDouble(static_cast<double>(d));
-            return value;
+            _writer.Double(d);
         }
 
         result_type operator()(bool b) const
         {
-            json_value value;
-            value.SetBool(b);
-            return value;
+            _writer.Bool(b);
         }
 
         result_type operator()(string const& s) const
         {
-            json_value value;
-            value.SetString(StringRef(s.c_str(), s.size()));
-            return value;
+            write_string(s);
         }
 
         result_type operator()(values::regex const& regex) const
         {
-            auto const& pattern = regex.pattern();
-            json_value value;
-            value.SetString(StringRef(pattern.c_str(), pattern.size()));
-            return value;
+            write_string(regex.pattern());
         }
 
         result_type operator()(values::type const& type) const
         {
-            json_value value;
-            value.SetString(boost::lexical_cast<string>(type).c_str(), _allocator);
-            return value;
+            write_string(boost::lexical_cast<string>(type));
         }
 
         result_type operator()(values::variable const& variable) const
         {
-            return boost::apply_visitor(*this, variable.value());
+            boost::apply_visitor(*this, variable.value());
         }
 
         result_type operator()(values::array const& array) const
         {
-            json_value value;
-            value.SetArray();
-            value.Reserve(array.size(), _allocator);
-
+            _writer.StartArray();
             for (auto const& element : array) {
-                value.PushBack(boost::apply_visitor(*this, *element), _allocator);
+                boost::apply_visitor(*this, *element);
             }
-            return value;
+            _writer.EndArray(static_cast<SizeType>(array.size()));
         }
 
         result_type operator()(values::hash const& hash) const
         {
-            json_value value;
-            value.SetObject();
-
+            _writer.StartObject();
             for (auto const& kvp : hash) {
-                value.AddMember(
-                    json_value(boost::lexical_cast<string>(kvp.key()).c_str(), _allocator),
-                    boost::apply_visitor(*this, kvp.value()),
-                    _allocator
-                );
+                write_key(kvp.key());
+                boost::apply_visitor(*this, kvp.value());
             }
-            return value;
+            _writer.EndObject(static_cast<SizeType>(hash.size()));
         }
 
         result_type operator()(values::iterator const& iterator) const
         {
-            json_value result;
-
-            bool is_hash = iterator.value().as<values::hash>();
+            bool is_hash = iterator.keyed();
 
             if (is_hash) {
-                result.SetObject();
+                _writer.StartObject();
             } else {
-                result.SetArray();
+                _writer.StartArray();
             }
 
-            // Copy the iteration into the result
+            // Write the iteration directly to the writer
+            SizeType count = 0;
             iterator.each([&](auto const* key, auto const& value) {
                 if (key) {
-                    result.AddMember(
-                        json_value(boost::lexical_cast<string>(*key).c_str(), _allocator),
-                        boost::apply_visitor(*this, value),
-                        _allocator
-                    );
-                } else {
-                    result.PushBack(boost::apply_visitor(*this, value), _allocator);
+                    this->write_key(*key);
                 }
+                boost::apply_visitor(*this, value);
+                ++count;
                 return true;
             });
-            return result;
+
+            if (is_hash) {
+                _writer.EndObject(count);
+            } else {
+                _writer.EndArray(count);
+            }
         }
 
         result_type operator()(values::break_iteration const& value) const
@@ -815,12 +793,33 @@ namespace puppet { namespace runtime { namespace values {
         }
 
      private:
-        json_allocator& _allocator;
+        void write_string(string const& s) const
+        {
+            _writer.String(s.c_str(), static_cast<SizeType>(s.size()));
+        }
+
+        void write_key(values::value const& key) const
+        {
+            // Avoid formatting string keys
+            if (auto ptr = key.as<string>()) {
+                _writer.Key(ptr->c_str(), static_cast<SizeType>(ptr->size()));
+                return;
+            }
+            auto formatted = boost::lexical_cast<string>(key);
+            _writer.Key(formatted.c_str(), static_cast<SizeType>(formatted.size()));
+        }
+
+        Writer& _writer;
     };
 
-    json_value value::to_json(json_allocator& allocator) const
+    void value::write(json_writer& writer) const
+    {
+        boost::apply_visitor(json_visitor<json_writer>(writer), *this);
+    }
+
+    void value::write(json_pretty_writer& writer) const
     {
-        return boost::apply_visitor(json_visitor(allocator), *this);
+        boost::apply_visitor(json_visitor<json_pretty_writer>(writer), *this);
     }
 
 }}}  // namespace puppet::runtime::values
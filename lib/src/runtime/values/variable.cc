@@ -6,9 +6,12 @@ using namespace std;
 
 namespace puppet { namespace runtime { namespace values {
 
-    variable::variable(string name, shared_ptr<values::value const> value) :
+    constexpr size_t variable::npos;
+
+    variable::variable(string name, shared_ptr<values::value const> value, size_t slot) :
         _name(rvalue_cast(name)),
-        _value(rvalue_cast(value))
+        _value(rvalue_cast(value)),
+        _slot(slot)
     {
     }
 
@@ -28,6 +31,11 @@ namespace puppet { namespace runtime { namespace values {
         return _value;
     }
 
+    size_t variable::slot() const
+    {
+        return _slot;
+    }
+
     void variable::assign(shared_ptr<values::value const> value)
     {
         _value = rvalue_cast(value);
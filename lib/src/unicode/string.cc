@@ -1187,4 +1187,59 @@ namespace puppet { namespace unicode {
          return collator::sensitive().hash(string.data(), string.units());
      }
 
+    bool is_invariant(char const* data, size_t length) noexcept
+    {
+        // Check a word at a time for any code unit with the high bit set
+        static const uint64_t high_bits = 0x8080808080808080ull;
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            if (word & high_bits) {
+                return false;
+            }
+        }
+        for (; i < length; ++i) {
+            if (static_cast<unsigned char>(data[i]) & 0x80) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool is_collation_invariant(std::string const& string) noexcept
+    {
+        // Control characters other than whitespace are ignorable to the collator, so only printable ASCII
+        // and whitespace can be compared without it
+        for (auto c : string) {
+            if (!((c >= 0x20 && c <= 0x7e) || (c >= '\t' && c <= '\r'))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool equals(std::string const& left, std::string const& right, bool ignore_case)
+    {
+        // Identical code units are always equal
+        if (left.size() == right.size() && memcmp(left.data(), right.data(), left.size()) == 0) {
+            return true;
+        }
+
+        if (!ignore_case) {
+            // An invariant string can only equal another string with the same code units
+            if (is_invariant(left.data(), left.size()) || is_invariant(right.data(), right.size())) {
+                return false;
+            }
+            return collator::sensitive().compare(left.data(), left.size(), right.data(), right.size()) == 0;
+        }
+
+        // ASCII case folding preserves length, so printable ASCII strings can be compared without the collator
+        if (is_collation_invariant(left) && is_collation_invariant(right)) {
+            return boost::iequals(left, right, std::locale::classic());
+        }
+        return collator::insensitive().compare(left.data(), left.size(), right.data(), right.size()) == 0;
+    }
+
 }}  // namespace puppet::unicode
@@ -0,0 +1,93 @@
+#include <puppet/utility/filesystem/mapped_file.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace puppet { namespace utility { namespace filesystem {
+
+    mapped_file::mapped_file(string const& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            close(fd);
+            return;
+        }
+
+        _opened = true;
+        _size = static_cast<size_t>(info.st_size);
+
+        // An empty file cannot be mapped; point at the empty buffer instead
+        if (_size == 0) {
+            _data = _buffer.c_str();
+            close(fd);
+            return;
+        }
+
+        auto address = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            // The lexer reads the file front to back
+            posix_madvise(address, _size, POSIX_MADV_SEQUENTIAL);
+            _data = static_cast<char const*>(address);
+            _mapped = true;
+            close(fd);
+            return;
+        }
+
+        // Mapping failed, so fall back to reading the file into the buffer
+        _buffer.resize(_size);
+        size_t offset = 0;
+        while (offset < _size) {
+            auto result = read(fd, &_buffer[offset], _size - offset);
+            if (result <= 0) {
+                break;
+            }
+            offset += static_cast<size_t>(result);
+        }
+        close(fd);
+
+        _buffer.resize(offset);
+        _size = offset;
+        _data = _buffer.c_str();
+    }
+
+    mapped_file::~mapped_file()
+    {
+        if (_mapped) {
+            munmap(const_cast<char*>(_data), _size);
+        }
+    }
+
+    mapped_file::operator bool() const
+    {
+        return _opened;
+    }
+
+    char const* mapped_file::data() const
+    {
+        return _data;
+    }
+
+    size_t mapped_file::size() const
+    {
+        return _size;
+    }
+
+    char const* mapped_file::begin() const
+    {
+        return _data;
+    }
+
+    char const* mapped_file::end() const
+    {
+        return _data + _size;
+    }
+
+}}}  // namespace puppet::utility::filesystem
@@ -0,0 +1,57 @@
+#include <puppet/utility/filesystem/mapped_file.hpp>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+namespace puppet { namespace utility { namespace filesystem {
+
+    mapped_file::mapped_file(string const& path)
+    {
+        // Memory mapping is not supported on this platform, so read the file once into the buffer
+        ifstream file{ path, ios::in | ios::binary };
+        if (!file) {
+            return;
+        }
+
+        _buffer.assign(istreambuf_iterator<char>{ file }, istreambuf_iterator<char>{});
+        if (file.bad()) {
+            _buffer.clear();
+            return;
+        }
+
+        _opened = true;
+        _size = _buffer.size();
+        _data = _buffer.c_str();
+    }
+
+    mapped_file::~mapped_file()
+    {
+    }
+
+    mapped_file::operator bool() const
+    {
+        return _opened;
+    }
+
+    char const* mapped_file::data() const
+    {
+        return _data;
+    }
+
+    size_t mapped_file::size() const
+    {
+        return _size;
+    }
+
+    char const* mapped_file::begin() const
+    {
+        return _data;
+    }
+
+    char const* mapped_file::end() const
+    {
+        return _data + _size;
+    }
+
+}}}  // namespace puppet::utility::filesystem
@@ -0,0 +1,127 @@
+#include <puppet/utility/output_buffer.hpp>
+#include <puppet/cast.hpp>
+#include <boost/format.hpp>
+#include <limits>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace puppet { namespace utility {
+
+    constexpr size_t output_buffer::default_capacity;
+
+    output_buffer::output_buffer() :
+        _capacity(numeric_limits<size_t>::max()),
+        _descriptor(-1),
+        _stream(nullptr)
+    {
+    }
+
+    output_buffer::output_buffer(int descriptor, size_t capacity) :
+        _capacity(capacity == 0 ? 1 : capacity),
+        _descriptor(descriptor),
+        _stream(nullptr)
+    {
+        _buffer.reserve(_capacity);
+    }
+
+    output_buffer::output_buffer(ostream& stream, size_t capacity) :
+        _capacity(capacity == 0 ? 1 : capacity),
+        _descriptor(-1),
+        _stream(&stream)
+    {
+        _buffer.reserve(_capacity);
+    }
+
+    output_buffer::~output_buffer()
+    {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    void output_buffer::write(char const* data, size_t size)
+    {
+        // Write large blocks straight through to the sink rather than copying them into the buffer
+        if (size >= _capacity && (_descriptor >= 0 || _stream)) {
+            drain();
+            write_through(data, size);
+            return;
+        }
+        if (_buffer.size() + size > _capacity) {
+            drain();
+        }
+        _buffer.append(data, size);
+    }
+
+    void output_buffer::flush()
+    {
+        drain();
+        if (_stream) {
+            _stream->flush();
+        }
+    }
+
+    string const& output_buffer::contents() const
+    {
+        return _buffer;
+    }
+
+    string output_buffer::take()
+    {
+        string result = rvalue_cast(_buffer);
+        _buffer.clear();
+        return result;
+    }
+
+    void output_buffer::drain()
+    {
+        // Memory buffers are never drained
+        if (_buffer.empty() || (_descriptor < 0 && !_stream)) {
+            return;
+        }
+
+        // Discard the buffered output even if the write fails
+        try {
+            write_through(_buffer.data(), _buffer.size());
+        } catch (...) {
+            _buffer.clear();
+            throw;
+        }
+        _buffer.clear();
+    }
+
+    void output_buffer::write_through(char const* data, size_t size)
+    {
+        if (_stream) {
+            _stream->write(data, static_cast<streamsize>(size));
+            return;
+        }
+
+        size_t offset = 0;
+        while (offset < size) {
+#ifdef _WIN32
+            auto result = _write(_descriptor, data + offset, static_cast<unsigned int>(size - offset));
+#else
+            auto result = ::write(_descriptor, data + offset, size - offset);
+#endif
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                auto error = errno;
+                throw runtime_error((boost::format("failed to write output: %1%.") % strerror(error)).str());
+            }
+            offset += static_cast<size_t>(result);
+        }
+    }
+
+}}  // namespace puppet::utility
@@ -1,4 +1,8 @@
 #include <puppet/utility/regex.hpp>
+#include <puppet/cast.hpp>
+#include <boost/functional/hash.hpp>
+#include <unordered_map>
+#include <mutex>
 
 using namespace std;
 
@@ -104,15 +108,61 @@ namespace puppet { namespace utility {
         return _code;
     }
 
-    regex::regex(string const& expression) :
-        _wrapper(make_shared<wrapper>())
+    regex::regex(string const& expression, OnigOptionType options) :
+        _wrapper(compile(expression, options))
     {
+    }
+
+    regex_t const& regex::get() const
+    {
+        return _wrapper->get();
+    }
+
+    // The process-wide cache of compiled expressions, keyed by expression and options
+    struct regex::cache
+    {
+        using key_type = pair<string, OnigOptionType>;
+
+        static cache& instance()
+        {
+            static cache instance;
+            return instance;
+        }
+
+        std::mutex mutex;
+        unordered_map<key_type, shared_ptr<wrapper>, boost::hash<key_type>> compiled;
+    };
+
+    size_t regex::cached()
+    {
+        auto& store = cache::instance();
+        lock_guard<std::mutex> lock{ store.mutex };
+        return store.compiled.size();
+    }
+
+    shared_ptr<regex::wrapper> regex::compile(string const& expression, OnigOptionType options)
+    {
+        // The maximum number of compiled expressions to keep in the cache
+        static const size_t MAX_CACHED = 4096;
+
+        auto& store = cache::instance();
+        cache::key_type key{ expression, options };
+        {
+            lock_guard<std::mutex> lock{ store.mutex };
+            auto it = store.compiled.find(key);
+            if (it != store.compiled.end()) {
+                return it->second;
+            }
+        }
+
+        // Compile outside of the lock; if another thread compiles the same expression, the first one cached wins
+        auto compiled = make_shared<wrapper>();
         OnigErrorInfo error_info;
         int result = onig_new_without_alloc(
-            &_wrapper->get(),
+            &compiled->get(),
             reinterpret_cast<OnigUChar const*>(expression.data()),
             reinterpret_cast<OnigUChar const*>(expression.data() + expression.size()),
-            ONIG_OPTION_DEFAULT,
+            options,
             ONIG_ENCODING_UTF8,
             const_cast<OnigSyntaxType*>(ONIG_SYNTAX_RUBY),
             &error_info
@@ -122,6 +172,23 @@ namespace puppet { namespace utility {
             onig_error_code_to_str(message, result, &error_info);
             throw regex_exception(reinterpret_cast<char const*>(message), result);
         }
+
+        lock_guard<std::mutex> lock{ store.mutex };
+        if (store.compiled.size() >= MAX_CACHED) {
+            // Evict the expressions that are only referenced by the cache
+            for (auto it = store.compiled.begin(); it != store.compiled.end();) {
+                if (it->second.use_count() == 1) {
+                    it = store.compiled.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            // If everything is still in use, start over; existing regexes keep their compiled expression alive
+            if (store.compiled.size() >= MAX_CACHED) {
+                store.compiled.clear();
+            }
+        }
+        return store.compiled.emplace(rvalue_cast(key), rvalue_cast(compiled)).first->second;
     }
 
     bool regex::match(string const& str, regex::regions* regions) const
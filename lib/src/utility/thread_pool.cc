@@ -0,0 +1,68 @@
+#include <puppet/utility/thread_pool.hpp>
+#include <puppet/cast.hpp>
+
+using namespace std;
+
+namespace puppet { namespace utility {
+
+    thread_pool::thread_pool(size_t size) :
+        _size(size ? size : max(thread::hardware_concurrency(), 1u))
+    {
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            unique_lock<mutex> lock{ _mutex };
+            _stopping = true;
+        }
+        _condition.notify_all();
+
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    size_t thread_pool::size() const
+    {
+        return _size;
+    }
+
+    void thread_pool::enqueue(function<void()> work)
+    {
+        {
+            unique_lock<mutex> lock{ _mutex };
+            _work.emplace(rvalue_cast(work));
+
+            // Start another worker if none are idle and the pool has not reached its bound
+            if (_idle == 0 && _threads.size() < _size) {
+                _threads.emplace_back([this]() { run(); });
+            }
+        }
+        _condition.notify_one();
+    }
+
+    void thread_pool::run()
+    {
+        unique_lock<mutex> lock{ _mutex };
+        while (true) {
+            if (_work.empty()) {
+                if (_stopping) {
+                    return;
+                }
+                ++_idle;
+                _condition.wait(lock, [this]() { return _stopping || !_work.empty(); });
+                --_idle;
+                continue;
+            }
+
+            auto work = rvalue_cast(_work.front());
+            _work.pop();
+
+            lock.unlock();
+            work();
+            lock.lock();
+        }
+    }
+
+}}  // namespace puppet::utility
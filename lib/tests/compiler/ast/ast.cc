@@ -1,5 +1,6 @@
 #include <catch.hpp>
 #include <puppet/compiler/ast/ast.hpp>
+#include <puppet/compiler/lexer/lexer.hpp>
 #include <puppet/cast.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -3950,4 +3951,62 @@ SCENARIO("syntax tree", "[ast]")
             REQUIRE(lexical_cast<std::string>(*tree) == "|Integer $bar| $foo = 1; $foo - 1");
         }
     }
+    WHEN("the source is set") {
+        tree->source("$foo = 1\n\t$foo - 1\n");
+        THEN("line information should be found from the source") {
+            auto first = tree->line_info(1, 3);
+            REQUIRE(first.text == "$foo = 1");
+            REQUIRE(first.column == 2);
+            REQUIRE(first.length == 3);
+            auto second = tree->line_info(10, 4);
+            REQUIRE(second.text == "\t$foo - 1");
+            REQUIRE(second.column == 5);
+            REQUIRE(second.length == 4);
+            REQUIRE(tree->line_info(19, 1).text.empty());
+        }
+    }
+}
+
+SCENARIO("allocating nodes from an arena", "[ast]")
+{
+    ast::arena arena;
+
+    WHEN("an arena is current") {
+        ast::scoped_arena scope{ &arena };
+        ast::forward_node<ast::array> node;
+        node.get().elements.resize(2);
+
+        THEN("nodes should be allocated from the arena") {
+            REQUIRE(ast::arena::current() == &arena);
+            REQUIRE(arena.size() == sizeof(ast::array));
+            REQUIRE(node.get().elements.size() == 2);
+        }
+    }
+    WHEN("the scope of an arena ends") {
+        {
+            ast::scoped_arena scope{ &arena };
+        }
+        THEN("nodes should be allocated from the heap") {
+            REQUIRE_FALSE(ast::arena::current());
+            ast::forward_node<ast::array> node;
+            REQUIRE(arena.size() == 0);
+        }
+    }
+    WHEN("a node from an arena is copied and moved without a current arena") {
+        auto original = [&]() {
+            ast::scoped_arena scope{ &arena };
+            return ast::forward_node<ast::array>{};
+        }();
+        auto size = arena.size();
+        ast::forward_node<ast::array> copy{ original };
+        auto pointer = original.get_pointer();
+        ast::forward_node<ast::array> moved{ rvalue_cast(original) };
+
+        THEN("the copy should be allocated from the heap and the move should keep the arena's node") {
+            REQUIRE(size == sizeof(ast::array));
+            REQUIRE(arena.size() == size);
+            REQUIRE(copy.get_pointer() != pointer);
+            REQUIRE(moved.get_pointer() == pointer);
+        }
+    }
 }
@@ -0,0 +1,126 @@
+#include <catch.hpp>
+#include <puppet/compiler/node.hpp>
+#include <boost/filesystem.hpp>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::compiler;
+namespace fs = boost::filesystem;
+
+static shared_ptr<compiler::environment> create_environment(logging::logger& logger)
+{
+    compiler::settings settings;
+    settings.set(settings::environment_path, (fs::path{FIXTURES_DIR} / "compiler" / "environments").string());
+    settings.set(settings::environment, "evaluation");
+
+    auto environment = compiler::environment::create(logger, settings);
+    environment->dispatcher().add_builtin_functions();
+    environment->dispatcher().add_builtin_operators();
+    return environment;
+}
+
+static string detect_cycles(compiler::catalog& catalog, size_t limit)
+{
+    try {
+        catalog.detect_cycles(limit);
+    } catch (resource_cycle_exception const& ex) {
+        return ex.what();
+    }
+    return {};
+}
+
+SCENARIO("detecting cycles in a catalog", "[catalog]")
+{
+    puppet::logging::console_logger logger;
+    auto path = (fs::path{FIXTURES_DIR} / "compiler" / "catalog" / "cycles.pp").string();
+    compiler::node node{ logger, "test", create_environment(logger), nullptr };
+    auto catalog = node.compile({ path });
+
+    auto ab = "Notify[a] declared at " + path + ":1 => Notify[b] declared at " + path + ":2 => Notify[a]";
+    auto bc = "Notify[b] declared at " + path + ":2 => Notify[c] declared at " + path + ":3 => Notify[b]";
+    auto de = "Notify[d] declared at " + path + ":4 => Notify[e] declared at " + path + ":5 => Notify[d]";
+
+    WHEN("no limit is given") {
+        THEN("every cycle in each strongly connected component should be reported") {
+            REQUIRE(detect_cycles(catalog, 0) ==
+                "found 3 resource dependency cycles:\n"
+                "  1. " + ab + "\n"
+                "  2. " + bc + "\n"
+                "  3. " + de);
+        }
+    }
+    WHEN("the limit is the number of cycles") {
+        THEN("every cycle should be reported") {
+            REQUIRE(detect_cycles(catalog, 3) ==
+                "found 3 resource dependency cycles:\n"
+                "  1. " + ab + "\n"
+                "  2. " + bc + "\n"
+                "  3. " + de);
+        }
+    }
+    WHEN("the limit is less than the number of cycles") {
+        THEN("the report should be truncated") {
+            REQUIRE(detect_cycles(catalog, 2) ==
+                "found more than 2 resource dependency cycles; showing the first 2:\n"
+                "  1. " + ab + "\n"
+                "  2. " + bc);
+        }
+    }
+    WHEN("the limit stops enumeration within a component") {
+        THEN("the report should be truncated") {
+            REQUIRE(detect_cycles(catalog, 1) ==
+                "found more than 1 resource dependency cycles; showing the first 1:\n"
+                "  1. " + ab);
+        }
+    }
+}
+
+SCENARIO("relating resources in a catalog", "[catalog]")
+{
+    puppet::logging::console_logger logger;
+    auto path = (fs::path{FIXTURES_DIR} / "compiler" / "catalog" / "edges.pp").string();
+    compiler::node node{ logger, "test", create_environment(logger), nullptr };
+    auto catalog = node.compile({ path });
+
+    auto a = catalog.find(runtime::types::resource{ "notify", "a" });
+    auto b = catalog.find(runtime::types::resource{ "notify", "b" });
+    REQUIRE(a);
+    REQUIRE(b);
+
+    auto edges = [&]() {
+        vector<pair<relationship, compiler::resource const*>> result;
+        catalog.each_edge(*b, [&](relationship relation, compiler::resource const& target) {
+            result.emplace_back(relation, &target);
+            return true;
+        });
+        sort(result.begin(), result.end());
+        return result;
+    };
+
+    WHEN("the same relationship is declared more than once") {
+        THEN("only one edge should be added for each kind of relationship") {
+            auto result = edges();
+            REQUIRE(result.size() == 2);
+            REQUIRE(result[0].first == relationship::before);
+            REQUIRE(result[0].second == a);
+            REQUIRE(result[1].first == relationship::notify);
+            REQUIRE(result[1].second == a);
+        }
+    }
+    WHEN("relating the resources again") {
+        catalog.relate(relationship::before, *a, *b);
+        catalog.relate(relationship::require, *b, *a);
+        catalog.relate(relationship::require, *b, *a);
+
+        THEN("only an edge for the new kind of relationship should be added") {
+            auto result = edges();
+            REQUIRE(result.size() == 3);
+            REQUIRE(result[0].first == relationship::before);
+            REQUIRE(result[1].first == relationship::require);
+            REQUIRE(result[1].second == a);
+            REQUIRE(result[2].first == relationship::notify);
+        }
+    }
+}
@@ -1,6 +1,10 @@
 #include <catch.hpp>
 #include <puppet/compiler/environment.hpp>
+#include <puppet/compiler/exceptions.hpp>
 #include <boost/filesystem.hpp>
+#include <thread>
+#include <atomic>
+#include <fstream>
 
 using namespace std;
 using namespace puppet;
@@ -225,6 +229,78 @@ SCENARIO("environment with files to import", "[environment]")
             import(logger, *environment, find_type::type, "Foo::Nope", false);
         }
     }
+    WHEN("importing a missing name more than once") {
+        THEN("the name should remain missing and other files should still be imported") {
+            import(logger, *environment, find_type::manifest, "bar::nope", false);
+            import(logger, *environment, find_type::manifest, "bar::nope", false);
+            import(logger, *environment, find_type::manifest, "foo::bar", false);
+            import(logger, *environment, find_type::manifest, "foo::bar", false);
+            import(logger, *environment, find_type::function, "foo::bar");
+            import(logger, *environment, find_type::manifest, "bar::baz");
+        }
+    }
+    WHEN("importing from multiple threads") {
+        THEN("each file should be parsed once and its definitions should be visible to every thread") {
+            // Scanning a file more than once would raise a "previously defined" error for its definitions
+            atomic<size_t> failures{ 0 };
+            vector<thread> threads;
+            for (size_t i = 0; i < 8; ++i) {
+                threads.emplace_back([&]() {
+                    try {
+                        environment->import(logger, find_type::manifest, "bar::baz");
+                        environment->import(logger, find_type::function, "foo::bar");
+                        environment->import(logger, find_type::type, "Foo::Baz::Wut");
+                    } catch (...) {
+                        ++failures;
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            REQUIRE(failures == 0);
+            REQUIRE((environment->registry().find_class("bar::baz") || environment->registry().find_defined_type("bar::baz")));
+            REQUIRE(environment->dispatcher().find("foo::bar"));
+            REQUIRE(environment->registry().find_type_alias("Foo::Baz::Wut"));
+        }
+    }
+}
+
+SCENARIO("environment with a file that fails to parse", "[environment]")
+{
+    puppet::logging::console_logger logger;
+
+    auto environments_dir = fs::temp_directory_path() / fs::unique_path("puppetcpp-environments-%%%%-%%%%-%%%%");
+    auto functions_dir = environments_dir / "retry" / "functions";
+    fs::create_directories(functions_dir);
+    auto path = (functions_dir / "foo.pp").string();
+    {
+        ofstream file{ path };
+        file << "function environment::foo( {";
+    }
+
+    compiler::settings settings;
+    settings.set(settings::environment_path, environments_dir.string());
+    settings.set(settings::environment, "retry");
+    settings.set(settings::base_module_path, "");
+
+    auto environment = puppet::compiler::environment::create(logger, settings);
+
+    WHEN("importing the file after it has been fixed") {
+        REQUIRE_THROWS_AS(environment->import(logger, find_type::function, "environment::foo"), compilation_exception);
+        REQUIRE_THROWS_AS(environment->import(logger, find_type::function, "environment::foo"), compilation_exception);
+        {
+            ofstream file{ path };
+            file << "function environment::foo() { }";
+        }
+        environment->import(logger, find_type::function, "environment::foo");
+
+        THEN("the file should be parsed again") {
+            REQUIRE(environment->dispatcher().find("environment::foo"));
+        }
+    }
+
+    fs::remove_all(environments_dir);
 }
 
 SCENARIO("environment with user files", "[environment]")
@@ -280,6 +356,42 @@ SCENARIO("environment with user files", "[environment]")
             REQUIRE(environment->resolve_path(logger, find_type::file, (environment_dir / "files" / "foo.txt").string()) == (environment_dir / "files" / "foo.txt").string());
         }
     }
+    WHEN("reading a file more than once") {
+        THEN("it should return the cached contents") {
+            auto path = (environment_dir / "files" / "foo.txt").string();
+            auto contents = environment->read_file(path);
+            REQUIRE(contents);
+            REQUIRE(environment->read_file(path) == contents);
+        }
+    }
+    WHEN("reading a missing file") {
+        THEN("it should return null") {
+            REQUIRE_FALSE(environment->read_file((environment_dir / "files" / "missing.txt").string()));
+        }
+    }
+    WHEN("reading a file that changes") {
+        auto directory = fs::temp_directory_path() / fs::unique_path("puppetcpp-files-%%%%-%%%%-%%%%");
+        fs::create_directories(directory);
+        auto path = (directory / "changing.txt").string();
+        {
+            ofstream file{ path };
+            file << "foo";
+        }
+        auto contents = environment->read_file(path);
+        {
+            ofstream file{ path };
+            file << "foobar";
+        }
+        auto changed = environment->read_file(path);
+        fs::remove_all(directory);
+
+        THEN("it should return the new contents") {
+            REQUIRE(contents);
+            REQUIRE(*contents == "foo");
+            REQUIRE(changed);
+            REQUIRE(*changed == "foobar");
+        }
+    }
 }
 
 SCENARIO("environment with user templates", "[environment]")
@@ -335,4 +447,53 @@ SCENARIO("environment with user templates", "[environment]")
             REQUIRE(environment->resolve_path(logger, find_type::template_, (environment_dir / "templates" / "foo.epp").string()) == (environment_dir / "templates" / "foo.epp").string());
         }
     }
+    WHEN("parsing a template more than once") {
+        THEN("it should return the cached syntax tree") {
+            auto path = (environment_dir / "templates" / "foo.epp").string();
+            auto tree = environment->parse_template(logger, path);
+            REQUIRE(tree);
+            REQUIRE(environment->parse_template(logger, path) == tree);
+        }
+    }
+    WHEN("parsing an inline template more than once") {
+        THEN("it should return the cached syntax tree") {
+            auto tree = environment->parse_inline_template(logger, "<%= $foo %>", "<epp>");
+            REQUIRE(tree);
+            REQUIRE(environment->parse_inline_template(logger, "<%= $foo %>", "<epp>") == tree);
+            REQUIRE(environment->parse_inline_template(logger, "<%= $bar %>", "<epp>") != tree);
+        }
+    }
+    WHEN("parsing a template that changes") {
+        auto directory = fs::temp_directory_path() / fs::unique_path("puppetcpp-templates-%%%%-%%%%-%%%%");
+        fs::create_directories(directory);
+        auto path = (directory / "changing.epp").string();
+        {
+            ofstream file{ path };
+            file << "<%= $foo %>";
+        }
+        auto tree = environment->parse_template(logger, path);
+        {
+            ofstream file{ path };
+            file << "<%= $foo %> <%= $bar %>";
+        }
+        auto changed = environment->parse_template(logger, path);
+        fs::remove_all(directory);
+
+        THEN("it should parse the template again") {
+            REQUIRE(tree);
+            REQUIRE(changed);
+            REQUIRE(changed != tree);
+            REQUIRE(changed->statements.size() > tree->statements.size());
+        }
+    }
+    WHEN("parsing more inline templates than are cached") {
+        auto tree = environment->parse_inline_template(logger, "<%= $foo %>", "<epp>");
+        for (size_t i = 0; i < 1024; ++i) {
+            environment->parse_inline_template(logger, "<%= $foo %>" + to_string(i), "<epp>");
+        }
+        THEN("it should evict the oldest templates") {
+            REQUIRE(tree);
+            REQUIRE(environment->parse_inline_template(logger, "<%= $foo %>", "<epp>") != tree);
+        }
+    }
 }
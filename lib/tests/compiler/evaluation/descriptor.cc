@@ -0,0 +1,157 @@
+#include <catch.hpp>
+#include <puppet/compiler/evaluation/repl.hpp>
+#include <puppet/compiler/evaluation/functions/descriptor.hpp>
+#include <puppet/compiler/evaluation/functions/call_context.hpp>
+#include <puppet/cast.hpp>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::compiler;
+using namespace puppet::compiler::evaluation;
+using namespace puppet::runtime;
+
+SCENARIO("dispatching to functions with signatures derived from the callback", "[evaluation]")
+{
+    compiler::settings settings;
+    logging::console_logger logger;
+
+    auto environment = compiler::environment::create(logger, settings);
+    environment->dispatcher().add_builtin_functions();
+    environment->dispatcher().add_builtin_operators();
+
+    functions::descriptor typed{ "typed" };
+    typed.add([](functions::call_context& context, int64_t first, string const& second, values::array const& third) -> values::value {
+        return second + ":" + to_string(first) + ":" + to_string(third.size());
+    });
+    typed.add([](functions::call_context& context, values::hash const& first) -> values::value {
+        return static_cast<int64_t>(first.size());
+    });
+    typed.add([](functions::call_context& context, double first, bool second, values::regex const& third, values::type const& fourth, values::value const& fifth) -> values::value {
+        values::array result;
+        result.emplace_back(first);
+        result.emplace_back(second);
+        result.emplace_back(third.pattern());
+        result.emplace_back(boost::lexical_cast<string>(fourth));
+        result.emplace_back(fifth);
+        return result;
+    });
+    environment->dispatcher().add(rvalue_cast(typed));
+
+    compiler::node node{ logger, "test", rvalue_cast(environment), nullptr };
+    compiler::catalog catalog{ node.name(), node.environment().name() };
+    auto context = node.create_context(catalog);
+    evaluation::scoped_stack_frame frame{ context, evaluation::stack_frame{ "<repl>", context.top_scope(), false }};
+
+    boost::optional<compilation_exception> exception;
+    evaluation::repl repl{
+        context,
+        [&](compilation_exception const& ex) {
+            exception = ex;
+        }
+    };
+
+    WHEN("the arguments match a signature") {
+        THEN("the arguments should be unpacked into the callback's parameters") {
+            auto result = repl.evaluate("typed(1, 'foo', [1, 2, 3])");
+            REQUIRE_FALSE(exception);
+            REQUIRE(result);
+            REQUIRE(boost::lexical_cast<string>(result->value) == "foo:1:3");
+
+            result = repl.evaluate("typed({ a => 1, b => 2 })");
+            REQUIRE_FALSE(exception);
+            REQUIRE(result);
+            REQUIRE(boost::lexical_cast<string>(result->value) == "2");
+
+            result = repl.evaluate("typed(2.5, true, /b+/, Integer[1, 2], x)");
+            REQUIRE_FALSE(exception);
+            REQUIRE(result);
+            REQUIRE(boost::lexical_cast<string>(result->value) == "[2.5, true, b+, Integer[1, 2], x]");
+        }
+    }
+    WHEN("an argument does not match the derived parameter type") {
+        THEN("the expected Puppet type should be reported") {
+            repl.evaluate("typed('1', 'foo', [])");
+            REQUIRE(exception);
+            REQUIRE(string{ exception->what() } == "function 'typed' expects Integer but was given String[1, 1].");
+        }
+    }
+    WHEN("an argument does not match a derived collection type") {
+        THEN("the expected Puppet type should be reported") {
+            repl.evaluate("typed(1, 'foo', { a => 1 })");
+            REQUIRE(exception);
+            REQUIRE(string{ exception->what() } == "function 'typed' expects Array[Any] but was given Hash[String[1, 1], Integer[1, 1], 1, 1].");
+        }
+    }
+    WHEN("too many arguments are given") {
+        THEN("the derived argument counts should be reported") {
+            repl.evaluate("typed(1, 2, 3, 4, 5, 6)");
+            REQUIRE(exception);
+            REQUIRE(string{ exception->what() } == "function 'typed' expects at most 5 arguments but was given 6.");
+        }
+    }
+}
+
+
+SCENARIO("dispatching a call site with arguments of different kinds", "[evaluation]")
+{
+    compiler::settings settings;
+    logging::console_logger logger;
+
+    auto environment = compiler::environment::create(logger, settings);
+    environment->dispatcher().add_builtin_functions();
+    environment->dispatcher().add_builtin_operators();
+
+    functions::descriptor kinds{ "kinds" };
+    kinds.add([](functions::call_context& context, int64_t value) -> values::value {
+        return static_cast<int64_t>(1);
+    });
+    kinds.add([](functions::call_context& context, string const& value) -> values::value {
+        return static_cast<int64_t>(2);
+    });
+    kinds.add([](functions::call_context& context, values::value const& value) -> values::value {
+        return static_cast<int64_t>(0);
+    });
+    environment->dispatcher().add(rvalue_cast(kinds));
+
+    functions::descriptor digits{ "digits" };
+    digits.add("Callable[Integer[0, 9]]", [](functions::call_context& context) -> values::value {
+        return static_cast<int64_t>(10);
+    });
+    digits.add([](functions::call_context& context, int64_t value) -> values::value {
+        return static_cast<int64_t>(1);
+    });
+    digits.add([](functions::call_context& context, values::value const& value) -> values::value {
+        return static_cast<int64_t>(0);
+    });
+    environment->dispatcher().add(rvalue_cast(digits));
+
+    compiler::node node{ logger, "test", rvalue_cast(environment), nullptr };
+    compiler::catalog catalog{ node.name(), node.environment().name() };
+    auto context = node.create_context(catalog);
+    evaluation::scoped_stack_frame frame{ context, evaluation::stack_frame{ "<repl>", context.top_scope(), false }};
+
+    boost::optional<compilation_exception> exception;
+    evaluation::repl repl{
+        context,
+        [&](compilation_exception const& ex) {
+            exception = ex;
+        }
+    };
+
+    WHEN("the overloads only check the kinds of the arguments") {
+        THEN("each call should dispatch to the overload for its argument's kind") {
+            auto result = repl.evaluate("[1, 2, 'a', 3, 'b', 1.5, undef, 4].map |$x| { kinds($x) }");
+            REQUIRE_FALSE(exception);
+            REQUIRE(result);
+            REQUIRE(boost::lexical_cast<string>(result->value) == "[1, 1, 2, 1, 2, 0, 0, 1]");
+        }
+    }
+    WHEN("an earlier overload checks more than the kinds of the arguments") {
+        THEN("each call should dispatch to the first overload that accepts its argument") {
+            auto result = repl.evaluate("[1, 10, 2, 20, 'a', 3].map |$x| { digits($x) }");
+            REQUIRE_FALSE(exception);
+            REQUIRE(result);
+            REQUIRE(boost::lexical_cast<string>(result->value) == "[10, 1, 10, 1, 0, 10]");
+        }
+    }
+}
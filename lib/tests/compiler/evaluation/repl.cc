@@ -1,6 +1,7 @@
 #include <catch.hpp>
 #include <puppet/compiler/evaluation/repl.hpp>
 #include <puppet/cast.hpp>
+#include <vector>
 
 using namespace std;
 using namespace puppet;
@@ -100,6 +101,30 @@ SCENARIO("using the repl evaluator", "[evaluation]")
             }
         }
     }
+    WHEN("given logical operators that short-circuit") {
+        THEN("only the right-hand side of the short-circuited operator should be skipped") {
+            vector<pair<char const*, char const*>> expressions = {
+                { "false and $x or true", "true" },
+                { "true or $x and false", "true" },
+                { "false and true or false and true", "false" },
+                { "false or false and true or true", "true" },
+                { "1 == 2 and fail('not skipped') or 3 == 3", "true" },
+                { "false and true == true or 'yes' == 'yes'", "true" },
+                { "true or false and fail('not skipped') or fail('not skipped')", "true" },
+                { "false and (true or fail('not skipped'))", "false" },
+                { "$a = false and ($b = true)", "false" },
+                { "$c = true or ($d = true) and fail('not skipped')", "true" },
+                { "$e = false or ($f = true)", "true" },
+                { "[$a, defined('$b'), $c, defined('$d'), $e, $f]", "[false, false, true, false, true, true]" },
+            };
+            for (auto const& expression : expressions) {
+                auto result = repl.evaluate(expression.first);
+                REQUIRE_FALSE(exception);
+                REQUIRE(result);
+                REQUIRE(boost::lexical_cast<string>(result->value) == expression.second);
+            }
+        }
+    }
     WHEN("given a command with a syntax error") {
         auto result = repl.evaluate("class foo bar {}");
         THEN("a compilation error should be provided") {
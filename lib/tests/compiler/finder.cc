@@ -0,0 +1,90 @@
+#include <catch.hpp>
+#include <puppet/compiler/finder.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace std;
+using namespace puppet::compiler;
+namespace fs = boost::filesystem;
+namespace sys = boost::system;
+
+static void create_file(fs::path const& path)
+{
+    fs::create_directories(path.parent_path());
+    ofstream file{ path.string() };
+    REQUIRE(file);
+    file << "# " << path.filename().string() << '\n';
+}
+
+SCENARIO("finding files by name and path", "[finder]")
+{
+    auto directory = fs::temp_directory_path() / fs::unique_path("puppetcpp-finder-%%%%-%%%%-%%%%");
+    auto manifests = directory / "manifests";
+    create_file(manifests / "init.pp");
+    create_file(manifests / "foo.pp");
+    create_file(manifests / "foo" / "bar.pp");
+    create_file(manifests / "foo" / "bar" / "baz.pp");
+    create_file(manifests / "foo" / "notes.txt");
+    create_file(directory / "files" / "nested" / "data.txt");
+
+    finder finder{ directory.string() };
+
+    WHEN("finding files that exist") {
+        THEN("the paths to the files should be returned") {
+            REQUIRE(finder.find_by_name(find_type::manifest, "init") == (manifests / "init.pp").string());
+            REQUIRE(finder.find_by_name(find_type::manifest, "foo") == (manifests / "foo.pp").string());
+            REQUIRE(finder.find_by_path(find_type::file, "nested/data.txt") == (directory / "files" / "nested" / "data.txt").string());
+            REQUIRE(finder.find_by_path(find_type::file, "./nested/data.txt") == (directory / "files" / "nested" / "data.txt").string());
+        }
+    }
+    WHEN("finding files by nested names") {
+        THEN("each name component should be treated as a subdirectory") {
+            REQUIRE(finder.find_by_name(find_type::manifest, "foo::bar") == (manifests / "foo" / "bar.pp").string());
+            REQUIRE(finder.find_by_name(find_type::manifest, "foo::bar::baz") == (manifests / "foo" / "bar" / "baz.pp").string());
+        }
+    }
+    WHEN("finding files that do not exist") {
+        THEN("empty paths should be returned") {
+            REQUIRE(finder.find_by_name(find_type::manifest, "").empty());
+            REQUIRE(finder.find_by_name(find_type::manifest, "missing").empty());
+            REQUIRE(finder.find_by_name(find_type::manifest, "foo::missing").empty());
+            REQUIRE(finder.find_by_name(find_type::manifest, "foo::bar::baz::missing").empty());
+            REQUIRE(finder.find_by_name(find_type::manifest, "foo::notes").empty());
+            REQUIRE(finder.find_by_name(find_type::function, "foo").empty());
+            REQUIRE(finder.find_by_path(find_type::file, "nested").empty());
+            REQUIRE(finder.find_by_path(find_type::file, "nested/missing.txt").empty());
+        }
+    }
+    WHEN("the files directory contains symbolic links to directories") {
+        sys::error_code ec;
+        auto outside = directory / "outside";
+        create_file(outside / "linked.txt");
+        fs::create_directory_symlink(".", directory / "files" / "cycle", ec);
+        if (!ec) {
+            fs::create_directory_symlink("..", directory / "files" / "nested" / "parent", ec);
+        }
+        if (!ec) {
+            fs::create_directory_symlink(outside, directory / "files" / "outside", ec);
+        }
+        if (ec) {
+            WARN("skipping symbolic link tests: " << ec.message());
+        } else {
+            // Use a new finder so the index is built with the links present
+            puppet::compiler::finder linked{ directory.string() };
+            THEN("indexing should not follow the link cycles") {
+                REQUIRE(linked.find_by_path(find_type::file, "nested/data.txt") == (directory / "files" / "nested" / "data.txt").string());
+                REQUIRE(linked.find_by_path(find_type::file, "missing.txt").empty());
+            }
+            THEN("files beneath the links should be found from the file system") {
+                REQUIRE(linked.find_by_path(find_type::file, "cycle/nested/data.txt") == (directory / "files" / "cycle" / "nested" / "data.txt").string());
+                REQUIRE(linked.find_by_path(find_type::file, "nested/parent/cycle/nested/data.txt") == (directory / "files" / "nested" / "parent" / "cycle" / "nested" / "data.txt").string());
+                REQUIRE(linked.find_by_path(find_type::file, "outside/linked.txt") == (directory / "files" / "outside" / "linked.txt").string());
+                REQUIRE(linked.find_by_path(find_type::file, "cycle/missing.txt").empty());
+                REQUIRE(linked.find_by_path(find_type::file, "outside").empty());
+            }
+        }
+    }
+
+    sys::error_code ec;
+    fs::remove_all(directory, ec);
+}
@@ -305,6 +305,35 @@ SCENARIO("getting ranges of tokens", "[lexer]")
             REQUIRE(token == end);
         }
     }
+    WHEN("lexing a mapped file") {
+        puppet::utility::filesystem::mapped_file input{ FIXTURES_DIR "compiler/lexer/single_quoted_strings.pp" };
+        REQUIRE(input);
+        REQUIRE(get_last_position(input).offset() == 159);
+
+        auto input_begin = lex_begin(input);
+        auto input_end = lex_end(input);
+
+        buffer_static_lexer lexer;
+        auto token = lexer.begin(input_begin, input_end);
+        auto end = lexer.end();
+
+        for (auto const& range : ranges) {
+            REQUIRE((token != end));
+            position begin, end;
+            tie(begin, end) = boost::apply_visitor(token_range_visitor(), token->value());
+            REQUIRE(begin == range.first);
+            REQUIRE(end == range.second);
+            ++token;
+        }
+        REQUIRE(token == end);
+
+        THEN("the text and column for a position should match what's expected") {
+            auto info = get_line_info(input, ranges[4].first.offset(), 1);
+            REQUIRE(info.column == 2);
+            REQUIRE(info.length == 1);
+            REQUIRE(info.text == " 'this back\\\\slash is escaped'");
+        }
+    }
 }
 
 SCENARIO("lexing double quoted strings", "[lexer]")
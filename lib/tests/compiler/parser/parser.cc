@@ -149,6 +149,19 @@ SCENARIO("parsing files", "[parser]")
                 REQUIRE(tree->path() == path.string());
                 REQUIRE(tree->shared_path());
                 REQUIRE(tree->source().empty());
+
+                // Line information should be found from the mapped source
+                ifstream file{ path.string(), ios::binary };
+                REQUIRE(file);
+                ostringstream contents;
+                contents << file.rdbuf();
+                REQUIRE(tree->text() == contents.str());
+                auto position = contents.str().size() / 2;
+                auto expected = get_line_info(contents.str(), position, 1);
+                auto actual = tree->line_info(position, 1);
+                REQUIRE(actual.text == expected.text);
+                REQUIRE(actual.column == expected.column);
+                REQUIRE(actual.length == expected.length);
                 tree->write(format::yaml, buffer);
             } catch (puppet::compiler::parse_exception const& ex) {
                 puppet::compiler::compilation_exception exception{ ex, path.string() };
@@ -161,6 +174,36 @@ SCENARIO("parsing files", "[parser]")
             REQUIRE(difference.empty());
         }
 
+        // Next round-trip the syntax tree through the XPP format (only files that parse successfully are written)
+        {
+            stringstream buffer;
+            test_logger logger{ buffer };
+
+            shared_ptr<syntax_tree> tree;
+            try {
+                tree = parse_file(logger, path.string(), dummy_module, is_epp);
+                tree->validate();
+            } catch (puppet::compiler::parse_exception const&) {
+                tree.reset();
+            }
+
+            if (tree) {
+                stringstream xpp;
+                tree->write(format::xpp, xpp);
+                auto loaded = syntax_tree::read(format::xpp, xpp, path.string(), dummy_module);
+                REQUIRE(loaded);
+                REQUIRE(loaded->module() == dummy_module);
+                REQUIRE(loaded->path() == path.string());
+                REQUIRE(loaded->text() == tree->text());
+                loaded->write(format::yaml, buffer);
+
+                buffer.str(normalize(buffer.str()));
+                auto difference = calculate_difference(buffer, baseline_lines);
+                CAPTURE(difference);
+                REQUIRE(difference.empty());
+            }
+        }
+
         // Next read the file as a string and parse the string
         {
             std::string source;
@@ -0,0 +1,68 @@
+#include <catch.hpp>
+#include <puppet/compiler/symbol.hpp>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace puppet::compiler;
+
+SCENARIO("symbol", "[symbol]")
+{
+    WHEN("a symbol is empty") {
+        symbol empty;
+        THEN("it should have an empty name") {
+            REQUIRE_FALSE(empty);
+            REQUIRE(empty.name().empty());
+        }
+    }
+    WHEN("the same name is interned more than once") {
+        symbol first{ "symbol_test_foo" };
+        symbol second{ string("symbol_test_") + "foo" };
+        THEN("the symbols should be equal and share the name") {
+            REQUIRE(first);
+            REQUIRE(first == second);
+            REQUIRE(&first.name() == &second.name());
+            REQUIRE(first.name() == "symbol_test_foo");
+            REQUIRE(first.hash() == std::hash<string>()("symbol_test_foo"));
+        }
+        THEN("finding the name should return the symbol") {
+            REQUIRE(symbol::find("symbol_test_foo") == first);
+        }
+    }
+    WHEN("different names are interned") {
+        THEN("the symbols should not be equal") {
+            REQUIRE(symbol{ "symbol_test_bar" } != symbol{ "symbol_test_baz" });
+        }
+    }
+    WHEN("a name has not been interned") {
+        THEN("finding the name should return an empty symbol") {
+            REQUIRE_FALSE(symbol::find("symbol_test_never_interned"));
+        }
+    }
+    WHEN("a name is interned by another thread after it could not be found") {
+        REQUIRE_FALSE(symbol::find("symbol_test_late"));
+        symbol interned;
+        thread{ [&]() { interned = symbol{ "symbol_test_late" }; } }.join();
+        THEN("finding the name should return the symbol") {
+            REQUIRE(interned);
+            REQUIRE(symbol::find("symbol_test_late") == interned);
+        }
+    }
+    WHEN("interning from multiple threads") {
+        THEN("each thread should get the same symbol") {
+            vector<symbol> symbols(8);
+            vector<thread> threads;
+            for (size_t i = 0; i < symbols.size(); ++i) {
+                threads.emplace_back([&, i]() {
+                    symbols[i] = symbol{ "symbol_test_threaded" };
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            for (auto const& symbol : symbols) {
+                REQUIRE(symbol == symbols.front());
+            }
+        }
+    }
+}
@@ -0,0 +1,9 @@
+notify { a: }
+notify { b: }
+notify { c: }
+notify { d: }
+notify { e: }
+
+Notify[a] -> Notify[b] -> Notify[a]
+Notify[b] -> Notify[c] -> Notify[b]
+Notify[d] -> Notify[e] -> Notify[d]
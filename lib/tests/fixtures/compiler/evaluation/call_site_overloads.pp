@@ -0,0 +1,25 @@
+function split_with($value, $pattern) {
+    split($value, $pattern)
+}
+
+function sum($arguments) {
+    reduce(*$arguments) |$memo, $value| { $memo + $value }
+}
+
+function check($type, $value) {
+    assert_type($type, $value)
+}
+
+[1, 2].each |$round| {
+    notice split_with('a,b', ',')
+    notice split_with('a1b2c', /\d/)
+    notice split_with('a1b2c', Regexp['\d'])
+    notice sum([[1, 2, 3]])
+    notice sum([[1, 2, 3], 10])
+    notice check(Integer, $round)
+    notice check('Integer', $round)
+    reverse_each([1, 2]) |$value| { notice "block $value" }
+    notice reverse_each([1, 2]).map |$value| { $value }
+    notice step([1, 2, 3, 4], 2).map |$value| { $value }
+    step([1, 2, 3, 4], 2) |$value| { notice "step $value" }
+}
@@ -0,0 +1,82 @@
+# Each query on Indexed is answered from the catalog's resource index.
+# The same query on Scanned is combined with a query that never matches and cannot be indexed, so every resource is scanned.
+# Both types must collect the same resources.
+define indexed($value = undef, $list = []) {
+    notice "indexed $title"
+}
+
+define scanned($value = undef, $list = []) {
+    notice "scanned $title"
+}
+
+# Attributes modified after the type was indexed
+class late_base {
+    @indexed { late: value => before }
+    @scanned { late: value => before }
+}
+
+class late_child inherits late_base {
+    Indexed[late] { value => after }
+    Scanned[late] { value => after }
+}
+
+define late_trigger {
+    include late_child
+}
+
+late_trigger { trigger: }
+
+Indexed <| value == after |>
+Scanned <| value == after or missing != nope |>
+Indexed <| value == before |>
+Scanned <| value == before or missing != nope |>
+
+# Array values
+@indexed { array: list => [first, second] }
+@scanned { array: list => [first, second] }
+@indexed { not_array: list => [first] }
+@scanned { not_array: list => [first] }
+
+Indexed <| list == second |>
+Scanned <| list == second or missing != nope |>
+
+# Attributes with resource defaults
+class defaulted {
+    Indexed { value => defaulted }
+    Scanned { value => defaulted }
+
+    @indexed { defaulted: }
+    @scanned { defaulted: }
+    @indexed { explicit: value => explicit }
+    @scanned { explicit: value => explicit }
+}
+
+include defaulted
+
+Indexed <| value == defaulted |>
+Scanned <| value == defaulted or missing != nope |>
+
+# Resources added by later passes of the collectors
+define adder($depth) {
+    @indexed { "added $depth": value => multi }
+    @scanned { "added $depth": value => multi }
+    if $depth < 2 {
+        @adder { "next $depth": depth => $depth + 1 }
+    }
+}
+
+@adder { first: depth => 0 }
+
+# Each pass only considers resources added since the previous pass, so every value is appended once
+Adder <| depth == 0 or depth == 1 |>
+Indexed <| value == multi |> { list +> [appended] }
+Scanned <| value == multi or missing != nope |> { list +> [appended] }
+
+# Nested queries
+@indexed { nested: value => nested, list => [inner] }
+@scanned { nested: value => nested, list => [inner] }
+@indexed { nested_mismatch: value => nested }
+@scanned { nested_mismatch: value => nested }
+
+Indexed <| (value == nested and (list == inner or title == nope)) |>
+Scanned <| (value == nested and (list == inner or title == nope)) or missing != nope |>
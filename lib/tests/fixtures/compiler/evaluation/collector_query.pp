@@ -0,0 +1,57 @@
+define target($a = undef, $b = undef, $c = undef, $list = []) {
+    notice "collected $title"
+}
+
+# 'and' has higher precedence than 'or'
+@target { 'precedence and': a => p1, b => p2 }
+@target { 'precedence or': a => nope, b => nope, c => p3 }
+@target { 'precedence neither': a => p1, c => nope }
+Target <| a == p1 and b == p2 or c == p3 |>
+
+@target { 'precedence or left': c => p4 }
+@target { 'precedence and right': a => p5, b => p6 }
+@target { 'precedence half': a => p5 }
+Target <| c == p4 or a == p5 and b == p6 |>
+
+# Nested queries
+@target { 'nested first': a => n1, b => n3 }
+@target { 'nested second': a => n2, b => n3 }
+@target { 'nested mismatch': a => n2, b => nope }
+Target <| (a == n1 or a == n2) and b == n3 |>
+
+@target { 'nested deep': a => n4, b => n5, c => n6 }
+@target { 'nested deep mismatch': a => n4, b => n5, c => nope }
+Target <| a == n4 and (b == nope or (b == n5 and (c == n6))) |>
+
+# Array element containment
+@target { 'array string': list => [nope, element] }
+@target { 'array integer': list => [4, 5] }
+@target { 'array mismatch': list => [nope] }
+Target <| list == element or list == 5 |>
+
+# Inequality
+@target { 'not equal': a => other, b => ne }
+@target { 'not equal mismatch': a => ne, b => ne }
+@target { 'not equal missing': b => ne }
+@target { 'not equal array': list => [ne, nope], a => ne, b => ne }
+@target { 'not equal list': list => [nope], a => ne, b => ne }
+Target <| a != ne and b == ne |>
+Target <| list != ne and b == ne and a == ne |>
+
+# Titles
+@target { 'title one': }
+@target { 'title two': }
+@target { 'title three': a => title }
+@target { 'title four': a => title }
+Target <| title == 'title one' or title == 'title two' |>
+Target <| title != 'title three' and a == title |>
+
+# Variable operands
+$string = variable
+$number = 42
+$element = { key => [hash, value] }[key][1]
+@target { 'variable string': a => variable }
+@target { 'variable number': b => 42 }
+@target { 'variable hash': c => value }
+@target { 'variable mismatch': b => '42' }
+Target <| a == $string or b == $number or c == $element |>
@@ -0,0 +1 @@
+notice 1e308 / 0.1
@@ -0,0 +1,3 @@
+$min = -9223372036854775807 - 1
+$divisor = -1
+notice $min / $divisor
@@ -80,3 +80,9 @@ notice { foo => bar, bar => baz, baz => cake }.reverse_each.filter |$key, $value
     notice "key = $key, value = $value"
     $key =~ /^b/
 }
+
+# Filtered elements are stored as values rather than as references into the filtered argument
+$filtered = [[1], { a => 2 }, three].filter |$value| { true }
+notice $filtered == [[1], { a => 2 }, three], $filtered =~ Tuple[Array[Integer], Hash[String, Integer], String]
+notice "${filtered}"
+notice { a => [1] }.filter |$key, $value| { true } == { a => [1] }, [[1]].reduce |$memo, $value| { $memo } == [1]
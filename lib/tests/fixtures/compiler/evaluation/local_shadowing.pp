@@ -0,0 +1,29 @@
+$x = outer
+$y = outer
+
+function shadow($y) {
+    $x = "function $y"
+    [$a, $y2] = [$x, $y]
+    notice $x, $y, $a, $y2
+    $x
+}
+
+notice shadow(argument)
+notice $x, $y
+
+[1, 2].each |$y| {
+    $x = "lambda $y"
+    notice $x, $y
+    [3].each |$z| {
+        $x = "nested $z"
+        notice $x, $y, $z
+    }
+    notice $x
+}
+notice $x, $y
+
+$result = [1, 2].map |$value| {
+    $y = $value * 10
+    $y + $value
+}
+notice $result, $y
@@ -0,0 +1,19 @@
+notice false and $x or true
+notice true or $x and false
+notice false and true or false and true
+notice true and false or true
+notice false or false and true or true
+notice 1 == 2 and fail('not skipped') or 3 == 3
+notice false and true == true or 'yes' == 'yes'
+notice true or false and fail('not skipped') or fail('not skipped')
+notice false and (true or fail('not skipped'))
+notice true and (false or true) and (false or 'last')
+
+notice false and notice('not skipped')
+notice true or notice('not skipped')
+notice true and notice('evaluated') == evaluated or notice('not skipped')
+
+$a = false and ($b = true)
+$c = true or ($d = true) and fail('not skipped')
+$e = false or ($f = true)
+notice $a, defined('$b'), $c, defined('$d'), $e, $f
@@ -0,0 +1,18 @@
+# Blocks with side effects are evaluated one call at a time
+$result = [1, 2, 3].map |$x| {
+    notice "map $x"
+    $x * 2
+}.filter |$x| {
+    notice "filter $x"
+    $x > 2
+}.reduce |$memo, $x| {
+    notice "reduce $memo $x"
+    $memo + $x
+}
+notice $result
+
+# Pure blocks may be interleaved, but produce the same results
+notice [1, 2, 3, 4].map |$x| { $x * $x }.filter |$x| { $x % 2 == 0 }.map |$x| { $x + 1 }
+notice { a => 1, b => 2 }.filter |$k, $v| { $v > 1 }.map |$k, $v| { "$k=$v" }
+notice [1, 2, 3].map |$x| { $x * 2 }.reduce |$memo, $x| { $memo + $x }
+notice [1, 2, 3, 4].map |$x| { if $x == 3 { break } $x }.filter |$x| { $x > 1 }
@@ -0,0 +1 @@
+notice [1, 0, 2].map |$x| { 6 / $x }.filter |$x| { $x / ($x - 6) > 0 }
@@ -0,0 +1,6 @@
+[1, 2, 3].map |$x| {
+    notice "map $x"
+    $x
+}.filter |$x| {
+    fail "filter $x"
+}
@@ -0,0 +1,2 @@
+$tiny = 1030.reduce(1.0) |$memo, $value| { $memo / 2 }
+notice $tiny * 0.3
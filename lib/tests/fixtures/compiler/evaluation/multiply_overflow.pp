@@ -0,0 +1 @@
+notice 9223372036854775807 * 2
@@ -0,0 +1,23 @@
+# Operators dispatched through the kind tables for each combination of operand kinds
+notice 1 + 2, 1 + 2.5, 2.5 + 1, 1.5 + 2.5
+notice 5 - 2, 5 - 2.5, 5.5 - 2, 5.5 - 2.5
+notice 3 * 2, 3 * 0.5, 0.5 * 3, 0.5 * 0.5
+notice 7 / 2, 7 / 2.0, 7.0 / 2, 7.0 / 2.0, 7 % 3
+notice 1 << 4, 16 >> 2
+notice '1' + 2, 2 + '1.5', '2' * '3'
+notice [1] + [2], [1] + 2, { a => 1 } + { b => 2 }
+notice [1, 2, 3] - [2], [1, 2, 3] - 2, { a => 1, b => 2 } - [a], { a => 1, b => 2 } - { a => 3 }
+notice [1] << 2, [1] << [2]
+notice 1 < 2.5, 2.5 > 1, 1 <= 1.0, 2.0 >= 3
+notice 'a' < 'b', 'abc' >= 'abc', Integer < Numeric, Numeric > Integer
+notice 1 == 1.0, 1 == '1', [1, a] == [1, a], 1 != 2
+notice 1 in [1, 2], a in { a => 1 }, Integer in [a, 1], /b/ in [a, abc]
+notice 'abc' =~ /b/, 'abc' =~ 'b', 1 =~ Integer, 'abc' !~ /x/
+
+# Subnormal results that do not lose precision are not underflows
+$tiny = 1030.reduce(1.0) |$memo, $value| { $memo / 2 }
+notice $tiny > 0, $tiny * 1.0 == $tiny, 1 * $tiny == $tiny, $tiny / 1 == $tiny
+$triple = $tiny * 3
+$half = $tiny / 2
+notice $triple / 3 == $tiny, $half * 2 == $tiny
+notice $tiny * 0 == 0.0, 0 / $tiny == 0.0
@@ -0,0 +1,5 @@
+if $broken {
+    fail("node $greeting is broken")
+}
+
+notify { "hello $greeting": }
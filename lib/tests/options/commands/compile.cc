@@ -2,11 +2,15 @@
 #include <puppet/options/commands/compile.hpp>
 #include <puppet/options/commands/help.hpp>
 #include <puppet/options/parser.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
 #include <sstream>
+#include <set>
 
 using namespace std;
 using namespace puppet;
 using namespace puppet::options;
+namespace fs = boost::filesystem;
 
 extern char const* const COMPILE_COMMAND_HELP =
     "\n"
@@ -21,6 +25,9 @@ extern char const* const COMPILE_COMMAND_HELP =
     "                                        directory.\n"
     "  --color                               Force color output on platforms that \n"
     "                                        support colorized output.\n"
+    "  --cycle-limit arg (=10)               The maximum number of resource \n"
+    "                                        dependency cycles to report. Use 0 to \n"
+    "                                        report every cycle.\n"
     "  -d [ --debug ]                        Enable debug output.\n"
     "  -e [ --environment ] arg (=production)\n"
     "                                        The environment to use.\n"
@@ -28,10 +35,15 @@ extern char const* const COMPILE_COMMAND_HELP =
     "                                        environments.\n"
     "  -f [ --facts ] arg                    The path to the YAML facts file to use.\n"
     "                                        Defaults to the current system's facts.\n"
+    "  --facts-dir arg                       The directory containing '<node>.yaml' \n"
+    "                                        facts files for batch compilation.\n"
     "  -g [ --graph-file ] arg               The path to write a DOT language file \n"
     "                                        for viewing the catalog dependency \n"
     "                                        graph.\n"
     "  --help                                Display command help.\n"
+    "  -j [ --jobs ] arg                     The number of nodes to compile \n"
+    "                                        concurrently in batch mode. Defaults to\n"
+    "                                        the number of hardware threads.\n"
     "  -l [ --log-level ] arg (=notice)      Set logging level.\n"
     "                                        Supported levels: debug, info, notice, \n"
     "                                        warning, error, alert, emergency, \n"
@@ -40,9 +52,13 @@ extern char const* const COMPILE_COMMAND_HELP =
     "                                        modules.\n"
     "  -n [ --node ] arg                     The node name to use. Defaults to the \n"
     "                                        'fqdn' fact.\n"
+    "  --nodes arg                           The path to a file listing node names, \n"
+    "                                        one per line, to compile in batch.\n"
     "  --no-color                            Disable color output.\n"
     "  -o [ --output ] arg (=catalog.json)   The output path for the compiled \n"
     "                                        catalog.\n"
+    "  --output-dir arg                      The directory to write '<node>.json' \n"
+    "                                        catalogs to in batch mode.\n"
     "  --trace                               Display Puppet backtraces for \n"
     "                                        evaluation errors.\n"
     "  --verbose                             Enable verbose output (info level).\n"
@@ -54,6 +70,12 @@ extern char const* const COMPILE_COMMAND_HELP =
     "'production' environment.\n"
     "\n"
     "Manifests will be evaluated in the order they are presented on the command line.\n"
+    "\n"
+    "The --nodes option compiles a batch of nodes using a single environment. Facts\n"
+    "for each node are read from '<node>.yaml' in the directory given by the\n"
+    "--facts-dir option. Catalogs are written to '<node>.json' in the directory given\n"
+    "by the --output-dir option or, if not specified, to the output file as\n"
+    "newline-delimited JSON.\n"
     ;
 
 SCENARIO("using the compile command", "[options]")
@@ -102,4 +124,103 @@ SCENARIO("using the compile command", "[options]")
             REQUIRE_THROWS_AS(parser.parse({ "compile", "--environment-dir", "does_not_exist" }), option_exception);
         }
     }
+    WHEN("given batch options without a node list") {
+        THEN("it should throw an exception") {
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--facts-dir", "." }), option_exception);
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--output-dir", "." }), option_exception);
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--jobs", "2" }), option_exception);
+        }
+    }
+    WHEN("given a node list with single node options") {
+        THEN("it should throw an exception") {
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--nodes", "nodes.txt", "--node", "foo" }), option_exception);
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--nodes", "nodes.txt", "--facts", "foo.yaml" }), option_exception);
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--nodes", "nodes.txt", "--graph-file", "foo.dot" }), option_exception);
+        }
+    }
+    WHEN("given a node list that does not exist") {
+        THEN("it should throw an exception") {
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--nodes", "does_not_exist", "--facts-dir", "." }), option_exception);
+        }
+    }
+    WHEN("given a node list with a node name that is a path") {
+        THEN("it should throw an exception") {
+            auto nodes = fs::path{FIXTURES_DIR} / "options" / "compile" / "batch" / "unsafe_nodes.txt";
+            REQUIRE_THROWS_AS(parser.parse({ "compile", "--nodes", nodes.string(), "--facts-dir", "." }), option_exception);
+        }
+    }
+}
+
+SCENARIO("compiling a batch of nodes", "[options]")
+{
+    options::parser parser;
+    parser.add<commands::compile>();
+
+    auto fixtures_dir = fs::path{FIXTURES_DIR} / "options" / "compile" / "batch";
+    auto output_dir = fs::temp_directory_path() / fs::unique_path("puppetcpp-batch-%%%%-%%%%-%%%%");
+
+    vector<string> arguments = {
+        "compile",
+        "--environment-path", (fs::path{FIXTURES_DIR} / "compiler" / "environments").string(),
+        "--environment", "evaluation",
+        "--nodes", (fixtures_dir / "nodes.txt").string(),
+        "--facts-dir", (fixtures_dir / "facts").string(),
+        "--jobs", "4",
+        "--log-level", "critical",
+        (fixtures_dir / "site.pp").string()
+    };
+
+    WHEN("writing catalogs to an output directory") {
+        arguments.emplace_back("--output-dir");
+        arguments.emplace_back(output_dir.string());
+
+        THEN("it should write a catalog for each node that compiled and fail for the others") {
+            REQUIRE(parser.parse(arguments).execute() == EXIT_FAILURE);
+
+            for (auto const& name : { "foo", "bar" }) {
+                CAPTURE(name);
+                ifstream file{ (output_dir / (string{ name } + ".json")).string() };
+                REQUIRE(file);
+                ostringstream contents;
+                contents << file.rdbuf();
+                REQUIRE(contents.str().find("\"name\": \"" + string{ name } + "\"") != string::npos);
+                REQUIRE(contents.str().find("\"title\": \"hello " + string{ name } + "\"") != string::npos);
+            }
+            REQUIRE_FALSE(fs::exists(output_dir / "broken.json"));
+            REQUIRE_FALSE(fs::exists(output_dir / "missing.json"));
+        }
+    }
+    WHEN("writing catalogs to an output file") {
+        fs::create_directories(output_dir);
+        auto output_file = output_dir / "catalogs.json";
+        arguments.emplace_back("--output");
+        arguments.emplace_back(output_file.string());
+
+        THEN("it should write one record per node that compiled and fail for the others") {
+            REQUIRE(parser.parse(arguments).execute() == EXIT_FAILURE);
+
+            ifstream file{ output_file.string() };
+            REQUIRE(file);
+
+            set<string> names;
+            string line;
+            while (getline(file, line)) {
+                CAPTURE(line);
+                REQUIRE(line.front() == '{');
+                REQUIRE(line.back() == '}');
+                if (line.find("\"name\":\"foo\"") != string::npos) {
+                    REQUIRE(line.find("\"title\":\"hello foo\"") != string::npos);
+                    names.insert("foo");
+                } else if (line.find("\"name\":\"bar\"") != string::npos) {
+                    REQUIRE(line.find("\"title\":\"hello bar\"") != string::npos);
+                    names.insert("bar");
+                } else {
+                    FAIL("unexpected catalog record");
+                }
+            }
+            REQUIRE(names == (set<string>{ "foo", "bar" }));
+        }
+    }
+
+    fs::remove_all(output_dir);
 }
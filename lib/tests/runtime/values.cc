@@ -0,0 +1,162 @@
+#include <catch.hpp>
+#include <puppet/runtime/values/value.hpp>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::runtime;
+
+SCENARIO("copying an array", "[runtime]")
+{
+    values::array original;
+    original.emplace_back(static_cast<int64_t>(1));
+    original.emplace_back(static_cast<int64_t>(2));
+
+    values::array copy = original;
+
+    WHEN("the original is modified") {
+        original.emplace_back(static_cast<int64_t>(3));
+        original[0] = static_cast<int64_t>(10);
+        *original.begin()[1] = values::value{ "two" };
+
+        THEN("the copy should be unaffected") {
+            REQUIRE(copy.size() == 2);
+            REQUIRE(copy[0].get() == static_cast<int64_t>(1));
+            REQUIRE(copy[1].get() == static_cast<int64_t>(2));
+            REQUIRE(original.size() == 3);
+            REQUIRE(original[0].get() == static_cast<int64_t>(10));
+            REQUIRE(original[1].get() == string{ "two" });
+        }
+    }
+    WHEN("the copy is modified") {
+        copy.front() = static_cast<int64_t>(10);
+        copy.back() = values::value{ "two" };
+        copy.erase(copy.cbegin());
+
+        THEN("the original should be unaffected") {
+            REQUIRE(original.size() == 2);
+            REQUIRE(original[0].get() == static_cast<int64_t>(1));
+            REQUIRE(original[1].get() == static_cast<int64_t>(2));
+            REQUIRE(copy.size() == 1);
+            REQUIRE(copy[0].get() == string{ "two" });
+        }
+    }
+    WHEN("a nested array is modified") {
+        values::array outer;
+        outer.emplace_back(values::value{ original });
+        auto outer_copy = outer;
+        boost::get<values::array>(outer[0].get())[0] = static_cast<int64_t>(10);
+
+        THEN("the copies should be unaffected") {
+            REQUIRE(boost::get<values::array>(outer_copy[0].get())[0].get() == static_cast<int64_t>(1));
+            REQUIRE(original[0].get() == static_cast<int64_t>(1));
+            REQUIRE(boost::get<values::array>(outer[0].get())[0].get() == static_cast<int64_t>(10));
+        }
+    }
+    WHEN("the copy is only read") {
+        THEN("it should compare equal to the original") {
+            REQUIRE(copy == original);
+            REQUIRE(hash_value(copy) == hash_value(original));
+        }
+    }
+}
+
+SCENARIO("copying a hash", "[runtime]")
+{
+    values::hash original;
+    original.set("foo", static_cast<int64_t>(1));
+    original.set("bar", static_cast<int64_t>(2));
+
+    values::hash copy = original;
+
+    WHEN("the original is modified") {
+        original.set("baz", static_cast<int64_t>(3));
+        *original.get("foo") = static_cast<int64_t>(10);
+        original.begin()->value() = static_cast<int64_t>(100);
+        original.erase("bar");
+
+        THEN("the copy should be unaffected") {
+            REQUIRE(copy.size() == 2);
+            REQUIRE(copy.begin()->key() == string{ "foo" });
+            REQUIRE(*copy.get("foo") == static_cast<int64_t>(1));
+            REQUIRE(*copy.get("bar") == static_cast<int64_t>(2));
+            REQUIRE_FALSE(copy.get("baz"));
+            REQUIRE(original.size() == 2);
+            REQUIRE(*original.get("foo") == static_cast<int64_t>(100));
+            REQUIRE_FALSE(original.get("bar"));
+            REQUIRE(*original.get("baz") == static_cast<int64_t>(3));
+        }
+    }
+    WHEN("the copy is modified") {
+        copy.set("foo", values::value{ "changed" });
+        for (auto& element : copy) {
+            if (element.key() == string{ "bar" }) {
+                element.value() = values::value{ "also changed" };
+            }
+        }
+        copy.set("baz", static_cast<int64_t>(3));
+
+        THEN("the original should be unaffected") {
+            REQUIRE(original.size() == 2);
+            REQUIRE(*original.get("foo") == static_cast<int64_t>(1));
+            REQUIRE(*original.get("bar") == static_cast<int64_t>(2));
+            REQUIRE_FALSE(original.get("baz"));
+            REQUIRE(copy.size() == 3);
+            REQUIRE(*copy.get("foo") == string{ "changed" });
+            REQUIRE(*copy.get("bar") == string{ "also changed" });
+        }
+    }
+    WHEN("the copy is looked up for a missing key") {
+        REQUIRE_FALSE(copy.get("missing"));
+
+        THEN("the copy should remain equal to the original") {
+            REQUIRE(copy == original);
+        }
+    }
+    WHEN("the copy is modified after the original's index was cloned") {
+        copy.set("foo", values::value{ "changed" });
+        original.set("bar", values::value{ "changed" });
+
+        THEN("each hash should find its own elements by key") {
+            REQUIRE(*original.get("foo") == static_cast<int64_t>(1));
+            REQUIRE(*original.get("bar") == string{ "changed" });
+            REQUIRE(*copy.get("foo") == string{ "changed" });
+            REQUIRE(*copy.get("bar") == static_cast<int64_t>(2));
+        }
+    }
+}
+
+SCENARIO("parsing cached types", "[runtime]")
+{
+    WHEN("parsing a valid type expression more than once") {
+        auto first = values::type::parse_cached("Callable[Integer[0, 9], String, 1, 2]");
+        auto second = values::type::parse_cached("Callable[Integer[0, 9], String, 1, 2]");
+
+        THEN("each result should be the same as parsing without the cache") {
+            auto expected = values::type::parse("Callable[Integer[0, 9], String, 1, 2]");
+            REQUIRE(expected);
+            REQUIRE(first);
+            REQUIRE(second);
+            REQUIRE(*first == *expected);
+            REQUIRE(*second == *expected);
+            REQUIRE(boost::lexical_cast<string>(*first) == "Callable[Integer[0, 9], String, 1, 2]");
+        }
+    }
+    WHEN("parsing different type expressions") {
+        auto integer = values::type::parse_cached("Integer");
+        auto string_type = values::type::parse_cached("String");
+
+        THEN("each expression should have its own result") {
+            REQUIRE(integer);
+            REQUIRE(string_type);
+            REQUIRE(*integer != *string_type);
+            REQUIRE(*integer == values::type{ types::integer{} });
+        }
+    }
+    WHEN("parsing an invalid type expression more than once") {
+        THEN("no type should be returned") {
+            REQUIRE_FALSE(values::type::parse_cached("Integer["));
+            REQUIRE_FALSE(values::type::parse_cached("Integer["));
+            REQUIRE_FALSE(values::type::parse_cached("not a type"));
+        }
+    }
+}
@@ -525,6 +525,44 @@ SCENARIO("using a string", "[values]")
             REQUIRE("z" >= unicode::string{ "z" });
         }
     }
+    WHEN("checking raw data for invariance") {
+        THEN("empty and ASCII data should be invariant") {
+            REQUIRE(unicode::is_invariant("", 0));
+            std::string ascii = "the quick brown fox jumps over the lazy dog";
+            REQUIRE(unicode::is_invariant(ascii.data(), ascii.size()));
+        }
+        THEN("data with a non-ASCII code unit in any position should not be invariant") {
+            std::string unicode = u8"the quick brown fox jumps over the lazy dog ñ";
+            REQUIRE_FALSE(unicode::is_invariant(unicode.data(), unicode.size()));
+            unicode = u8"ñ the quick brown fox jumps over the lazy dog";
+            REQUIRE_FALSE(unicode::is_invariant(unicode.data(), unicode.size()));
+            unicode = u8"the quick brown ñ fox";
+            REQUIRE_FALSE(unicode::is_invariant(unicode.data(), unicode.size()));
+        }
+    }
+    WHEN("comparing two std::strings for equality") {
+        THEN("it should respect case by default") {
+            REQUIRE(unicode::equals("foobar", "foobar"));
+            REQUIRE_FALSE(unicode::equals("foobar", "FOOBAR"));
+            REQUIRE_FALSE(unicode::equals("foo", "foobar"));
+            REQUIRE_FALSE(unicode::equals(u8"çöğiü", u8"ÇÖĞIÜ"));
+        }
+        THEN("it should ignore case when requested") {
+            REQUIRE(unicode::equals("foobar", "FOOBAR", true));
+            REQUIRE_FALSE(unicode::equals("foobar", "FOOBAZ", true));
+            REQUIRE_FALSE(unicode::equals("foo", "FOOBAR", true));
+            REQUIRE(unicode::equals(u8"çöğiü", u8"ÇÖĞIÜ", true));
+        }
+        THEN("it should normalize the strings") {
+            REQUIRE(unicode::equals(u8"this contains a ñ: \u00f1o", u8"this contains a ñ: n\u0303o"));
+            REQUIRE(unicode::equals(u8"this contains a ñ: \u00f1o", u8"THIS CONTAINS A Ñ: N\u0303O", true));
+        }
+        THEN("it should agree with unicode::string equality") {
+            REQUIRE(unicode::equals("foo", "foo") == (unicode::string{ "foo" } == std::string{ "foo" }));
+            REQUIRE(unicode::equals("foo", "bar") == (unicode::string{ "foo" } == std::string{ "bar" }));
+            REQUIRE(unicode::equals("foo", "FOO", true) == (unicode::string{ "foo" }.compare("FOO", true) == 0));
+        }
+    }
     WHEN("writing a string") {
         char const* data = u8"foo それは私を傷つけません。bar";
         ostringstream buffer;
@@ -0,0 +1,92 @@
+#include <catch.hpp>
+#include <puppet/utility/output_buffer.hpp>
+#include <rapidjson/writer.h>
+#include <sstream>
+#include <cstdio>
+
+using namespace std;
+using namespace puppet::utility;
+
+SCENARIO("using an output buffer", "[utility]")
+{
+    GIVEN("a memory buffer") {
+        output_buffer buffer;
+        WHEN("writing characters and strings") {
+            buffer.put('a');
+            buffer.write("bcd", 3);
+            buffer.write(string{ "ef" });
+            buffer.flush();
+            THEN("the output should remain in memory") {
+                REQUIRE(buffer.contents() == "abcdef");
+            }
+            THEN("taking the output should empty the buffer") {
+                REQUIRE(buffer.take() == "abcdef");
+                REQUIRE(buffer.contents().empty());
+            }
+        }
+        WHEN("writing with a RapidJSON writer") {
+            rapidjson::Writer<output_buffer> writer{ buffer };
+            writer.StartObject();
+            writer.Key("foo");
+            writer.StartArray();
+            writer.Int64(1);
+            writer.String("bar");
+            writer.Bool(true);
+            writer.Null();
+            writer.EndArray();
+            writer.EndObject();
+            THEN("the output should be compact JSON") {
+                REQUIRE(buffer.contents() == R"({"foo":[1,"bar",true,null]})");
+            }
+        }
+    }
+    GIVEN("a stream buffer") {
+        ostringstream stream;
+        output_buffer buffer{ stream, 4 };
+        WHEN("writing less than the capacity") {
+            buffer.write("abc", 3);
+            THEN("the output should not be written to the stream until flushed") {
+                REQUIRE(stream.str().empty());
+                buffer.flush();
+                REQUIRE(stream.str() == "abc");
+                REQUIRE(buffer.contents().empty());
+            }
+        }
+        WHEN("writing more than the capacity") {
+            buffer.write("abc", 3);
+            buffer.put('d');
+            buffer.put('e');
+            THEN("the buffered output should be written to the stream") {
+                REQUIRE(stream.str() == "abcd");
+                REQUIRE(buffer.contents() == "e");
+            }
+        }
+        WHEN("writing a block larger than the capacity") {
+            buffer.put('a');
+            buffer.write("bcdefgh", 7);
+            THEN("the block should be written through to the stream") {
+                REQUIRE(stream.str() == "abcdefgh");
+                REQUIRE(buffer.contents().empty());
+            }
+        }
+    }
+    GIVEN("a file descriptor buffer") {
+        auto file = tmpfile();
+        REQUIRE(file);
+        {
+            output_buffer buffer{ fileno(file), 2 };
+            buffer.write("hello ", 6);
+            buffer.write(string{ "world" });
+            buffer.write("!", 1);
+        }
+        WHEN("the buffer is destroyed") {
+            THEN("all output should be written to the file descriptor") {
+                rewind(file);
+                char data[32] = {};
+                auto size = fread(data, 1, sizeof(data) - 1, file);
+                REQUIRE(string(data, size) == "hello world!");
+            }
+        }
+        fclose(file);
+    }
+}
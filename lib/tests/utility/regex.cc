@@ -0,0 +1,69 @@
+#include <catch.hpp>
+#include <puppet/utility/regex.hpp>
+#include <vector>
+
+using namespace std;
+using namespace puppet::utility;
+
+SCENARIO("compiling cached regular expressions", "[utility]")
+{
+    WHEN("the same expression is compiled more than once") {
+        regex first{ "^cached-[a-z]+$" };
+        regex second{ "^cached-[a-z]+$" };
+
+        THEN("the compiled expression should be shared") {
+            REQUIRE(&first.get() == &second.get());
+            REQUIRE(second.match("cached-foo"));
+            REQUIRE_FALSE(second.match("cached-1"));
+        }
+    }
+    WHEN("the same expression is compiled with different options") {
+        regex sensitive{ "^options$" };
+        regex insensitive{ "^options$", ONIG_OPTION_IGNORECASE };
+
+        THEN("each set of options should have its own compiled expression") {
+            REQUIRE(&sensitive.get() != &insensitive.get());
+            regex again{ "^options$", ONIG_OPTION_IGNORECASE };
+            REQUIRE(&insensitive.get() == &again.get());
+            REQUIRE_FALSE(sensitive.match("OPTIONS"));
+            REQUIRE(insensitive.match("OPTIONS"));
+        }
+    }
+    WHEN("an invalid expression is compiled") {
+        auto count = regex::cached();
+
+        THEN("it should not be cached") {
+            REQUIRE_THROWS_AS(regex{ "invalid(" }, regex_exception);
+            REQUIRE(regex::cached() == count);
+            REQUIRE_THROWS_AS(regex{ "invalid(" }, regex_exception);
+            REQUIRE(regex::cached() == count);
+        }
+    }
+    WHEN("more expressions are compiled than are cached") {
+        regex held{ "^held$" };
+        for (size_t i = 0; i < 4096; ++i) {
+            regex{ "^unheld-" + to_string(i) + "$" };
+        }
+
+        THEN("only the expressions that are no longer in use should be evicted") {
+            REQUIRE(regex::cached() < 4096);
+            REQUIRE(&regex{ "^held$" }.get() == &held.get());
+            REQUIRE(held.match("held"));
+        }
+    }
+    WHEN("more expressions are in use than are cached") {
+        // Fill the cache with expressions that are in use until compiling another one has to clear it
+        vector<regex> held;
+        for (size_t i = 0; i < 2 * 4096 && (held.empty() || regex::cached() > 1); ++i) {
+            held.emplace_back("^in-use-" + to_string(i) + "$");
+        }
+
+        THEN("the cache should start over without affecting the expressions in use") {
+            REQUIRE(regex::cached() == 1);
+            REQUIRE(held.size() > 1);
+            REQUIRE(&regex{ "^in-use-0$" }.get() != &held.front().get());
+            REQUIRE(held.front().match("in-use-0"));
+            REQUIRE(held.back().match("in-use-" + to_string(held.size() - 1)));
+        }
+    }
+}